@@ -1,22 +1,337 @@
+#ifdef __linux__
+    // For sched_setaffinity() and the CPU_SET macros
+    #define _GNU_SOURCE
+#endif
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
 #include <ctype.h>
 #include <limits.h>
 #include <stdint.h>
+#include <math.h>
 #include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #ifdef _WIN32
     #include <windows.h>
+#else
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/wait.h>
+    #include <sys/resource.h>
+    #include <signal.h>
+#endif
+#ifdef __linux__
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+#endif
+// The vector kernels are built with target attributes, so no -mavx2 flag is needed
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) && ULONG_MAX == 0xFFFFFFFFFFFFFFFFUL
+    #define SIMD_X86
+    #include <immintrin.h>
+#endif
+// The time stamp counter is read with compiler intrinsics
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #define TSC_TIMER
+    #include <x86intrin.h>
+    #include <cpuid.h>
+#endif
+#ifdef __GLIBC__
+    #include <malloc.h>
+#endif
+
+#define MAX_BATCH_SIZES 64
+#define MAX_BATCH_GENERATORS 16
+#define MAX_CONFIG_LINE 1024
+#define MAX_BATCH_THREADS 64
+#define MAX_BATCH_SELECTIONS 16
+#define TASK_ARGUMENT_SIZE 64
+#define DEFAULT_GRAIN_SIZE 16384
+#define KEY_BITS ((int)(sizeof(unsigned long int) * CHAR_BIT))
+#define LSD_RADIX_BITS 11
+#define MSD_RADIX_BITS 8
+#define MSD_INSERTION_THRESHOLD 32
+#define QUICK_SORT_INSERTION_THRESHOLD 24
+#define QUICK_SORT_NINTHER_THRESHOLD 128
+#define PARTITION_BLOCK_SIZE 64
+#define TIM_SORT_MIN_MERGE 32
+#define TIM_SORT_MIN_GALLOP 7
+#define TIM_SORT_MAX_RUNS 85
+#define CACHE_LINE_SIZE 64
+#define PERF_COUNTER_COUNT 6
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+#define BINARY_MAGIC "SORTKEYS"
+#define BINARY_HEADER_SIZE 16
+#define RUN_NAME_SIZE (FILENAME_MAX + 32)
+#define MIN_MERGE_BUFFER_KEYS 4096
+#define GENERATOR_BLOCK_SIZE 65536
+#define DEFAULT_SEED 42
+#define DEFAULT_UNIQUE_COUNT 16
+#define DEFAULT_COMPARE_THRESHOLD 5.0
+#define DEFAULT_PROFILE_FILE "tuning-profile.cfg"
+#define DEFAULT_TUNING_SIZE 1000000
+#define TUNING_MIN_REPETITIONS 5
+#define SELF_TEST_SIZE 50000
+#define SELF_TEST_GRAIN_SIZE 256
+#define SELF_TEST_UNIQUE_COUNT 3
+#define MAX_TUNING_CANDIDATES 12
+#define COMPARE_ALPHA 0.01
+#define COMPARE_MIN_SAMPLES 5
+#define SIMD_LEAF_SIZE 64
+#define PAGE_SIZE_BYTES 4096
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#define DEFAULT_LLC_SIZE (32 * 1024 * 1024)
+#define TIMER_CALIBRATION_ROUNDS 5
+#define TIMER_CALIBRATION_TIME 0.01
+#define SAMPLE_SORT_OVERSAMPLING 16
+#define SAMPLE_SORT_BUCKETS_PER_THREAD 8
+#define SAMPLE_SORT_MAX_BUCKETS 1024
+#define SAMPLE_SORT_WRITE_KEYS (CACHE_LINE_SIZE / (int)sizeof(unsigned long int))
+
+/**
+ * Hint that a key will be read soon. Compilers without the builtin ignore the hint.
+*/
+#if defined(__GNUC__) || defined(__clang__)
+    #define PREFETCH(address) __builtin_prefetch(address)
+#else
+    #define PREFETCH(address) ((void)0)
 #endif
 
-#define MAX_RANGE ULONG_MAX
+/**
+ * The formats the sorted arrays can be written in.
+ * OUTPUT_TEXT is the comma-separated format of appendArrayToFile(), OUTPUT_BINARY is a
+ * BINARY_HEADER_SIZE-byte header (BINARY_MAGIC and the element count as a little-endian u64)
+ * followed by every key as a little-endian u64.
+*/
+#define OUTPUT_NONE 0
+#define OUTPUT_TEXT 1
+#define OUTPUT_BINARY 2
+
+/**
+ * The element types the algorithms can be benchmarked on. ELEMENT_U64 is the native
+ * unsigned long int key every algorithm sorts. The other types convert the generated keys
+ * and are only sorted by the algorithms specialized for them in typedSorts, except the
+ * indirect record types: the records of the same size, which every algorithm sorts through
+ * indirectSort().
+*/
+#define ELEMENT_U32 0
+#define ELEMENT_U64 1
+#define ELEMENT_F64 2
+#define ELEMENT_RECORD16 3
+#define ELEMENT_RECORD64 4
+#define ELEMENT_RECORD256 5
+#define ELEMENT_STRING 6
+#define ELEMENT_RECORD16_INDIRECT 7
+#define ELEMENT_RECORD64_INDIRECT 8
+#define ELEMENT_RECORD256_INDIRECT 9
+#define ELEMENT_TYPE_COUNT 10
+
+/**
+ * How indirectSort() moves the records once the permutation is known: gathered into a
+ * buffer and copied back, or in place along the cycles of the permutation.
+*/
+#define PERMUTE_GATHER 0
+#define PERMUTE_CYCLES 1
+
+/**
+ * The outcome of an algorithm in the last benchmark. Only isolated runs can time out or fail.
+ * RUN_INVALID is a run whose output did not pass verifySorted().
+*/
+#define RUN_OK 0
+#define RUN_TIMEOUT 1
+#define RUN_FAILED 2
+#define RUN_INVALID 3
+
+/**
+ * The instruction sets the vector kernels can use, from narrowest to widest.
+ * SIMD_NONE selects the scalar fallbacks.
+*/
+#define SIMD_NONE 0
+#define SIMD_AVX2 1
+#define SIMD_AVX512 2
+
+/**
+ * Where the workers of the task pool are pinned. AFFINITY_COMPACT gives worker i processor i,
+ * AFFINITY_SPREAD spaces the workers evenly over every processor, AFFINITY_NONE leaves the
+ * placement to the scheduler.
+*/
+#define AFFINITY_NONE 0
+#define AFFINITY_COMPACT 1
+#define AFFINITY_SPREAD 2
+
+/**
+ * What readTimer() counts: the invariant time stamp counter of the processor, or the
+ * monotonic clock of the system (nanoseconds, or performance counter ticks on Windows).
+*/
+#define TIMER_CLOCK 0
+#define TIMER_TSC 1
+
+/**
+ * @struct BenchmarkStats
+ * @brief Summary statistics over the timed repetitions of one algorithm
+ * @var samples Number of timed repetitions the statistics were computed from
+ * @var min Fastest repetition
+ * @var median Median repetition
+ * @var mean Arithmetic mean of the repetitions
+ * @var stddev Sample standard deviation of the repetitions
+ * @var p95 95th percentile (nearest-rank) of the repetitions
+ */
+typedef struct {
+    int samples;
+    double min;
+    double median;
+    double mean;
+    double stddev;
+    double p95;
+} BenchmarkStats;
+
+/**
+ * @struct PerfReading
+ * @brief Hardware counter values per sort, averaged over the timed repetitions
+ * @var values The counter values, in the order of perfCounterNames, scaled up when the group was multiplexed
+ * @var isAvailable Non-zero for the counters that could be measured
+ * @var enabledTime Nanoseconds the counter group was enabled, summed over the repetitions
+ * @var runningTime Nanoseconds the counter group was actually on the PMU, summed over the repetitions
+ */
+typedef struct {
+    double values[PERF_COUNTER_COUNT];
+    int isAvailable[PERF_COUNTER_COUNT];
+    double enabledTime;
+    double runningTime;
+} PerfReading;
+
+/**
+ * @struct OperationCounts
+ * @brief Machine-independent cost of one sort, filled in by the instrumented build
+ */
+typedef struct {
+    unsigned long long comparisons;
+    unsigned long long swaps;
+    unsigned long long writes;
+} OperationCounts;
+
+/**
+ * @struct Record16
+ * @brief A 64-bit key followed by its payload, 16 bytes in total. Record64 and Record256 only differ in size.
+ */
+typedef struct {
+    uint64_t key;
+    unsigned char payload[8];
+} Record16;
+typedef struct {
+    uint64_t key;
+    unsigned char payload[56];
+} Record64;
+typedef struct {
+    uint64_t key;
+    unsigned char payload[248];
+} Record256;
+
+/**
+ * @struct ElementType
+ * @brief An element type the algorithms can be benchmarked on
+ * @var name Name of the type for display
+ * @var key Name of the type in batch mode and in the results
+ * @var size Bytes moved per element. The string type moves pointers to the keys.
+ * @var directType For the record types sorted through indirectSort(), the type of the same
+ * records sorted directly. -1 for the other types.
+ */
+typedef struct {
+    const char *name;
+    const char *key;
+    size_t size;
+    int directType;
+} ElementType;
+
+/**
+ * @struct TypedArray
+ * @brief The keys of a benchmark converted to an element type
+ * @var data The elements
+ * @var n The number of elements
+ * @var type The element type, an ELEMENT_ constant
+ * @var bytes Size of the data a sort goes through: the elements, plus the characters of string keys
+ * @var strings The characters of the string keys, NULL for the other types
+ * @var isDataOwned Non-zero when data was allocated by convertKeys()
+ * @var checksum Order-independent checksum of the elements, see checksumElements()
+ */
+typedef struct {
+    void *data;
+    int n;
+    int type;
+    size_t bytes;
+    char *strings;
+    int isDataOwned;
+    uint64_t checksum;
+} TypedArray;
+
+/**
+ * @struct TypedSort
+ * @brief A sort specialized for an element type other than ELEMENT_U64
+ * @var algorithmKey The key of the algorithm in algorithms it stands for
+ * @var type The element type, an ELEMENT_ constant
+ * @var function The specialized sort
+ */
+typedef struct {
+    const char *algorithmKey;
+    int type;
+    void (*function)(void *, int);
+} TypedSort;
+
+/**
+ * @struct MemoryUsage
+ * @brief Resources used by the child process that ran one algorithm in an isolated run
+ * @var isAvailable Non-zero when the algorithm ran in a child process
+ * @var peakRss Peak resident set size of the child in KB, including the pages it shares with the parent
+ * @var peakRssGrowth Growth of the peak resident set size since the child started, in KB
+ * @var minorFaults Page faults served without I/O
+ * @var majorFaults Page faults that needed I/O
+ */
+typedef struct {
+    int isAvailable;
+    long peakRss;
+    long peakRssGrowth;
+    long minorFaults;
+    long majorFaults;
+} MemoryUsage;
+
+/**
+ * @struct ScalingHistory
+ * @brief Timings of an algorithm on the current data, used to estimate the runs that time out
+ * @var sizes The two largest N that finished within the time budget, in increasing order
+ * @var times The median times at those N
+ * @var count The number of entries used in sizes
+ * @var timeoutSize The smallest N that ran out of time, 0 when none did
+ */
+typedef struct {
+    int sizes[2];
+    double times[2];
+    int count;
+    int timeoutSize;
+} ScalingHistory;
 
 /**
  * @struct SortingAlgorithm
  * @brief Represents the data of a sorting algorithm
  * @var name Name of the algorithm in title case
  * @var outputFile Name of the file where the sorted integers will be stored
- * @var time Time taken for the algorithms to sort
+ * @var time Time taken for the algorithms to sort (the median when repeated)
  * @var function Function pointer to its algorithm
+ * @var isParallel Non-zero when the algorithm runs on the task pool
+ * @var isSkipped Non-zero when the algorithm is excluded from the benchmark
+ * @var stats Statistics over the timed repetitions of the last benchmark
+ * @var counters Hardware counters of the last benchmark, when enabled
+ * @var operations Operation counts per sort of the last benchmark, in the instrumented build
+ * @var status RUN_OK, RUN_TIMEOUT, RUN_FAILED or RUN_INVALID for the last benchmark
+ * @var estimate Extrapolated time of a run that timed out, 0 when it cannot be estimated
+ * @var memory Resources of the child process of the last benchmark, in isolated runs
+ * @var history Completed timings on the current data, used to compute estimate
+ * @var throughput Bytes sorted per second at the median time of the last benchmark
+ * @var samples The timed repetitions of the last benchmark in run order, allocated by runBenchmark()
  * 
  * This object gives us OOP-like features, encapsulating related data and
  * improves maintainability. It also allows us to perform more complex logic
@@ -27,21 +342,441 @@ typedef struct {
     const char *outputFile;
     double time;
     void (*function)(unsigned long int*, int);
+    int isParallel;
+    int isSkipped;
+    BenchmarkStats stats;
+    PerfReading counters;
+    OperationCounts operations;
+    int status;
+    double estimate;
+    MemoryUsage memory;
+    ScalingHistory history;
+    double throughput;
+    double *samples;
 } SortingAlgorithm;
 
 /**
- * @brief Generates an array of random integers.
- * @param n The size of the resulting array.
- * @return The dynamically allocated array. It needs to be manually freed when used.
+ * @struct BenchmarkOptions
+ * @brief Controls how runBenchmark() measures each algorithm
+ * @var repetitions Number of timed runs per algorithm
+ * @var warmups Number of untimed runs per algorithm before the timed ones
+ * @var outputFormat How each sorted array is written: OUTPUT_NONE, OUTPUT_TEXT or OUTPUT_BINARY
+ * @var isBatch Non-zero when running unattended (no pauses, no results.csv row)
+ * @var threads Number of threads used by the parallel algorithms
+ * @var grainSize Subarrays at or below this size are sorted or merged without spawning tasks
+ * @var usePerfCounters Non-zero to read the hardware performance counters around each sort
+ * @var isIsolated Non-zero to run each algorithm in a child process (POSIX only)
+ * @var timeBudget Wall time in seconds an isolated algorithm may use per benchmark, 0 for no limit
+ * @var elementType The type the keys are converted to before sorting, an ELEMENT_ constant
+ * @var simdLevel Widest instruction set the vector kernels may use, a SIMD_ constant
+ * @var permuteMode How indirectSort() moves the records, PERMUTE_GATHER or PERMUTE_CYCLES
+ * @var affinity Where the task pool workers run, an AFFINITY_ constant
+ * @var pinProcessor The processor the benchmark thread runs on, -1 to leave it to the scheduler
+ * @var useHugePages Non-zero to put the copies the algorithms sort on 2MB pages (Linux)
+ * @var isPrefaulting Non-zero to fault in the copies before timing and keep freed memory mapped
+ * @var isColdCache Non-zero to evict the last-level cache before every timed repetition
+ */
+typedef struct {
+    int repetitions;
+    int warmups;
+    int outputFormat;
+    int isBatch;
+    int threads;
+    int grainSize;
+    int usePerfCounters;
+    int isIsolated;
+    double timeBudget;
+    int elementType;
+    int simdLevel;
+    int permuteMode;
+    int affinity;
+    int pinProcessor;
+    int useHugePages;
+    int isPrefaulting;
+    int isColdCache;
+} BenchmarkOptions;
+
+/**
+ * @struct RandomGenerator
+ * @brief State of a xoshiro256** generator, seeded with randomSeed()
+ */
+typedef struct {
+    uint64_t state[4];
+} RandomGenerator;
+
+/**
+ * @struct DataGenerator
+ * @brief A data generation method
+ * @var name Name of the method in title case
+ * @var key Name of the method in batch mode and in the results
+ * @var fill Fills array[begin..end) of an array of n keys. Blocks are filled independently, possibly in parallel.
+ * @var finish Optional sequential pass over the whole array once every block is filled, NULL when unused
+ * @var usesStartingValue Non-zero when the keys start from generatorOptions.startingValue
+ */
+typedef struct {
+    const char *name;
+    const char *key;
+    void (*fill)(unsigned long int*, int, int, int, RandomGenerator*);
+    void (*finish)(unsigned long int*, int, RandomGenerator*);
+    int usesStartingValue;
+} DataGenerator;
+
+/**
+ * @struct GeneratorOptions
+ * @brief Parameters of the data generation methods
+ * @var seed The seed every generated array is derived from
+ * @var startingValue The starting value (X) of the sequence-based methods
+ * @var swaps Number of random swaps of the nearly sorted method, -1 for 1% of N
+ * @var uniqueCount Number of distinct keys of the few unique method
+ * @var zipfExponent Exponent of the Zipf distribution
+ * @var runLength Length of each tooth of the sawtooth method, 0 for the square root of N
+ */
+typedef struct {
+    uint64_t seed;
+    unsigned long int startingValue;
+    int swaps;
+    int uniqueCount;
+    double zipfExponent;
+    int runLength;
+} GeneratorOptions;
+
+/**
+ * @struct BatchConfig
+ * @brief Describes the sweep performed by the non-interactive batch mode
+ * @var sizes The values of N to benchmark
+ * @var sizesCount Number of entries in sizes
+ * @var generators Indices into dataGenerators to benchmark
+ * @var generatorsCount Number of entries in generators
+ * @var threadCounts The thread counts the parallel algorithms are timed with
+ * @var threadCountsCount Number of entries in threadCounts
+ * @var resultsFile The CSV file the per-cell statistics are appended to
+ * @var inputFile A saved dataset benchmarked instead of the generators, empty when unused
+ * @var externalInput A binary dataset to sort on disk instead of benchmarking, empty when unused
+ * @var externalOutput The binary file the external sort writes
+ * @var externalAlgorithm Index in algorithms of the algorithm that sorts each chunk
+ * @var memoryLimit Memory for the chunks and merge buffers of the external sort, in MB
+ * @var fanIn Maximum number of runs merged at once by the external sort
+ * @var types The element types every cell is benchmarked on
+ * @var typesCount Number of entries in types
+ * @var jsonFile The JSON Lines file every result is appended to, with its run metadata and samples
+ * @var compareBase A JSON Lines file of baseline results to compare against, empty when unused
+ * @var compareCandidate The JSON Lines file compared with compareBase
+ * @var compareThreshold Slowdowns of at most this many percent are not reported as regressions
+ * @var profileFile The cutoff profile loaded at startup when it exists and written by --tune
+ * @var isTuning Non-zero to tune the cutoffs of the hybrid sorts instead of benchmarking
+ * @var isAnalyzing Non-zero to fit the scaling of every algorithm and find the crossovers after each sweep
+ * @var isSelfTesting Non-zero to check the parallel sorts on adversarial inputs instead of benchmarking
+ * @var selections The k of the selection sweep, fractions of N below 1 and counts otherwise
+ * @var selectionsCount Number of entries in selections, 0 to benchmark the sorts instead
+ */
+typedef struct {
+    int sizes[MAX_BATCH_SIZES];
+    int sizesCount;
+    int generators[MAX_BATCH_GENERATORS];
+    int generatorsCount;
+    int threadCounts[MAX_BATCH_THREADS];
+    int threadCountsCount;
+    char resultsFile[FILENAME_MAX];
+    char inputFile[FILENAME_MAX];
+    char externalInput[FILENAME_MAX];
+    char externalOutput[FILENAME_MAX];
+    int externalAlgorithm;
+    int memoryLimit;
+    int fanIn;
+    int types[ELEMENT_TYPE_COUNT];
+    int typesCount;
+    char jsonFile[FILENAME_MAX];
+    char compareBase[FILENAME_MAX];
+    char compareCandidate[FILENAME_MAX];
+    double compareThreshold;
+    char profileFile[FILENAME_MAX];
+    int isTuning;
+    int isAnalyzing;
+    int isSelfTesting;
+    double selections[MAX_BATCH_SELECTIONS];
+    int selectionsCount;
+} BatchConfig;
+
+/**
+ * @struct CutoffProfile
+ * @brief The small-subarray cutoffs of the hybrid sorts, tunable per machine
+ * @var quickSortCutoff Ranges of up to this many keys end the quick sorts with insertion sort
+ * @var radixCutoff Buckets of up to this many keys end American flag sort with insertion sort
+ * @var vectorLeafSize Keys per sorting network call of the vector sorts, at most SIMD_LEAF_SIZE
+ */
+typedef struct {
+    int quickSortCutoff;
+    int radixCutoff;
+    int vectorLeafSize;
+} CutoffProfile;
+
+/**
+ * @struct TunableCutoff
+ * @brief A cutoff runTuning() can choose, and the algorithm its candidates are timed with
+ * @var key Name of the cutoff in batch mode and in the profile file
+ * @var algorithmKey Key of the algorithm timed with each candidate
+ * @var value The cutoff
+ * @var minimum The smallest valid value
+ * @var maximum The largest valid value
+ * @var candidates The values tried, in increasing order
+ * @var candidatesCount Number of entries in candidates
+ * @var isParallel Non-zero when the cutoff only matters with more than one thread
+ */
+typedef struct {
+    const char *key;
+    const char *algorithmKey;
+    int *value;
+    int minimum;
+    int maximum;
+    int candidates[MAX_TUNING_CANDIDATES];
+    int candidatesCount;
+    int isParallel;
+} TunableCutoff;
+
+/**
+ * @struct ScalingFit
+ * @brief The least-squares fits of the times of one algorithm over a sweep, on log scales
+ * @var sizesCount Number of sizes the fits went through
+ * @var powerCoefficient c of c * N^k
+ * @var exponent k of c * N^k
+ * @var powerRSquared Coefficient of determination of c * N^k
+ * @var linearithmicCoefficient c of c * N * log2(N)
+ * @var linearithmicRSquared Coefficient of determination of c * N * log2(N)
+ */
+typedef struct {
+    int sizesCount;
+    double powerCoefficient;
+    double exponent;
+    double powerRSquared;
+    double linearithmicCoefficient;
+    double linearithmicRSquared;
+} ScalingFit;
+
+/**
+ * @struct SelectionEngine
+ * @brief A way to find the k smallest keys, benchmarked by runSelectionCell()
+ * @var name Name of the engine in title case
+ * @var key Name of the engine in the results
+ * @var function Moves the k smallest of the n keys to the front of the array
+ * @var isOrdered Non-zero when the k smallest keys come out sorted, zero when only the kth is in place
+ */
+typedef struct {
+    const char *name;
+    const char *key;
+    void (*function)(unsigned long int *, int, int);
+    int isOrdered;
+} SelectionEngine;
+
+/**
+ * @struct ResultRecord
+ * @brief One line of a JSON Lines results file, as read back by compareResults()
+ * @var algorithm Name of the algorithm
+ * @var generator The generator key or the saved dataset the keys came from
+ * @var elementType Key of the element type
+ * @var n The number of keys
+ * @var threads The thread count the algorithm ran with
+ * @var status "ok", "timeout", "failed" or "invalid"
+ * @var samples The timed repetitions
+ * @var samplesCount Number of entries in samples
+ */
+typedef struct {
+    char algorithm[64];
+    char generator[RUN_NAME_SIZE];
+    char elementType[16];
+    int n;
+    int threads;
+    char status[16];
+    double *samples;
+    int samplesCount;
+} ResultRecord;
+
+/**
+ * @struct RankedSample
+ * @brief A timing of either result set, ranked by mannWhitneyGreater()
+ */
+typedef struct {
+    double value;
+    int isCandidate;
+} RankedSample;
+
+/**
+ * @struct ExternalRun
+ * @brief A sorted run on disk being read by the k-way merge
+ * @var file The run file, positioned after the keys already buffered
+ * @var buffer The buffered keys
+ * @var capacity The size of the buffer in keys
+ * @var length The number of keys in the buffer
+ * @var position The index of the current key in the buffer
+ * @var remaining The number of keys left in the file
+ * @var isExhausted Non-zero once every key has been merged
+ */
+typedef struct {
+    FILE *file;
+    unsigned long int *buffer;
+    size_t capacity;
+    size_t length;
+    size_t position;
+    uint64_t remaining;
+    int isExhausted;
+} ExternalRun;
+
+/**
+ * @struct LoadedDataset
+ * @brief Keys read from a file written by appendArrayToFile() or writeArrayBinary()
+ * @var keys The keys. They point into the mapping when it could be used directly.
+ * @var n The number of keys
+ * @var fileSize The size of the file in bytes
+ * @var mapping The mapped (or read) file contents
+ * @var isKeysOwned Non-zero when keys was allocated separately from the mapping
+ */
+typedef struct {
+    unsigned long int *keys;
+    int n;
+    size_t fileSize;
+    void *mapping;
+    int isKeysOwned;
+} LoadedDataset;
+
+/**
+ * @struct TaskGroup
+ * @brief Counts the spawned tasks that have not finished yet, so they can be joined
+ */
+typedef struct {
+    atomic_int pending;
+} TaskGroup;
+
+/**
+ * @struct Task
+ * @brief A unit of work queued on the task pool
+ * @var function The function to run
+ * @var group The group notified when the task finishes
+ * @var argument A copy of the argument structure passed to the function
  */
-unsigned long int *generateRandomIntegers(int n);
+typedef struct {
+    void (*function)(void *);
+    TaskGroup *group;
+    unsigned char argument[TASK_ARGUMENT_SIZE];
+} Task;
+
+/**
+ * @struct TaskDeque
+ * @brief The task queue of one worker. The owner pushes and pops at the tail,
+ * other workers steal the oldest (and usually largest) tasks from the head.
+ */
+typedef struct {
+    Task *tasks;
+    int capacity;
+    int head;
+    int tail;
+    pthread_mutex_t lock;
+} TaskDeque;
+
+/**
+ * The processors a thread may run on, saved by saveThreadAffinity() before a thread is pinned
+*/
+#if defined(__linux__)
+    typedef cpu_set_t ThreadAffinity;
+#elif defined(_WIN32)
+    typedef DWORD_PTR ThreadAffinity;
+#else
+    typedef int ThreadAffinity;
+#endif
+
+/**
+ * @struct TaskPool
+ * @brief A work-stealing thread pool. The thread that waits on a group acts as worker 0.
+ * @var threadCount Number of workers, including the calling thread
+ * @var threads The threadCount - 1 background workers
+ * @var deques One task deque per worker
+ * @var queuedTasks Number of tasks sitting in the deques
+ * @var isStopping Set when the pool is being destroyed
+ * @var affinity The AFFINITY_ constant the workers were pinned with
+ * @var callerAffinity The processors of the creating thread before it was pinned as worker 0
+ * @var isCallerPinned Non-zero when callerAffinity is to be restored by taskPoolDestroy()
+ */
+typedef struct {
+    int threadCount;
+    pthread_t *threads;
+    TaskDeque *deques;
+    pthread_mutex_t sleepLock;
+    pthread_cond_t wakeCondition;
+    atomic_int queuedTasks;
+    atomic_int isStopping;
+    int affinity;
+    ThreadAffinity callerAffinity;
+    int isCallerPinned;
+} TaskPool;
+
+/**
+ * @brief Advances a splitmix64 state and returns its next output. Used to seed the other generators.
+ * @param state The state to advance
+ */
+uint64_t splitMix64(uint64_t *state);
+/**
+ * @brief Seeds a generator. Different streams of the same seed give independent sequences.
+ * @param rng The generator
+ * @param seed The seed, generatorOptions.seed for the generated arrays
+ * @param stream The stream, e.g. the index of the block being generated
+ */
+void randomSeed(RandomGenerator *rng, uint64_t seed, uint64_t stream);
+/**
+ * @brief Gives the next 64 random bits of a xoshiro256** generator
+ */
+uint64_t randomNext(RandomGenerator *rng);
+/**
+ * @brief Gives an unbiased random integer in [0, bound) using Lemire's multiply-and-reject method
+ */
+uint64_t randomBounded(RandomGenerator *rng, uint64_t bound);
+/**
+ * @brief Gives a uniform random double in [0, 1)
+ */
+double randomUniform(RandomGenerator *rng);
+
+/**
+ * @brief The fill functions of dataGenerators. Each one fills array[begin..end) of an array of n keys.
+ * @param array The array being generated
+ * @param begin The first index to fill
+ * @param end One past the last index to fill
+ * @param n The size of the whole array
+ * @param rng The generator of the block, seeded from its position so the result does not depend on the threads
+ */
+void fillRandom(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng);
+void fillIncreasing(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng);
+void fillReversed(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng);
+void fillFewUnique(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng);
+void fillOrganPipe(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng);
+void fillSawtooth(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng);
+void fillZipf(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng);
+void fillEqual(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng);
+/**
+ * @brief Swaps random pairs of an increasing array, generatorOptions.swaps times
+ * @param array The increasing array
+ * @param n The size of the array
+ * @param rng The generator used to pick the pairs
+ */
+void finishNearlySorted(unsigned long int *array, int n, RandomGenerator *rng);
+/**
+ * @brief Helpers of the Zipf rejection-inversion sampler (Hoermann and Derflinger).
+ * zipfHIntegral() is the integral of x^-s and zipfHIntegralInverse() its inverse.
+ */
+double zipfHelper1(double x);
+double zipfHelper2(double x);
+double zipfHIntegral(double x, double exponent);
+double zipfHIntegralInverse(double x, double exponent);
+/**
+ * @brief Fills one block of the array being generated, the task run by generateData()
+ * @param argument A GeneratorBlockArguments structure
+ */
+void generateBlockTask(void *argument);
 /**
- * @brief Generates an array of integers in increasing order
- * @param n The size of the resulting array
- * @param startingValue The value of the first element of the ordered array.
- * @return The dynamically allocated array. It needs to be manually freed when used.
+ * @brief Generates an array using one of the data generation methods.
+ * Large arrays are filled in blocks on the task pool. Every block derives its generator from
+ * generatorOptions.seed and its position, so a seed always gives the same array.
+ * @param method Index into dataGenerators.
+ * @param n The size of the resulting array.
+ * @return The dynamically allocated array, or NULL when it cannot be allocated or the method is unknown.
  */
-unsigned long int *generateIncreasingSequence(int n, unsigned long int startingValue);
+unsigned long int *generateData(int method, int n);
 
 /**
  * @brief The function that runs each algorithms and records the time
@@ -49,490 +784,8599 @@ unsigned long int *generateIncreasingSequence(int n, unsigned long int startingV
  * @param n The size of the unsorted array
  */
 void runBenchmark(unsigned long int *array, int n);
+/**
+ * @brief Runs the warm-ups and timed repetitions of one algorithm and writes its sorted output
+ * @param algorithm The algorithm, whose stats, counters, operations and throughput are filled in
+ * @param input The unsorted elements, left unchanged
+ * @param samples Room for benchmarkOptions.repetitions times
+ */
+void measureAlgorithm(SortingAlgorithm *algorithm, const TypedArray *input, double *samples);
+/**
+ * @brief Sorts elements of any type with an algorithm: native keys directly, indirect records
+ * through indirectSort(), and the other types with the specialization of the algorithm
+ * @param typedFunction The specialization for type, NULL for the native keys and indirect records
+ */
+void sortElements(const SortingAlgorithm *algorithm, void (*typedFunction)(void *, int), void *data, int n, int type);
+/**
+ * @brief Converts generated keys to an element type, outside of any timed region.
+ * u32 keeps the low 32 bits, f64 maps the keys in order onto negative and positive doubles,
+ * the records carry the key and a payload, and strings are the keys in decimal.
+ * @param keys The keys
+ * @param n The number of keys
+ * @param type The element type, an ELEMENT_ constant
+ * @param typed The converted array. ELEMENT_U64 shares keys instead of copying them.
+ */
+void convertKeys(unsigned long int *keys, int n, int type, TypedArray *typed);
+/**
+ * @brief Frees what convertKeys() allocated
+ */
+void freeTypedArray(TypedArray *typed);
+/**
+ * @brief Computes a checksum of the elements that does not depend on their order: the sum of
+ * a hash of every element, covering the record payloads and the characters of the strings.
+ * Equal checksums before and after a sort mean it only moved elements around.
+ * @param data The elements
+ * @param n The number of elements
+ * @param type The element type, an ELEMENT_ constant
+ */
+uint64_t checksumElements(const void *data, int n, int type);
+/**
+ * @brief Finds the first element greater than the one after it. Native keys are compared a
+ * vector register at a time when getSimdLevel() allows it.
+ * @return The index of that element, or -1 when the elements are in ascending order
+ */
+int findUnsortedIndex(const void *data, int n, int type);
+/**
+ * @brief Checks the output of a timed sort outside the timed region: the elements must be in
+ * ascending order and have the checksum of the input. A mismatch is reported on stderr.
+ * @param algorithm The algorithm that sorted
+ * @param input The unsorted elements
+ * @param sorted The elements the algorithm sorted
+ * @return Non-zero when the output is valid
+ */
+int verifySorted(const SortingAlgorithm *algorithm, const TypedArray *input, const void *sorted);
+/**
+ * @brief Finds the specialization of an algorithm for an element type
+ * @return The index in typedSorts, or -1 when there is none
+ */
+int findTypedSort(const SortingAlgorithm *algorithm, int type);
+/**
+ * @brief Tells whether an algorithm can sort an element type
+ */
+int isTypeSupported(const SortingAlgorithm *algorithm, int type);
+/**
+ * @brief Maps a double to an unsigned key with the same order, for the radix sorts
+ */
+uint64_t doubleRadixKey(double value);
+/**
+ * @brief Computes summary statistics of a set of timed samples
+ * @param samples The measured times. They are sorted in place.
+ * @param count The number of samples
+ * @return The statistics over the samples
+ */
+BenchmarkStats computeBenchmarkStats(double *samples, int count);
 
 /*
 *
-* SORTING ALGORITHMS
+* PROCESS ISOLATION
 *
 */
-void selectionSort(unsigned long int *array, int n);
-void bubbleSort(unsigned long int *array, int n);
-void insertionSort(unsigned long int *array, int n);
-void merge(unsigned long int *array, int left, int mid, int right);
-void mergeSortHelper(unsigned long int *array, int left, int right);
-void mergeSort(unsigned long int *array, int n);
-int medianOfThree(unsigned long int *array, int low, int high);
-int quickSortPartition(unsigned long int *array, int low, int high);
-void quickSortHelper(unsigned long int *array, int low, int high);
-void quickSort(unsigned long int *array, int n);
-void heapSort(unsigned long int *array, int n);
-
 /**
- * @brief Clears the contents of a file.
- * @param filename The name of the file to be cleared.
-*/
-void clearFile(const char *filename);
+ * @brief Runs measureAlgorithm() in a child process, killing it once benchmarkOptions.timeBudget is spent.
+ * The results come back through a pipe, the peak RSS and page faults from the child's resource usage.
+ * Runs in-process where fork() is unavailable.
+ * @param algorithm The algorithm, whose status, results and memory usage are filled in
+ * @param input The unsorted elements
+ * @param samples Room for benchmarkOptions.repetitions times
+ */
+void measureAlgorithmIsolated(SortingAlgorithm *algorithm, const TypedArray *input, double *samples);
 /**
- * @brief Appends a formatted string to a file.
- * @param filename The name of the file to append to.
- * @param format The format string (supports printf-style formatting).
- * @param ... Additional arguments for formatting.
+ * @brief Marks an algorithm as timed out at n and estimates the time it would have taken
  */
-void appendStringToFile(const char *filename, const char *format, ...);
+void markTimedOut(SortingAlgorithm *algorithm, int n);
 /**
- * @brief Appends an array of unsigned long integers to a file.
- * @param filename The name of the file to append to.
- * @param array The array of unsigned long integers.
- * @param n The number of elements in the array.
+ * @brief Adds a completed timing to the history of an algorithm, keeping the two largest N
  */
-void appendArrayToFile(const char *filename, unsigned long int *array, int n);
+void recordScaling(ScalingHistory *history, int n, double time);
 /**
- * @brief Creates a duplicate of an unsigned long int array.
- * @param array The original array to be duplicated.
- * @param n The number of elements in the array.
- * @return A pointer to the newly allocated duplicate array.
+ * @brief Extrapolates the time at n from a fit of c * N^k through the two largest sizes of a history
+ * @return The estimated time, or 0 when the history has fewer than two sizes
  */
-unsigned long int *duplicateArray(const unsigned long int *array, int n);
+double extrapolateTime(const ScalingHistory *history, int n);
 /**
- * @brief Creates a duplicate of an array of SortingAlgorithm structures.
- * @param array The original array of SortingAlgorithm structures.
- * @param n The number of elements in the array.
- * @return A pointer to the newly allocated duplicate array.
+ * @brief Forgets the timings of every algorithm, e.g. when the data generator changes
  */
-SortingAlgorithm *duplicateAlgorithmsArray(SortingAlgorithm *array, int n);
-unsigned long int getPositiveInteger(const char *prompt);
+void resetScalingHistory(void);
 /**
- * @brief Gives the current time in seconds.
- * @returns The calculated time.
+ * @brief Prints the peak RSS and page faults of the isolated runs of the last benchmark
+ */
+void displayMemoryUsage(void);
+
+/*
+*
+* BATCH MODE
+*
 */
-double getTimeInSeconds(void);
 /**
- * @brief The callback function used in qsort()
- * @param a Pointer to the first element.
- * @param b Pointer to the second element.
- * @return A negative value if a < b, 0 if equal, a positive value if a > b.
+ * @brief Runs the non-interactive benchmark driven by command-line options
+ * @param argc The argument count passed to main()
+ * @param argv The argument vector passed to main()
+ * @return The process exit status
  */
-int compareByTime(const void *a, const void *b);
+int runBatchFromArguments(int argc, char *argv[]);
 /**
- * @brief Clears the terminal screen.
+ * @brief Applies a single option (from the command line or a config file)
+ * @param config The batch configuration being built
+ * @param key The option name without the leading dashes
+ * @param value The option value, or NULL for flags
+ * @return 1 on success, 0 if the option or its value is invalid
  */
-void clearScreen(void);
+int applyBatchOption(BatchConfig *config, const char *key, const char *value);
 /**
- * @brief Displays the program header.
+ * @brief Reads key = value options from a config file. Lines starting with # are ignored.
+ * @param config The batch configuration being built
+ * @param filename The config file to read
+ * @return 1 on success, 0 on failure
  */
-void displayHeader(void);
+int loadBatchConfigFile(BatchConfig *config, const char *filename);
 /**
- * @brief Displays a confirmation message before exiting the program.
+ * @brief Runs every generator, N and algorithm cell of the sweep
+ * @param config The batch configuration
  */
-void displayConfirmExit(void);
+void runBatch(const BatchConfig *config);
 /**
- * @brief Pauses the program execution for a specified duration.
- * @param milliseconds The duration to sleep in milliseconds.
+ * @brief Benchmarks one array for every configured thread count, then prints and records the results
+ * @param config The batch configuration
+ * @param source The label of the data recorded in the results, e.g. the generator key
+ * @param seed The seed the data was generated from, empty for a saved dataset
+ * @param array The unsorted array
+ * @param n The size of the array
  */
-void sleepProgram(int milliseconds);
+void runBatchCell(const BatchConfig *config, const char *source, const char *seed, unsigned long int *array, int n);
+/**
+ * @brief After a benchmark of an indirect record type, times the algorithms that also sort the
+ * records directly on the same array, then prints the direct time over the indirect one and
+ * the bytes each moves. The direct runs are recorded under the direct type, with the ratio in
+ * the direct_over_indirect column. The results of the indirect benchmark are kept.
+ * @param config The batch configuration
+ * @param source The label of the data recorded in the results
+ * @param seed The seed the data was generated from, empty for a saved dataset
+ * @param array The unsorted keys
+ * @param n The size of the array
+ */
+void compareIndirectSort(const BatchConfig *config, const char *source, const char *seed, unsigned long int *array, int n);
+/**
+ * @brief The bytes one pass of a sort moves over n elements of type: the elements, or the packed
+ * words for the indirect record types
+ */
+double passBytes(int type, int n);
+/**
+ * @brief The bytes the indirect record types move to apply the permutation, once per sort: into
+ * the buffer and back with PERMUTE_GATHER, at most n records in place with PERMUTE_CYCLES. 0 for
+ * the other types.
+ */
+double permutedBytes(int type, int n);
+/**
+ * @brief Prints the command-line usage of the batch mode
+ * @param program The name of the executable
+ */
+void displayBatchUsage(const char *program);
+
+/*
+*
+* RESULTS STORE
+*
+*/
+/**
+ * @brief Gives the metadata shared by every result of this run as JSON members: the run id,
+ * host, operating system, processor, compiler, build and vector instruction set. It is built
+ * on the first call, once the options are known.
+ */
+const char *getRunMetadata(void);
+/**
+ * @brief Writes value as a quoted JSON string into buffer, truncated to fit
+ * @return The length written, without the terminating null character
+ */
+size_t escapeJsonString(const char *value, char *buffer, size_t size);
+/**
+ * @brief Appends the last benchmark of an algorithm as one JSON object line, with the run
+ * metadata, the data it sorted, its statistics, every timed repetition and whatever counters
+ * and memory usage were measured
+ * @param filename The JSON Lines file
+ * @param source The label of the data, e.g. the generator key
+ * @param seed The seed the data was generated from, empty for a saved dataset
+ * @param n The number of keys
+ * @param algorithm The algorithm
+ * @param threads The thread count it ran with
+ */
+void appendJsonResult(const char *filename, const char *source, const char *seed, int n, const SortingAlgorithm *algorithm, int threads);
+/**
+ * @brief Finds a member of the JSON object on a line. Only the members of the object itself
+ * are matched, not those of nested objects nor text inside strings, and whitespace is allowed
+ * anywhere JSON allows it.
+ * @return A pointer to the first character of its value, or NULL when the object has no such
+ * member or is malformed before it
+ */
+const char *findJsonValue(const char *line, const char *key);
+/**
+ * @brief Skips the spaces, tabs and line breaks at the start of text
+ */
+const char *skipJsonWhitespace(const char *text);
+/**
+ * @brief Skips one JSON value: a string, an object, an array, a number or a literal
+ * @return A pointer past its last character, or NULL when it is malformed or truncated
+ */
+const char *skipJsonValue(const char *value);
+/**
+ * @brief Reads the JSON string a value points to into buffer, truncated to fit.
+ * Anything other than a string gives an empty buffer.
+ */
+void readJsonString(const char *value, char *buffer, size_t size);
+/**
+ * @brief Reads the results of a JSON Lines file. When a cell (algorithm, N, generator, element
+ * type and thread count) appears more than once, its newest line is kept. Lines missing a
+ * member of a cell, its status or the samples of a successful run are skipped, and how many
+ * were skipped for which member is printed on stderr.
+ * @param filename The JSON Lines file
+ * @param records Set to the records, to be released with freeResultRecords()
+ * @param count Set to the number of records
+ * @return 1 on success, 0 if the file cannot be read
+ */
+int loadResultRecords(const char *filename, ResultRecord **records, int *count);
+/**
+ * @brief Frees the records read by loadResultRecords()
+ */
+void freeResultRecords(ResultRecord *records, int count);
+/**
+ * @brief Checks whether two records are the same cell: algorithm, N, generator, element type and thread count
+ */
+int isSameResultCell(const ResultRecord *first, const ResultRecord *second);
+/**
+ * @brief One-sided Mann-Whitney U test with the normal approximation, corrected for ties
+ * @return The p-value of the hypothesis that the candidate timings tend to be larger
+ */
+double mannWhitneyGreater(const double *base, int baseCount, const double *candidate, int candidateCount);
+/**
+ * @brief The callback function used in qsort() to rank the samples of mannWhitneyGreater()
+ */
+int compareRankedSamples(const void *a, const void *b);
+/**
+ * @brief Compares every cell present in both result sets of the configuration and flags the
+ * significant slowdowns, and the cells whose runs stopped succeeding
+ * @param config The batch configuration, with compareBase and compareCandidate set
+ * @return EXIT_FAILURE when any cell regressed, when a cell is in only one of the files or
+ * when no cell was compared, EXIT_SUCCESS otherwise
+ */
+int compareResults(const BatchConfig *config);
+
+/*
+*
+* ANALYSIS AND TUNING
+*
+*/
+/**
+ * @brief Stores the median time of every algorithm that completed the last benchmark,
+ * 0 for the others, as the sweep times at one size
+ * @param sweepTimes algorithmsSize rows of MAX_BATCH_SIZES times
+ * @param sizeIndex The column of the size
+ */
+void recordSweepTimes(double *sweepTimes, int sizeIndex);
+/**
+ * @brief Fits c * N^k and c * N * log2(N) to the times of one algorithm
+ * @param sizes The values of N
+ * @param times The time at each size, 0 where there is none
+ * @param count Number of entries in sizes
+ * @param fit The fits, with sizesCount below 2 when there are too few times
+ */
+void fitScaling(const int *sizes, const double *times, int count, ScalingFit *fit);
+/**
+ * @brief Prints the scaling fits of every algorithm of a sweep and the values of N where one
+ * algorithm overtakes another, interpolated between the sizes on log scales
+ * @param label The data the sweep ran on, e.g. the generator and element type
+ * @param sizes The values of N
+ * @param sizesCount Number of entries in sizes
+ * @param sweepTimes algorithmsSize rows of MAX_BATCH_SIZES times, 0 where there is none
+ */
+void analyzeSweep(const char *label, const int *sizes, int sizesCount, const double *sweepTimes);
+/**
+ * @brief Loads the cutoffs saved by runTuning(), when the file exists
+ * @param config The batch configuration the options of the file are applied to
+ * @param filename The profile file
+ */
+void loadCutoffProfile(BatchConfig *config, const char *filename);
+/**
+ * @brief Times every candidate of every tunable cutoff on random keys, keeps the fastest
+ * one and saves the chosen cutoffs to config->profileFile as batch options
+ * @param config The batch configuration. The largest of its sizes is tuned for.
+ * @return The process exit status
+ */
+int runTuning(const BatchConfig *config);
+/**
+ * @brief Gives the median time of an algorithm over TUNING_MIN_REPETITIONS or more quiet runs
+ * @return The median, or -1 when the output is not sorted
+ */
+double timeTuningRun(const SortingAlgorithm *algorithm, const unsigned long int *keys, int n);
+/**
+ * @brief Sorts the inputs that stress the parallel algorithms (few distinct keys, equal keys,
+ * runs) with many workers and small grains, and checks every output against a serial sort
+ * @param config The batch configuration. The largest of its sizes is used when given.
+ * @return EXIT_SUCCESS when every output is sorted, EXIT_FAILURE otherwise
+ */
+int runSelfTest(const BatchConfig *config);
+/**
+ * @brief Builds an input the sample sort splits badly: the keys at the positions its sample is
+ * drawn from are the smallest, so nearly every other key lands in the last bucket. Those keys
+ * repeat, so the bucket goes through the quick sort fallback with many equal keys.
+ * @return The keys, to be freed by the caller
+ */
+unsigned long int *generateSampleSortKiller(int n);
+/**
+ * @brief Builds an input the parallel quick sort partitions as badly as possible at the current
+ * grain: every median of three is the second smallest key of its range. Replaying the partitions
+ * takes O(N^2) time, so it is meant for the sizes of the self-test.
+ * @return The keys, to be freed by the caller, or NULL when N * (N + 1) does not fit in a key
+ */
+unsigned long int *generateQuickSortKiller(int n);
+
+/*
+*
+* SELECTION
+*
+*/
+/**
+ * @brief Moves the k smallest keys to array[0..k-1], with the kth smallest at array[k-1], no
+ * larger key before it and no smaller key after it, like std::nth_element
+ * @param array The keys
+ * @param n The number of keys
+ * @param k The number of keys wanted, 1 to n
+ */
+void introSelect(unsigned long int *array, int n, int k);
+/**
+ * @brief Quickselect on hoarePartition() that narrows array[low..high] to the side holding
+ * index target, and finishes with heapSelect() once depthLimit partitions were not enough
+ */
+void introSelectHelper(unsigned long int *array, int low, int high, int target, int depthLimit);
+/**
+ * @brief Builds a max heap of array[0..k-1] with heapify() and swaps every smaller key of the
+ * rest of the array into its root, leaving the k smallest keys in the heap
+ */
+void heapSelect(unsigned long int *array, int n, int k);
+/**
+ * @brief Bounded-heap top-k: heapSelect() then the extraction loop of heap sort on the heap only,
+ * leaving the k smallest keys sorted in array[0..k-1] in O(N log k), like std::partial_sort
+ */
+void heapTopK(unsigned long int *array, int n, int k);
+/**
+ * @brief Quick sort that skips the partitions lying entirely after index k-1, leaving the k
+ * smallest keys sorted in array[0..k-1]
+ */
+void partialQuickSort(unsigned long int *array, int n, int k);
+void partialQuickSortHelper(unsigned long int *array, int low, int high, int k, int depthLimit);
+/**
+ * @brief introSelect() followed by block quick sort on the keys before the kth
+ */
+void selectAndSort(unsigned long int *array, int n, int k);
+/**
+ * @brief The baseline of the selection sweep: block quick sort on all n keys
+ */
+void fullSortSelect(unsigned long int *array, int n, int k);
+/**
+ * @brief Gives the k of a --select entry for n keys, between 1 and n
+ * @param selection A fraction of n below 1, a count otherwise
+ */
+int selectionSize(double selection, int n);
+/**
+ * @brief Checks the output of a selection engine: it must hold the same keys as the input and its
+ * first k must be the k smallest, in order when the engine sorts them
+ * @param sorted The input keys, sorted
+ * @param checksum checksumElements() of the input keys
+ * @return Non-zero when the output is valid
+ */
+int verifySelection(const SelectionEngine *engine, const unsigned long int *output, const unsigned long int *sorted,
+    int n, int k, uint64_t checksum);
+/**
+ * @brief Runs the warm-ups and timed repetitions of one selection engine
+ * @param result Filled with the statistics, status and throughput. Its samples receive the
+ * repetitions in run order.
+ */
+void measureSelection(const SelectionEngine *engine, const unsigned long int *keys, const unsigned long int *sorted,
+    int n, int k, uint64_t checksum, SortingAlgorithm *result);
+/**
+ * @brief Times every selection engine for every k of config->selections on the keys of a cell,
+ * prints the cheapest engine for each k and appends the results to the results files
+ */
+void runSelectionCell(const BatchConfig *config, const char *source, const char *seed, const unsigned long int *keys, int n);
+
+/*
+*
+* MEASUREMENT
+*
+*/
+/**
+ * @brief Sets up the measurement once per process: calibrates the timer, pins the benchmark
+ * thread to benchmarkOptions.pinProcessor and, with benchmarkOptions.isPrefaulting, keeps the
+ * memory the sorts free mapped (glibc)
+ */
+void prepareMeasurement(void);
+/**
+ * @brief Gives the ticks per second of readTimer(). The first call chooses the counter: the time
+ * stamp counter, calibrated against the monotonic clock, when it is invariant, the clock otherwise.
+ */
+double getTimerFrequency(void);
+/**
+ * @brief Reads the counter chosen by getTimerFrequency(), which must have been called first
+ */
+uint64_t readTimer(void);
+/**
+ * @brief Allocates the copy an algorithm sorts, on 2MB pages with benchmarkOptions.useHugePages,
+ * and touches every page when prefaulting or using huge pages
+ * @return The buffer, to be released with freeSampleBuffer()
+ */
+void *allocateSampleBuffer(size_t size);
+/**
+ * @brief Releases a buffer of allocateSampleBuffer() of the same size
+ */
+void freeSampleBuffer(void *buffer, size_t size);
+/**
+ * @brief Gives the size of the last-level cache, or DEFAULT_LLC_SIZE when it is unknown
+ */
+size_t getLastLevelCacheSize(void);
+/**
+ * @brief Evicts the caches by writing to every line of a buffer twice the size of the last-level cache
+ */
+void flushCaches(void);
+
+/*
+*
+* SORTING ALGORITHMS
+*
+*/
+void selectionSort(unsigned long int *array, int n);
+void bubbleSort(unsigned long int *array, int n);
+void insertionSort(unsigned long int *array, int n);
+void merge(unsigned long int *array, int left, int mid, int right);
+void mergeSortHelper(unsigned long int *array, int left, int right);
+void mergeSort(unsigned long int *array, int n);
+/**
+ * @brief Merges the sorted runs source[left..mid] and source[mid+1..right] into target[left..right]
+ * @param source The array holding the two sorted runs
+ * @param target The array receiving the merged run. It must not overlap source.
+ */
+void mergeInto(const unsigned long int *source, unsigned long int *target, int left, int mid, int right);
+/**
+ * @brief Sorts source[left..right] into target[left..right], using source as the scratch space.
+ * Both arrays must hold the same elements in that range when called.
+ */
+void mergeSortPingPongHelper(unsigned long int *source, unsigned long int *target, int left, int right);
+/**
+ * @brief Top-down merge sort that alternates between the array and a caller-provided buffer
+ * @param array The array to be sorted
+ * @param n The size of the array
+ * @param buffer Scratch space of at least n elements
+ */
+void mergeSortWithBuffer(unsigned long int *array, int n, unsigned long int *buffer);
+/**
+ * @brief Top-down merge sort that allocates a single scratch buffer per sort
+ */
+void bufferedMergeSort(unsigned long int *array, int n);
+/**
+ * @brief Iterative merge sort that merges runs of width 1, 2, 4, ... between the array and a buffer
+ */
+void bottomUpMergeSort(unsigned long int *array, int n);
+unsigned long int medianOfThree(unsigned long int *array, int low, int high);
+int quickSortPartition(unsigned long int *array, int low, int high);
+void quickSortHelper(unsigned long int *array, int low, int high);
+/**
+ * @brief Gives the index of the median of array[a], array[b] and array[c] without moving them
+ */
+int medianIndex(const unsigned long int *array, int a, int b, int c);
+/**
+ * @brief Hoare partition of array[low..high] around array[pivotIndex]. Keys equal to the pivot
+ * may end up on either side, which keeps the sides balanced when there are many duplicates.
+ * @return The final index of the pivot
+ */
+int hoarePartition(unsigned long int *array, int low, int high, int pivotIndex);
+/**
+ * @brief Moves the keys equal to the pivot to the front of array[low..high], given that no key is smaller
+ * @return The last index of the keys equal to the pivot
+ */
+int equalKeysPartition(unsigned long int *array, int low, int high, unsigned long int pivot);
+/**
+ * @brief Introspective quick sort of array[low..high]. When low > 0, array[low - 1] must not be
+ * greater than any key of the range, which holds for every range a partition step produces.
+ * @param depthLimit Partitioning levels left before falling back to heap sort
+ * @param partition The partition scheme, either hoarePartition() or blockPartition()
+ * @param leafSize Ranges of up to leafSize keys are not partitioned further
+ * @param leafSort The sort that finishes those ranges
+ */
+void introSortHelper(unsigned long int *array, int low, int high, int depthLimit, int (*partition)(unsigned long int *, int, int, int),
+    int leafSize, void (*leafSort)(unsigned long int *, int));
+/**
+ * @brief Hybrid quick sort: insertion sort for small ranges, ninther pivots, equal-key
+ * partitioning, heap sort past 2*log2(N) levels and recursion on the smaller side only.
+ */
+void quickSort(unsigned long int *array, int n);
+/**
+ * @brief The textbook Lomuto quick sort with a median-of-three pivot
+ */
+void lomutoQuickSort(unsigned long int *array, int n);
+/**
+ * @brief Branchless block partition (BlockQuicksort) of array[low..high] around array[pivotIndex].
+ * Keys less than the pivot end up on its left and the others on its right.
+ * @return The final index of the pivot
+ */
+int blockPartition(unsigned long int *array, int low, int high, int pivotIndex);
+/**
+ * @brief The hybrid quick sort of quickSort() driven by the block partition
+ */
+void blockQuickSort(unsigned long int *array, int n);
+void heapify(unsigned long int *array, int n, int root);
+void heapSort(unsigned long int *array, int n);
+/**
+ * @brief Restores the max heap property below root with Floyd's bottom-up sift-down: the hole
+ * at root is moved down to a leaf along the largest children, one comparison per child, then
+ * the displaced key climbs back up to its place, which is usually close to the leaf.
+ * @param heap The heap, the children of node i being heap[arity*i+1..arity*i+arity]
+ * @param n The number of keys in the heap
+ * @param root The node whose key may be out of place
+ * @param arity The number of children of each node
+ */
+void bottomUpSiftDown(unsigned long int *heap, int n, int root, int arity);
+/**
+ * @brief Heap sort of a heap laid out as in bottomUpSiftDown()
+ */
+void bottomUpHeapSortEngine(unsigned long int *heap, int n, int arity);
+/**
+ * @brief Binary heap sort with the bottom-up sift-down, in place
+ */
+void bottomUpHeapSort(unsigned long int *array, int n);
+/**
+ * @brief Heap sort with an arity-ary heap copied into a cache line aligned buffer.
+ * The heap starts arity - 1 slots into the buffer so the children of every node fill one
+ * aligned group of arity keys, a whole cache line for the 8-ary heap.
+ */
+void alignedHeapSort(unsigned long int *array, int n, int arity);
+/**
+ * @brief Heap sort with a 4-ary heap whose children share half a cache line
+ */
+void quaternaryHeapSort(unsigned long int *array, int n);
+/**
+ * @brief Heap sort with an 8-ary heap whose children share a cache line
+ */
+void octonaryHeapSort(unsigned long int *array, int n);
+/**
+ * @brief Merges source[leftStart..leftEnd] and source[rightStart..rightEnd] into target starting at outStart
+ */
+void mergeRanges(const unsigned long int *source, int leftStart, int leftEnd, int rightStart, int rightEnd, unsigned long int *target, int outStart);
+/**
+ * @brief Merges two sorted ranges by splitting them around the median of the larger one and merging the halves as parallel tasks
+ */
+void parallelMerge(TaskPool *pool, const unsigned long int *source, int leftStart, int leftEnd, int rightStart, int rightEnd, unsigned long int *target, int outStart);
+/**
+ * @brief Quick sort whose partitions larger than the grain size are sorted as tasks on the task pool.
+ * Partitions at or below the grain size are finished with the introspective quick sort.
+ */
+void parallelQuickSort(unsigned long int *array, int n);
+/**
+ * @brief Ping-pong merge sort whose halves and merges larger than the grain size run as tasks on the task pool
+ */
+void parallelMergeSort(unsigned long int *array, int n);
+/**
+ * @brief Sample sort on the task pool. Splitters taken from an oversampled random sample
+ * define the buckets, every thread counts and then scatters its block of keys into them through
+ * cache-line write buffers, and the buckets are sorted independently. Keys equal to a splitter
+ * get buckets of their own that need no sorting.
+ */
+void parallelSampleSort(unsigned long int *array, int n);
+/**
+ * @brief LSD radix sort on the task pool. For every digit, each thread builds the histogram of
+ * its block of keys, the histograms are prefix-summed digit-major, and each thread scatters its
+ * block to the offsets that gives it. Digits shared by every key are skipped.
+ */
+void parallelRadixSort(unsigned long int *array, int n);
+/**
+ * @brief Least significant digit radix sort with LSD_RADIX_BITS-bit digits.
+ * The histograms of every digit are built in one pass, and digits that are the same
+ * for every key are skipped.
+ */
+void lsdRadixSort(unsigned long int *array, int n);
+/**
+ * @brief Sorts array[low..high] in place by the digit at shift and the less significant ones
+ * @param array The array to be sorted
+ * @param low The first index of the range
+ * @param high The last index of the range
+ * @param shift The bit position of the current MSD_RADIX_BITS-bit digit
+ */
+void americanFlagSortHelper(unsigned long int *array, int low, int high, int shift);
+/**
+ * @brief In-place most significant digit radix sort (American flag sort)
+ */
+void americanFlagSort(unsigned long int *array, int n);
+/**
+ * @brief Sorts array[low..high) by binary insertion, given that array[low..start) is already sorted
+ */
+void binaryInsertionSort(unsigned long int *array, int low, int high, int start);
+/**
+ * @brief Finds the run starting at low and reverses it when it is strictly descending
+ * @return The length of the run, which ends before high
+ */
+int countRunAndMakeAscending(unsigned long int *array, int low, int high);
+/**
+ * @brief Gives the minimum run length of TimSort for n keys: between TIM_SORT_MIN_MERGE / 2
+ * and TIM_SORT_MIN_MERGE, such that n / minRun is a power of two or slightly below one
+ */
+int timSortMinRun(int n);
+/**
+ * @brief Finds where key goes in a sorted run, before any equal key, by galloping from hint
+ * @return The number of keys of run less than key
+ */
+int gallopLeft(unsigned long int key, const unsigned long int *run, int length, int hint);
+/**
+ * @brief Finds where key goes in a sorted run, after any equal key, by galloping from hint
+ * @return The number of keys of run less than or equal to key
+ */
+int gallopRight(unsigned long int key, const unsigned long int *run, int length, int hint);
+/**
+ * @brief Stable adaptive merge sort (TimSort). Natural runs are found, short ones extended
+ * with binary insertion sort, and merged from a run stack whose invariants keep the merges
+ * balanced. Merges switch to galloping when one run keeps winning, so presorted and nearly
+ * sorted inputs take close to linear time.
+ */
+void timSort(unsigned long int *array, int n);
+/**
+ * @brief The C library's qsort() with a function-pointer comparator, the production baseline
+ * the other algorithms are measured against
+ */
+void libcQsort(unsigned long int *array, int n);
+/**
+ * @brief The qsort() comparator of libcQsort(), counted in operation-counting builds
+ */
+int compareKeys(const void *a, const void *b);
+#ifdef USE_STD_SORT
+/**
+ * @brief std::sort() of the C++ standard library, defined in stdSort.cpp
+ */
+void stdSort(unsigned long int *array, int n);
+/**
+ * @brief std::stable_sort() of the C++ standard library, defined in stdSort.cpp
+ */
+void stdStableSort(unsigned long int *array, int n);
+/**
+ * @brief std::sort() with the std::execution::par policy, defined in stdSort.cpp. It runs on the
+ * standard library's own threads, and serially when the library has no execution policies.
+ */
+void parallelStdSort(unsigned long int *array, int n);
+#endif
+/**
+ * @brief Sorts up to SIMD_LEAF_SIZE keys with a bitonic sorting network held in vector
+ * registers, padded with ULONG_MAX to a power of two. Falls back to insertion sort when
+ * getSimdLevel() is SIMD_NONE.
+ */
+void simdSortNetwork(unsigned long int *array, int n);
+/**
+ * @brief Merges source[leftStart..leftEnd] and source[rightStart..rightEnd] into target from
+ * outStart, like mergeRanges(), with a vectorized bitonic merge of one register from each run
+ * at a time. Falls back to mergeRanges() when getSimdLevel() is SIMD_NONE.
+ */
+void simdMerge(const unsigned long int *source, int leftStart, int leftEnd, int rightStart, int rightEnd, unsigned long int *target, int outStart);
+/**
+ * @brief Merges three sorted sequences into target. It finishes the vectorized merges, whose
+ * last register and run tails are too short for another vector step.
+ */
+void mergeTail(const unsigned long int *first, int firstLength, const unsigned long int *second, int secondLength,
+    const unsigned long int *third, int thirdLength, unsigned long int *target);
+/**
+ * @brief The block quick sort of blockQuickSort() with ranges of up to cutoffs.vectorLeafSize
+ * keys finished by simdSortNetwork() instead of insertion sort
+ */
+void vectorQuickSort(unsigned long int *array, int n);
+/**
+ * @brief Bottom-up merge sort whose cutoffs.vectorLeafSize-key blocks are sorted by
+ * simdSortNetwork() and merged by simdMerge()
+ */
+void vectorMergeSort(unsigned long int *array, int n);
+
+/**
+ * Declares the sorts DEFINE_COMPARISON_SORTS() and DEFINE_TIM_SORT() generate for one element
+ * type, each taking the elements as void * so they fit in typedSorts.
+*/
+#define DECLARE_COMPARISON_SORTS(SUFFIX) \
+    void selectionSort##SUFFIX(void *data, int n); \
+    void bubbleSort##SUFFIX(void *data, int n); \
+    void insertionSort##SUFFIX(void *data, int n); \
+    void mergeSort##SUFFIX(void *data, int n); \
+    void bufferedMergeSort##SUFFIX(void *data, int n); \
+    void bottomUpMergeSort##SUFFIX(void *data, int n); \
+    void quickSort##SUFFIX(void *data, int n); \
+    void lomutoQuickSort##SUFFIX(void *data, int n); \
+    void blockQuickSort##SUFFIX(void *data, int n); \
+    void heapSort##SUFFIX(void *data, int n); \
+    void bottomUpHeapSort##SUFFIX(void *data, int n); \
+    void quaternaryHeapSort##SUFFIX(void *data, int n); \
+    void octonaryHeapSort##SUFFIX(void *data, int n); \
+    void timSort##SUFFIX(void *data, int n);
+DECLARE_COMPARISON_SORTS(U32)
+DECLARE_COMPARISON_SORTS(F64)
+DECLARE_COMPARISON_SORTS(Record16)
+DECLARE_COMPARISON_SORTS(Record64)
+DECLARE_COMPARISON_SORTS(Record256)
+DECLARE_COMPARISON_SORTS(String)
+/**
+ * @brief qsort() on every element type, generated by DEFINE_QSORT()
+ */
+void libcQsortU32(void *data, int n);
+void libcQsortF64(void *data, int n);
+void libcQsortRecord16(void *data, int n);
+void libcQsortRecord64(void *data, int n);
+void libcQsortRecord256(void *data, int n);
+void libcQsortString(void *data, int n);
+/**
+ * @brief The LSD radix and American flag sorts DEFINE_RADIX_SORT() generates, for the types with a numeric key
+ */
+void lsdRadixSortU32(void *data, int n);
+void lsdRadixSortF64(void *data, int n);
+void lsdRadixSortRecord16(void *data, int n);
+void lsdRadixSortRecord64(void *data, int n);
+void lsdRadixSortRecord256(void *data, int n);
+void americanFlagSortU32(void *data, int n);
+void americanFlagSortF64(void *data, int n);
+void americanFlagSortRecord16(void *data, int n);
+void americanFlagSortRecord64(void *data, int n);
+void americanFlagSortRecord256(void *data, int n);
+#ifdef USE_STD_SORT
+/**
+ * Declares the standard library sorts stdSort.cpp defines for one element type.
+*/
+#define DECLARE_STD_SORTS(SUFFIX) \
+    void stdSort##SUFFIX(void *data, int n); \
+    void stdStableSort##SUFFIX(void *data, int n); \
+    void parallelStdSort##SUFFIX(void *data, int n);
+DECLARE_STD_SORTS(U32)
+DECLARE_STD_SORTS(F64)
+DECLARE_STD_SORTS(Record16)
+DECLARE_STD_SORTS(Record64)
+DECLARE_STD_SORTS(Record256)
+DECLARE_STD_SORTS(String)
+#endif
+/**
+ * @brief Sorts records by their leading 64-bit key through any key sort (argsort). Each record
+ * becomes one packed key: the bits of its key above the minimum that fit above the record
+ * index, and the index. After sortKeys, records whose packed keys had to drop low key bits are
+ * reordered by their remaining key bits with sortKeys too, and the sorted indices are applied
+ * to the records.
+ * @param records The records, each starting with its key
+ * @param n The number of records
+ * @param size Bytes per record, at most sizeof(Record256)
+ * @param sortKeys The algorithm that sorts the packed keys
+ * @param permuteMode PERMUTE_GATHER or PERMUTE_CYCLES
+ */
+void indirectSort(void *records, int n, size_t size, void (*sortKeys)(unsigned long int *, int), int permuteMode);
+/**
+ * @brief Orders a group of record indices whose keys minus minimum agree above bit shift, by
+ * packing as many of the bits below it as fit above a local index and sorting them with
+ * sortKeys. Groups still tied on the bits that did not fit are ordered again, recursively.
+ * @param indices The record indices of the group, reordered in place
+ * @param count The number of indices
+ * @param scratch Room for 2 * count words
+ */
+void sortIndirectGroup(unsigned long int *indices, int count, const unsigned char *records, size_t size,
+    uint64_t minimum, int shift, void (*sortKeys)(unsigned long int *, int), unsigned long int *scratch);
+/**
+ * @brief Moves records so that record i becomes the one at order[i], along the cycles of the
+ * permutation, with a single record of extra memory. order is overwritten.
+ */
+void permuteRecordsInPlace(unsigned char *records, int n, size_t size, unsigned long int *order);
+
+/*
+*
+* DATASET LOADER
+*
+*/
+/**
+ * @brief Loads the keys of a text or binary dataset. The file is memory-mapped where supported.
+ * @param filename The file to load
+ * @param dataset Receives the keys. It needs to be released with freeDataset().
+ * @return 1 on success, 0 on failure
+ */
+int loadDataset(const char *filename, LoadedDataset *dataset);
+/**
+ * @brief Releases the keys and the mapping of a dataset
+ */
+void freeDataset(LoadedDataset *dataset);
+/**
+ * @brief Parses the comma-separated format of appendArrayToFile(). Only lines of digits,
+ * commas and whitespace hold keys. Every other line, such as the headers of the output
+ * files, is skipped whole.
+ * @param data The text
+ * @param size The length of the text
+ * @param count Receives the number of keys
+ * @return The dynamically allocated keys, or NULL on failure or when a key does not fit in
+ * an unsigned long int
+ */
+unsigned long int *parseTextKeys(const char *data, size_t size, int *count);
+
+/*
+*
+* EXTERNAL SORT
+*
+*/
+/**
+ * @brief Sorts a binary dataset larger than memory: sorts memory-sized chunks into runs
+ * with an in-memory algorithm, then k-way merges the runs until one is left.
+ * @param config The batch configuration holding the external sort options
+ * @return The process exit status
+ */
+int runExternalSort(const BatchConfig *config);
+/**
+ * @brief Merges k sorted binary runs into one binary file using a loser tree
+ * @param runNames The run files
+ * @param k The number of runs
+ * @param outputName The merged file
+ * @param bufferKeys The size in keys of each read buffer and of the write buffer
+ * @return 1 on success, 0 on failure, after removing what was written of the merged file
+ */
+int mergeExternalRuns(char runNames[][RUN_NAME_SIZE], int k, const char *outputName, size_t bufferKeys);
+/**
+ * @brief Replays the loser tree matches from a leaf to the root after its run advanced.
+ * tree[0] holds the winner, tree[1..k-1] the loser of each match.
+ */
+void loserTreeAdjust(int *tree, const ExternalRun *runs, int k, int leaf);
+/**
+ * @brief Reads the next block of keys of a run into its buffer
+ * @return 1 if keys were read, 0 when the run is exhausted
+ */
+int externalRunRefill(ExternalRun *run);
+/**
+ * @brief Reads little-endian u64 keys
+ * @return The number of keys read
+ */
+size_t readBinaryKeys(FILE *file, unsigned long int *keys, size_t count);
+/**
+ * @brief Writes keys as little-endian u64
+ * @return 1 on success, 0 on failure
+ */
+int writeBinaryKeys(FILE *file, const unsigned long int *keys, size_t count);
+/**
+ * @brief Reads and checks the header of the binary format
+ * @param count Receives the number of keys
+ * @return 1 on success, 0 if the file is not in the binary format
+ */
+int readBinaryHeader(FILE *file, uint64_t *count);
+/**
+ * @brief Writes the header of the binary format
+ * @return 1 on success, 0 on failure
+ */
+int writeBinaryHeader(FILE *file, uint64_t count);
+
+/*
+*
+* PERFORMANCE COUNTERS
+*
+*/
+/**
+ * @brief Opens the hardware counters for the calling thread, as one group led by the first counter
+ * that opens (the cycles), so they are always scheduled together. Counters the kernel refuses are skipped.
+ * @return The number of counters that could be opened
+ */
+int perfCountersOpen(void);
+/**
+ * @brief Closes the counters opened by perfCountersOpen()
+ */
+void perfCountersClose(void);
+/**
+ * @brief Resets and enables the counter group
+ */
+void perfCountersStart(void);
+/**
+ * @brief Disables the counter group and adds its values to a reading. When the kernel multiplexed
+ * the group, the values are scaled by the time it was enabled over the time it ran.
+ */
+void perfCountersStop(PerfReading *reading);
+/**
+ * @brief Gives the file descriptor of the group leader, the first open counter, or -1
+ */
+int perfCounterLeader(void);
+/**
+ * @brief Prints the counters of the last benchmark as IPC and events per element
+ * @param n The number of elements that were sorted
+ */
+void displayPerfCounters(int n);
+/**
+ * @brief Prints the comparisons, swaps and writes per sort of the last benchmark.
+ * Only available in the instrumented build.
+ * @param order The algorithms in the order they are listed in
+ * @param count The number of algorithms in order
+ */
+void displayOperationCounts(const SortingAlgorithm *order, int count);
+
+/*
+*
+* TASK POOL
+*
+*/
+/**
+ * @brief Creates a work-stealing pool. With an affinity, the creating thread is pinned as worker 0
+ * until the pool is destroyed.
+ * @param threadCount Number of workers, including the thread that waits on the tasks
+ * @return The pool. It needs to be destroyed with taskPoolDestroy().
+ */
+TaskPool *taskPoolCreate(int threadCount);
+/**
+ * @brief Stops the workers, gives the creating thread back the processors it had before the pool,
+ * and frees the pool
+ */
+void taskPoolDestroy(TaskPool *pool);
+/**
+ * @brief Queues a task on the deque of the calling worker
+ * @param pool The task pool
+ * @param group The group the task is counted in
+ * @param function The function to run
+ * @param argument The argument structure, copied into the task
+ * @param argumentSize The size of the argument structure, at most TASK_ARGUMENT_SIZE
+ */
+void taskPoolSpawn(TaskPool *pool, TaskGroup *group, void (*function)(void *), const void *argument, size_t argumentSize);
+/**
+ * @brief Runs queued tasks until every task of the group has finished
+ */
+void taskPoolWait(TaskPool *pool, TaskGroup *group);
+/**
+ * @brief Gives the shared pool, recreating it when benchmarkOptions.threads or benchmarkOptions.affinity changed
+ */
+TaskPool *getTaskPool(void);
+/**
+ * @brief Gives the number of online processors
+ */
+int getProcessorCount(void);
+/**
+ * @brief Gives the processors the process may run on, in increasing order. The first call reads
+ * the affinity of the calling thread, so it must come before any thread is pinned and before
+ * the pool workers start.
+ * @param processors Set to the list of processors
+ * @return The number of processors in the list, at least 1
+ */
+int getAllowedProcessors(const int **processors);
+/**
+ * @brief Gives the processor a worker of the pool is pinned to, among the allowed processors and
+ * counted from benchmarkOptions.pinProcessor
+ * @param affinity AFFINITY_COMPACT or AFFINITY_SPREAD
+ * @param worker The index of the worker
+ * @param threadCount Number of workers in the pool
+ */
+int getWorkerProcessor(int affinity, int worker, int threadCount);
+/**
+ * @brief Restricts the calling thread to one processor. Does nothing where it is not supported.
+ * @return 1 when the thread was pinned, 0 otherwise
+ */
+int pinCurrentThread(int processor);
+/**
+ * @brief Saves the processors the calling thread may run on
+ * @return 1 when they were saved, 0 where it is not supported
+ */
+int saveThreadAffinity(ThreadAffinity *affinity);
+/**
+ * @brief Restores the processors saved by saveThreadAffinity() on the calling thread
+ */
+void restoreThreadAffinity(const ThreadAffinity *affinity);
+
+/**
+ * @brief Clears the contents of a file.
+ * @param filename The name of the file to be cleared.
+*/
+void clearFile(const char *filename);
+/**
+ * @brief Appends a formatted string to a file.
+ * @param filename The name of the file to append to.
+ * @param format The format string (supports printf-style formatting).
+ * @param ... Additional arguments for formatting.
+ */
+void appendStringToFile(const char *filename, const char *format, ...);
+/**
+ * @brief Appends an array of unsigned long integers to a file.
+ * @param filename The name of the file to append to.
+ * @param array The array of unsigned long integers.
+ * @param n The number of elements in the array.
+ */
+void appendArrayToFile(const char *filename, unsigned long int *array, int n);
+/**
+ * @brief Writes the decimal digits of a value without a terminating null character.
+ * @param value The value to format.
+ * @param buffer Receives the digits. It needs room for 20 characters.
+ * @return The number of characters written.
+ */
+int formatUnsignedLong(unsigned long int value, char *buffer);
+/**
+ * @brief Writes an array in the binary format (see OUTPUT_BINARY), replacing the file.
+ * @param filename The name of the file to write.
+ * @param array The array of unsigned long integers.
+ * @param n The number of elements in the array.
+ * @return 1 on success, 0 on failure.
+ */
+int writeArrayBinary(const char *filename, const unsigned long int *array, int n);
+/**
+ * @brief Writes a sorted array to the output file of its algorithm in benchmarkOptions.outputFormat.
+ * Binary files use the name of the output file with a .bin extension.
+ */
+void writeSortedOutput(const SortingAlgorithm *algorithm, unsigned long int *array, int n);
+/**
+ * @brief Creates a duplicate of an unsigned long int array.
+ * @param array The original array to be duplicated.
+ * @param n The number of elements in the array.
+ * @return A pointer to the newly allocated duplicate array.
+ */
+unsigned long int *duplicateArray(const unsigned long int *array, int n);
+/**
+ * @brief Creates a duplicate of an array of SortingAlgorithm structures.
+ * @param array The original array of SortingAlgorithm structures.
+ * @param n The number of elements in the array.
+ * @return A pointer to the newly allocated duplicate array.
+ */
+SortingAlgorithm *duplicateAlgorithmsArray(SortingAlgorithm *array, int n);
+unsigned long int getPositiveInteger(const char *prompt);
+/**
+ * @brief Gives the current time in seconds.
+ * @returns The calculated time.
+*/
+double getTimeInSeconds(void);
+/**
+ * @brief The callback function used in qsort()
+ * @param a Pointer to the first element.
+ * @param b Pointer to the second element.
+ * @return A negative value if a < b, 0 if equal, a positive value if a > b.
+ */
+int compareByTime(const void *a, const void *b);
+/**
+ * @brief The callback function used in qsort() for arrays of doubles
+ * @param a Pointer to the first element.
+ * @param b Pointer to the second element.
+ * @return A negative value if a < b, 0 if equal, a positive value if a > b.
+ */
+int compareDoubles(const void *a, const void *b);
+/**
+ * @brief Checks whether keys are stored as little-endian 64-bit integers in memory,
+ * the layout of the binary format, so they can be read and written without conversion.
+ */
+int isNativeKeyLayout(void);
+/**
+ * @brief Gives the widest instruction set the vector kernels use: what the processor
+ * supports, detected once, capped by benchmarkOptions.simdLevel. Operation-counting builds
+ * always get SIMD_NONE, as the vector kernels do not count their comparisons.
+ * @return A SIMD_ constant
+ */
+int getSimdLevel(void);
+/**
+ * @brief Finds an algorithm by the name of its output file without the extension
+ * @param key The key, e.g. "merge-sort"
+ * @return The index in algorithms, or -1 if none matches
+ */
+int findAlgorithmByKey(const char *key);
+/**
+ * @brief Clears the terminal screen.
+ */
+void clearScreen(void);
+/**
+ * @brief Displays the program header.
+ */
+void displayHeader(void);
+/**
+ * @brief Displays a confirmation message before exiting the program.
+ */
+void displayConfirmExit(void);
+/**
+ * @brief Pauses the program execution for a specified duration.
+ * @param milliseconds The duration to sleep in milliseconds.
+ */
+void sleepProgram(int milliseconds);
 
 /**
  * Initialize the algorithms array. This is made global as multiple functions access it.
 */
-SortingAlgorithm algorithms[] = {
-    {"Selection Sort", "selection-sort.txt", 0.0, selectionSort},
-    {"Bubble Sort", "bubble-sort.txt", 0.0,  bubbleSort},
-    {"Insertion Sort", "insertion-sort.txt", 0.0, insertionSort},
-    {"Merge Sort", "merge-sort.txt", 0.0, mergeSort},
-    {"Quick Sort", "quick-sort.txt", 0.0, quickSort},
-    {"Heap Sort", "heap-sort.txt", 0.0, heapSort},
-};
-int algorithmsSize = sizeof(algorithms)/sizeof(algorithms[0]);
+SortingAlgorithm algorithms[] = {
+    {.name = "Selection Sort", .outputFile = "selection-sort.txt", .function = selectionSort, .isParallel = 0},
+    {.name = "Bubble Sort", .outputFile = "bubble-sort.txt", .function = bubbleSort, .isParallel = 0},
+    {.name = "Insertion Sort", .outputFile = "insertion-sort.txt", .function = insertionSort, .isParallel = 0},
+    {.name = "Merge Sort", .outputFile = "merge-sort.txt", .function = mergeSort, .isParallel = 0},
+    {.name = "Buffered Merge Sort", .outputFile = "buffered-merge-sort.txt", .function = bufferedMergeSort, .isParallel = 0},
+    {.name = "Bottom-Up Merge Sort", .outputFile = "bottom-up-merge-sort.txt", .function = bottomUpMergeSort, .isParallel = 0},
+    {.name = "Quick Sort", .outputFile = "quick-sort.txt", .function = quickSort, .isParallel = 0},
+    {.name = "Lomuto Quick Sort", .outputFile = "lomuto-quick-sort.txt", .function = lomutoQuickSort, .isParallel = 0},
+    {.name = "Block Quick Sort", .outputFile = "block-quick-sort.txt", .function = blockQuickSort, .isParallel = 0},
+    {.name = "Heap Sort", .outputFile = "heap-sort.txt", .function = heapSort, .isParallel = 0},
+    {.name = "Bottom-Up Heap Sort", .outputFile = "bottom-up-heap-sort.txt", .function = bottomUpHeapSort, .isParallel = 0},
+    {.name = "4-ary Heap Sort", .outputFile = "4-ary-heap-sort.txt", .function = quaternaryHeapSort, .isParallel = 0},
+    {.name = "8-ary Heap Sort", .outputFile = "8-ary-heap-sort.txt", .function = octonaryHeapSort, .isParallel = 0},
+    {.name = "Parallel Quick Sort", .outputFile = "parallel-quick-sort.txt", .function = parallelQuickSort, .isParallel = 1},
+    {.name = "Parallel Merge Sort", .outputFile = "parallel-merge-sort.txt", .function = parallelMergeSort, .isParallel = 1},
+    {.name = "Parallel Sample Sort", .outputFile = "parallel-sample-sort.txt", .function = parallelSampleSort, .isParallel = 1},
+    {.name = "Parallel Radix Sort", .outputFile = "parallel-radix-sort.txt", .function = parallelRadixSort, .isParallel = 1},
+    {.name = "LSD Radix Sort", .outputFile = "lsd-radix-sort.txt", .function = lsdRadixSort, .isParallel = 0},
+    {.name = "American Flag Sort", .outputFile = "american-flag-sort.txt", .function = americanFlagSort, .isParallel = 0},
+    {.name = "TimSort", .outputFile = "tim-sort.txt", .function = timSort, .isParallel = 0},
+    {.name = "Vector Quick Sort", .outputFile = "vector-quick-sort.txt", .function = vectorQuickSort, .isParallel = 0},
+    {.name = "Vector Merge Sort", .outputFile = "vector-merge-sort.txt", .function = vectorMergeSort, .isParallel = 0},
+    {.name = "libc qsort", .outputFile = "libc-qsort.txt", .function = libcQsort, .isParallel = 0},
+#ifdef USE_STD_SORT
+    {.name = "std::sort", .outputFile = "std-sort.txt", .function = stdSort, .isParallel = 0},
+    {.name = "std::stable_sort", .outputFile = "std-stable-sort.txt", .function = stdStableSort, .isParallel = 0},
+    // Not swept over --threads, the standard library picks its own thread count
+    {.name = "Parallel std::sort", .outputFile = "parallel-std-sort.txt", .function = parallelStdSort, .isParallel = 0},
+#endif
+};
+int algorithmsSize = sizeof(algorithms)/sizeof(algorithms[0]);
+
+/**
+ * The element types, indexed by the ELEMENT_ constants.
+*/
+ElementType elementTypes[ELEMENT_TYPE_COUNT] = {
+    {"32-bit unsigned", "u32", sizeof(uint32_t), -1},
+    {"64-bit unsigned", "u64", sizeof(unsigned long int), -1},
+    {"Double", "f64", sizeof(double), -1},
+    {"16-byte record", "record16", sizeof(Record16), -1},
+    {"64-byte record", "record64", sizeof(Record64), -1},
+    {"256-byte record", "record256", sizeof(Record256), -1},
+    {"String", "string", sizeof(char *), -1},
+    {"16-byte record, indirect", "record16-indirect", sizeof(Record16), ELEMENT_RECORD16},
+    {"64-byte record, indirect", "record64-indirect", sizeof(Record64), ELEMENT_RECORD64},
+    {"256-byte record, indirect", "record256-indirect", sizeof(Record256), ELEMENT_RECORD256},
+};
+
+/**
+ * The specializations of the algorithms for the element types other than ELEMENT_U64.
+ * An algorithm without an entry for a type is skipped when that type is benchmarked.
+*/
+#define TYPED_COMPARISON_SORTS(SUFFIX, TYPE) \
+    {"selection-sort", TYPE, selectionSort##SUFFIX}, \
+    {"bubble-sort", TYPE, bubbleSort##SUFFIX}, \
+    {"insertion-sort", TYPE, insertionSort##SUFFIX}, \
+    {"merge-sort", TYPE, mergeSort##SUFFIX}, \
+    {"buffered-merge-sort", TYPE, bufferedMergeSort##SUFFIX}, \
+    {"bottom-up-merge-sort", TYPE, bottomUpMergeSort##SUFFIX}, \
+    {"quick-sort", TYPE, quickSort##SUFFIX}, \
+    {"lomuto-quick-sort", TYPE, lomutoQuickSort##SUFFIX}, \
+    {"block-quick-sort", TYPE, blockQuickSort##SUFFIX}, \
+    {"heap-sort", TYPE, heapSort##SUFFIX}, \
+    {"bottom-up-heap-sort", TYPE, bottomUpHeapSort##SUFFIX}, \
+    {"4-ary-heap-sort", TYPE, quaternaryHeapSort##SUFFIX}, \
+    {"8-ary-heap-sort", TYPE, octonaryHeapSort##SUFFIX}, \
+    {"tim-sort", TYPE, timSort##SUFFIX}
+#define TYPED_STD_SORTS(SUFFIX, TYPE) \
+    {"std-sort", TYPE, stdSort##SUFFIX}, \
+    {"std-stable-sort", TYPE, stdStableSort##SUFFIX}, \
+    {"parallel-std-sort", TYPE, parallelStdSort##SUFFIX}
+TypedSort typedSorts[] = {
+    TYPED_COMPARISON_SORTS(U32, ELEMENT_U32),
+    TYPED_COMPARISON_SORTS(F64, ELEMENT_F64),
+    TYPED_COMPARISON_SORTS(Record16, ELEMENT_RECORD16),
+    TYPED_COMPARISON_SORTS(Record64, ELEMENT_RECORD64),
+    TYPED_COMPARISON_SORTS(Record256, ELEMENT_RECORD256),
+    TYPED_COMPARISON_SORTS(String, ELEMENT_STRING),
+    {"lsd-radix-sort", ELEMENT_U32, lsdRadixSortU32},
+    {"lsd-radix-sort", ELEMENT_F64, lsdRadixSortF64},
+    {"lsd-radix-sort", ELEMENT_RECORD16, lsdRadixSortRecord16},
+    {"lsd-radix-sort", ELEMENT_RECORD64, lsdRadixSortRecord64},
+    {"lsd-radix-sort", ELEMENT_RECORD256, lsdRadixSortRecord256},
+    {"american-flag-sort", ELEMENT_U32, americanFlagSortU32},
+    {"american-flag-sort", ELEMENT_F64, americanFlagSortF64},
+    {"american-flag-sort", ELEMENT_RECORD16, americanFlagSortRecord16},
+    {"american-flag-sort", ELEMENT_RECORD64, americanFlagSortRecord64},
+    {"american-flag-sort", ELEMENT_RECORD256, americanFlagSortRecord256},
+    {"libc-qsort", ELEMENT_U32, libcQsortU32},
+    {"libc-qsort", ELEMENT_F64, libcQsortF64},
+    {"libc-qsort", ELEMENT_RECORD16, libcQsortRecord16},
+    {"libc-qsort", ELEMENT_RECORD64, libcQsortRecord64},
+    {"libc-qsort", ELEMENT_RECORD256, libcQsortRecord256},
+    {"libc-qsort", ELEMENT_STRING, libcQsortString},
+#ifdef USE_STD_SORT
+    TYPED_STD_SORTS(U32, ELEMENT_U32),
+    TYPED_STD_SORTS(F64, ELEMENT_F64),
+    TYPED_STD_SORTS(Record16, ELEMENT_RECORD16),
+    TYPED_STD_SORTS(Record64, ELEMENT_RECORD64),
+    TYPED_STD_SORTS(Record256, ELEMENT_RECORD256),
+    TYPED_STD_SORTS(String, ELEMENT_STRING),
+#endif
+};
+int typedSortsSize = sizeof(typedSorts)/sizeof(typedSorts[0]);
+
+/**
+ * The data generation methods, indexed by the menu choice minus one.
+ * The keys are used to select the methods in batch mode.
+*/
+DataGenerator dataGenerators[] = {
+    {"Random Integers", "random", fillRandom, NULL, 0},
+    {"Increasing Sequence", "increasing", fillIncreasing, NULL, 1},
+    {"Reversed Sequence", "reversed", fillReversed, NULL, 1},
+    {"Nearly Sorted", "nearly-sorted", fillIncreasing, finishNearlySorted, 1},
+    {"Few Unique", "few-unique", fillFewUnique, NULL, 0},
+    {"Organ Pipe", "organ-pipe", fillOrganPipe, NULL, 1},
+    {"Sawtooth", "sawtooth", fillSawtooth, NULL, 1},
+    {"Zipf", "zipf", fillZipf, NULL, 0},
+    {"All Equal", "equal", fillEqual, NULL, 1},
+};
+int dataGeneratorsSize = sizeof(dataGenerators)/sizeof(dataGenerators[0]);
+
+/**
+ * The ways of finding the k smallest keys compared by --select. The full sort comes first,
+ * the others are timed against it.
+*/
+SelectionEngine selectionEngines[] = {
+    {"Full Sort", "full-sort", fullSortSelect, 1},
+    {"Introselect", "introselect", introSelect, 0},
+    {"Select + Sort", "select-sort", selectAndSort, 1},
+    {"Partial Quick Sort", "partial-quick-sort", partialQuickSort, 1},
+    {"Heap Top-K", "heap-top-k", heapTopK, 1},
+};
+int selectionEnginesSize = sizeof(selectionEngines)/sizeof(selectionEngines[0]);
+
+/**
+ * The parameters of the data generation methods. Batch mode uses DEFAULT_SEED unless --seed is
+ * given, the interactive mode seeds every run from the clock and shows the seed it used.
+*/
+GeneratorOptions generatorOptions = {DEFAULT_SEED, 0, -1, DEFAULT_UNIQUE_COUNT, 1.0, 0};
+
+/**
+ * The measurement settings shared by the interactive and batch modes.
+*/
+BenchmarkOptions benchmarkOptions = {1, 0, OUTPUT_TEXT, 0, 1, DEFAULT_GRAIN_SIZE, 0, 0, 0.0, ELEMENT_U64, SIMD_AVX512, PERMUTE_GATHER, AFFINITY_NONE, -1, 0, 0, 0};
+/**
+ * The cutoffs of the hybrid sorts, and how runTuning() searches them.
+*/
+CutoffProfile cutoffs = {QUICK_SORT_INSERTION_THRESHOLD, MSD_INSERTION_THRESHOLD, SIMD_LEAF_SIZE};
+TunableCutoff tunableCutoffs[] = {
+    {"quick-sort-cutoff", "block-quick-sort", &cutoffs.quickSortCutoff, 8, 1024, {8, 12, 16, 20, 24, 32, 40, 48, 64, 96, 128}, 11, 0},
+    {"radix-cutoff", "american-flag-sort", &cutoffs.radixCutoff, 1, 4096, {8, 16, 24, 32, 48, 64, 96, 128, 192, 256}, 10, 0},
+    {"vector-leaf", "vector-quick-sort", &cutoffs.vectorLeafSize, 8, SIMD_LEAF_SIZE, {8, 16, 24, 32, 48, 64}, 6, 0},
+    {"grain", "parallel-merge-sort", &benchmarkOptions.grainSize, 2, INT_MAX, {1024, 2048, 4096, 8192, 16384, 32768, 65536, 131072}, 8, 1},
+};
+int tunableCutoffsSize = sizeof(tunableCutoffs)/sizeof(tunableCutoffs[0]);
+/**
+ * Labels of the RUN_, SIMD_, AFFINITY_ and TIMER_ constants in the results.
+*/
+const char *runStatusNames[] = {"ok", "timeout", "failed", "invalid"};
+const char *simdLevelNames[] = {"none", "avx2", "avx512"};
+const char *affinityNames[] = {"none", "compact", "spread"};
+const char *timerSourceNames[] = {"clock", "tsc"};
+/**
+ * The number of benchmarks whose output failed verification. A batch run with any exits with EXIT_FAILURE.
+*/
+int invalidRunsCount = 0;
+/**
+ * The counter readTimer() reads, chosen by getTimerFrequency().
+*/
+int timerSource = TIMER_CLOCK;
+
+/**
+ * The hardware counters read around each sort. The file descriptors are -1 when unavailable.
+*/
+const char *perfCounterNames[PERF_COUNTER_COUNT] = {
+    "cycles",
+    "instructions",
+    "branch-misses",
+    "L1d-misses",
+    "LLC-misses",
+    "dTLB-misses"
+};
+int perfCounterFds[PERF_COUNTER_COUNT] = {-1, -1, -1, -1, -1, -1};
+
+/**
+ * Operation counters of the instrumented build (compiled with -DCOUNT_OPERATIONS).
+ * Comparisons are counted when a key is compared with another key, swaps when two keys
+ * exchange places, and writes when a key is stored outside of a swap (merges, shifts, scatters).
+ * In the normal build the macros expand to the bare expression and nothing is counted.
+*/
+#ifdef COUNT_OPERATIONS
+    atomic_ullong operationComparisons;
+    atomic_ullong operationSwaps;
+    atomic_ullong operationWrites;
+    #define COUNT_COMPARISON(expression) (atomic_fetch_add_explicit(&operationComparisons, 1, memory_order_relaxed), (expression))
+    #define COUNT_SWAP() atomic_fetch_add_explicit(&operationSwaps, 1, memory_order_relaxed)
+    #define COUNT_WRITES(count) atomic_fetch_add_explicit(&operationWrites, (unsigned long long)(count), memory_order_relaxed)
+#else
+    #define COUNT_COMPARISON(expression) (expression)
+    #define COUNT_SWAP() ((void)0)
+    #define COUNT_WRITES(count) ((void)0)
+#endif
+
+/**
+ * The pool shared by the parallel algorithms, created on demand by getTaskPool().
+*/
+TaskPool *taskPool = NULL;
+/**
+ * The index of the pool worker running on the current thread. Threads outside the pool use 0.
+*/
+_Thread_local int currentWorkerIndex = 0;
+
+int main(int argc, char *argv[]) { 
+    // The parallel algorithms use every processor unless told otherwise
+    benchmarkOptions.threads = getProcessorCount();
+
+    // Any argument switches to the unattended batch mode
+    if (argc > 1) {
+        return runBatchFromArguments(argc, argv);
+    }
+
+    // The interactive mode only takes the tuned cutoffs from the batch options
+    BatchConfig profileConfig;
+    memset(&profileConfig, 0, sizeof(profileConfig));
+    loadCutoffProfile(&profileConfig, DEFAULT_PROFILE_FILE);
+
+    int isExit = 0;
+    while(!isExit) {
+        clearScreen();
+        displayHeader();
+
+        // Prompt for N
+        printf("\n");
+        int numOfIntegers = (int)getPositiveInteger("Number of integers (N): ");
+
+        // Print data generation methods
+        printf("Data Generation Method:");
+        for(int i = 0; i < dataGeneratorsSize; i++) {
+            printf("\n\t%d) %s", i+1, dataGenerators[i].name);
+        }
+
+        // Get data generation method
+        int selectedGenerationMethod = 0;
+        printf("\nPlease choose a method: ");
+        scanf("%d", &selectedGenerationMethod);
+        int method = selectedGenerationMethod - 1;
+
+        // Every run gets a new seed, shown with the results so the data can be regenerated
+        generatorOptions.seed = (uint64_t)time(NULL);
+        generatorOptions.startingValue = 0;
+
+        if (method >= 0 && method < dataGeneratorsSize) {
+            if (dataGenerators[method].usesStartingValue) {
+                // Verify that the starting value (X) is a positive integer
+                generatorOptions.startingValue = getPositiveInteger("What is the starting value? (X): ");
+            }
+
+            // Clear the terminal as data about the current algorithm will be displayed
+            clearScreen();
+            displayHeader();
+
+            // Generate the data
+            printf("\nGenerating data...");
+            unsigned long int *unsortedArr = generateData(method, numOfIntegers);
+            if (unsortedArr == NULL) {
+                perror("Memory allocation failed");
+                exit(EXIT_FAILURE);
+            }
+
+            // After every run, clear the unsorted output file, then output the data to it
+            char *unsortedArrayOutputFile = "unsorted.txt";
+            clearFile(unsortedArrayOutputFile);
+            appendStringToFile(unsortedArrayOutputFile, "\nUnsorted Array | Number of elements (N): %d | %s | Seed: %llu\n",
+                numOfIntegers, dataGenerators[method].key, (unsigned long long)generatorOptions.seed);
+            appendArrayToFile(unsortedArrayOutputFile, unsortedArr, numOfIntegers);
+
+            // Run benchmarks on the data
+            runBenchmark(unsortedArr, numOfIntegers);
+            free(unsortedArr);
+
+            // results.csv only has the times, results.jsonl describes the run as well
+            char seed[32];
+            snprintf(seed, sizeof(seed), "%llu", (unsigned long long)generatorOptions.seed);
+            for (int i = 0; i < algorithmsSize; i++) {
+                appendJsonResult("results.jsonl", dataGenerators[method].key, seed, numOfIntegers, &algorithms[i],
+                    algorithms[i].isParallel ? benchmarkOptions.threads : 1);
+            }
+        }
+
+        // Sort the algortihms array by time 
+        SortingAlgorithm *algorithmsCopy = duplicateAlgorithmsArray(algorithms, algorithmsSize);
+        qsort(algorithmsCopy, algorithmsSize, sizeof(SortingAlgorithm), compareByTime);
+
+        // Clear the terminal as the benchmark results will be displayed
+        clearScreen();
+        displayHeader();
+
+        // Data generation information
+        printf("\nNumber of Elements (N): %d", numOfIntegers);
+        if (method >= 0 && method < dataGeneratorsSize) {
+            printf("\nGeneration Method: %s", dataGenerators[method].name);
+            printf("\nSeed: %llu", (unsigned long long)generatorOptions.seed);
+            if (dataGenerators[method].usesStartingValue) {
+                printf("\nStarting Value (X): %lu", generatorOptions.startingValue);
+            }
+        }
+        
+        // Algorithm benchamrks
+        printf("\n-----------------------------------------------");
+        printf("\n| Rank |       Algorithm      |      Time     |");
+        printf("\n-----------------------------------------------");
+        for(int i = 0; i < algorithmsSize; i++) {
+            printf("\n|%5d | %20s | %14.9lf|", i+1, algorithmsCopy[i].name, algorithmsCopy[i].time);
+        }
+        printf("\n-----------------------------------------------");
+        #ifdef COUNT_OPERATIONS
+            printf("\n\nOperation counts:");
+            displayOperationCounts(algorithmsCopy, algorithmsSize);
+        #endif
+
+        displayConfirmExit();
+        free(algorithmsCopy);
+    }
+    return 0;
+}
+
+/*
+*
+* DATA GENERATION METHODS
+*
+*/
+uint64_t splitMix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+void randomSeed(RandomGenerator *rng, uint64_t seed, uint64_t stream) {
+    // splitmix64 never yields four zero words, which xoshiro cannot start from
+    uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+    for (int i = 0; i < 4; i++) {
+        rng->state[i] = splitMix64(&state);
+    }
+}
+uint64_t randomNext(RandomGenerator *rng) {
+    uint64_t *s = rng->state;
+    uint64_t scrambled = s[1] * 5;
+    uint64_t result = ((scrambled << 7) | (scrambled >> 57)) * 9;
+    uint64_t shifted = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= shifted;
+    s[3] = (s[3] << 45) | (s[3] >> 19);
+    return result;
+}
+uint64_t randomBounded(RandomGenerator *rng, uint64_t bound) {
+    #ifdef __SIZEOF_INT128__
+        // The high word of value * bound is in [0, bound). Rejecting the few low words below
+        // 2^64 mod bound removes the bias, and the division is only needed when it might apply.
+        unsigned __int128 product = (unsigned __int128)randomNext(rng) * bound;
+        uint64_t low = (uint64_t)product;
+        if (low < bound) {
+            uint64_t threshold = (0 - bound) % bound;
+            while (low < threshold) {
+                product = (unsigned __int128)randomNext(rng) * bound;
+                low = (uint64_t)product;
+            }
+        }
+        return (uint64_t)(product >> 64);
+    #else
+        uint64_t threshold = (0 - bound) % bound;
+        uint64_t value;
+        do {
+            value = randomNext(rng);
+        } while (value < threshold);
+        return value % bound;
+    #endif
+}
+double randomUniform(RandomGenerator *rng) {
+    return (randomNext(rng) >> 11) * 0x1.0p-53;
+}
+
+void fillRandom(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng) {
+    (void)n;
+    // Full range of the key type
+    for (int i = begin; i < end; i++) {
+        array[i] = (unsigned long int)randomNext(rng);
+    }
+}
+void fillIncreasing(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng) {
+    (void)n;
+    (void)rng;
+    for (int i = begin; i < end; i++) {
+        array[i] = generatorOptions.startingValue + i;
+    }
+}
+void fillReversed(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng) {
+    (void)rng;
+    for (int i = begin; i < end; i++) {
+        array[i] = generatorOptions.startingValue + (n - 1 - i);
+    }
+}
+void fillFewUnique(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng) {
+    (void)n;
+    // The distinct keys are spread evenly over the key range
+    unsigned long int count = generatorOptions.uniqueCount;
+    unsigned long int spacing = ULONG_MAX / count;
+    for (int i = begin; i < end; i++) {
+        array[i] = (unsigned long int)randomBounded(rng, count) * spacing;
+    }
+}
+void fillOrganPipe(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng) {
+    (void)rng;
+    // Increasing up to the middle, then decreasing back down
+    for (int i = begin; i < end; i++) {
+        int distance = i < n - 1 - i ? i : n - 1 - i;
+        array[i] = generatorOptions.startingValue + distance;
+    }
+}
+void fillSawtooth(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng) {
+    (void)rng;
+    int runLength = generatorOptions.runLength;
+    if (runLength < 1) {
+        runLength = (int)sqrt((double)n);
+        if (runLength < 1) runLength = 1;
+    }
+    for (int i = begin; i < end; i++) {
+        array[i] = generatorOptions.startingValue + i % runLength;
+    }
+}
+double zipfHelper1(double x) {
+    // log(1 + x) / x, using its Taylor series near zero where the division loses precision
+    if (fabs(x) > 1e-8) return log1p(x) / x;
+    return 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+double zipfHelper2(double x) {
+    // (exp(x) - 1) / x, using its Taylor series near zero
+    if (fabs(x) > 1e-8) return expm1(x) / x;
+    return 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+}
+double zipfHIntegral(double x, double exponent) {
+    double logX = log(x);
+    return zipfHelper2((1.0 - exponent) * logX) * logX;
+}
+double zipfHIntegralInverse(double x, double exponent) {
+    double t = x * (1.0 - exponent);
+    if (t < -1.0) t = -1.0;
+    return exp(zipfHelper1(t) * x);
+}
+void fillZipf(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng) {
+    // Ranks 1..n, rank k drawn with a probability proportional to k^-exponent.
+    // Rejection-inversion accepts almost every draw and needs no table of the n weights.
+    double exponent = generatorOptions.zipfExponent;
+    double hIntegralX1 = zipfHIntegral(1.5, exponent) - 1.0;
+    double hIntegralN = zipfHIntegral(n + 0.5, exponent);
+    double squeeze = 2.0 - zipfHIntegralInverse(zipfHIntegral(2.5, exponent) - exp(-exponent * log(2.0)), exponent);
+    for (int i = begin; i < end; i++) {
+        double rank;
+        while (1) {
+            double u = hIntegralN + randomUniform(rng) * (hIntegralX1 - hIntegralN);
+            double x = zipfHIntegralInverse(u, exponent);
+            rank = floor(x + 0.5);
+            if (rank < 1.0) rank = 1.0;
+            if (rank > n) rank = n;
+            if (rank - x <= squeeze || u >= zipfHIntegral(rank + 0.5, exponent) - exp(-exponent * log(rank))) {
+                break;
+            }
+        }
+        array[i] = (unsigned long int)rank;
+    }
+}
+void fillEqual(unsigned long int *array, int begin, int end, int n, RandomGenerator *rng) {
+    (void)n;
+    (void)rng;
+    for (int i = begin; i < end; i++) {
+        array[i] = generatorOptions.startingValue;
+    }
+}
+void finishNearlySorted(unsigned long int *array, int n, RandomGenerator *rng) {
+    int swaps = generatorOptions.swaps >= 0 ? generatorOptions.swaps : n / 100;
+    for (int k = 0; k < swaps; k++) {
+        int i = (int)randomBounded(rng, n);
+        int j = (int)randomBounded(rng, n);
+        unsigned long int temp = array[i];
+        array[i] = array[j];
+        array[j] = temp;
+    }
+}
+
+/**
+ * The arguments of the block generation task. They are copied into the task itself.
+*/
+typedef struct {
+    unsigned long int *array;
+    int begin, end, n;
+    int method;
+} GeneratorBlockArguments;
+
+void generateBlockTask(void *argument) {
+    GeneratorBlockArguments *arguments = (GeneratorBlockArguments *)argument;
+    RandomGenerator rng;
+    randomSeed(&rng, generatorOptions.seed, arguments->begin / GENERATOR_BLOCK_SIZE);
+    dataGenerators[arguments->method].fill(arguments->array, arguments->begin, arguments->end, arguments->n, &rng);
+}
+unsigned long int *generateData(int method, int n) {
+    if (method < 0 || method >= dataGeneratorsSize) {
+        return NULL;
+    }
+    unsigned long int *array = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    if (array == NULL) {
+        return NULL;
+    }
+
+    // The blocks are the same whatever the thread count, only their scheduling differs
+    if (benchmarkOptions.threads > 1 && n > GENERATOR_BLOCK_SIZE) {
+        TaskPool *pool = getTaskPool();
+        TaskGroup group = {0};
+        for (int begin = 0; begin < n; begin += GENERATOR_BLOCK_SIZE) {
+            int end = n - begin > GENERATOR_BLOCK_SIZE ? begin + GENERATOR_BLOCK_SIZE : n;
+            GeneratorBlockArguments block = {array, begin, end, n, method};
+            taskPoolSpawn(pool, &group, generateBlockTask, &block, sizeof(block));
+        }
+        taskPoolWait(pool, &group);
+    } else {
+        for (int begin = 0; begin < n; begin += GENERATOR_BLOCK_SIZE) {
+            int end = n - begin > GENERATOR_BLOCK_SIZE ? begin + GENERATOR_BLOCK_SIZE : n;
+            GeneratorBlockArguments block = {array, begin, end, n, method};
+            generateBlockTask(&block);
+        }
+    }
+
+    if (dataGenerators[method].finish != NULL) {
+        // The sequential pass uses a stream no block can reach
+        RandomGenerator rng;
+        randomSeed(&rng, generatorOptions.seed, UINT64_MAX);
+        dataGenerators[method].finish(array, n, &rng);
+    }
+    return array;
+}
+
+void runBenchmark(unsigned long int *array, int n) {
+    // The benchmarks result will also be outputted in a csv
+    if (!benchmarkOptions.isBatch) {
+        appendStringToFile("results.csv", "\n");
+    }
+
+    double *samples = (double *)malloc(benchmarkOptions.repetitions * sizeof(double));
+    if (samples == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Pin and calibrate, then start the worker threads, before any timer does
+    prepareMeasurement();
+    getTaskPool();
+
+    if (benchmarkOptions.usePerfCounters && perfCountersOpen() == 0) {
+        printf("\nHardware counters are unavailable, only the time is measured.");
+    }
+
+    // Other element types sort a converted copy of the keys, made before any timer starts
+    TypedArray input;
+    convertKeys(array, n, benchmarkOptions.elementType, &input);
+
+    printf("\nRunning benchmarks...");
+    for(int i = 0; i < algorithmsSize; i++) {
+        if (algorithms[i].isSkipped || !isTypeSupported(&algorithms[i], input.type)) continue;
+        algorithms[i].status = RUN_OK;
+        double *algorithmSamples = (double *)realloc(algorithms[i].samples, benchmarkOptions.repetitions * sizeof(double));
+        if (algorithmSamples == NULL) {
+            perror("Memory allocation failed");
+            exit(EXIT_FAILURE);
+        }
+        algorithms[i].samples = algorithmSamples;
+        memset(&algorithms[i].memory, 0, sizeof(algorithms[i].memory));
+
+        // Inputs at least as large as one that ran out of time are not attempted again
+        int timeoutSize = algorithms[i].history.timeoutSize;
+        if (benchmarkOptions.timeBudget > 0.0 && timeoutSize > 0 && n >= timeoutSize) {
+            markTimedOut(&algorithms[i], n);
+            printf("\n[%s] Skipped, N = %d already ran out of time", algorithms[i].name, timeoutSize);
+        } else if (benchmarkOptions.isIsolated) {
+            measureAlgorithmIsolated(&algorithms[i], &input, samples);
+        } else {
+            measureAlgorithm(&algorithms[i], &input, samples);
+        }
+        if (algorithms[i].status == RUN_OK) {
+            recordScaling(&algorithms[i].history, n, algorithms[i].time);
+        } else if (algorithms[i].status == RUN_INVALID) {
+            invalidRunsCount++;
+        }
+
+        // Append the elapsed time to results.csv
+        if (!benchmarkOptions.isBatch) {
+            appendStringToFile("results.csv", "%.9lf,", algorithms[i].time);
+        }
+    }
+    free(samples);
+    freeTypedArray(&input);
+    perfCountersClose();
+
+    printf("\nBenchmarks complete!");
+    if (!benchmarkOptions.isBatch) {
+        sleepProgram(3500);
+    }
+}
+void measureAlgorithm(SortingAlgorithm *algorithm, const TypedArray *input, double *samples) {
+    int n = input->n;
+    size_t size = n * elementTypes[input->type].size;
+
+    // The native keys go to the algorithm itself, the other types to its specialization
+    int typedSort = input->type == ELEMENT_U64 ? -1 : findTypedSort(algorithm, input->type);
+    void (*typedFunction)(void *, int) = typedSort >= 0 ? typedSorts[typedSort].function : NULL;
+
+    // Duplicate the data for each sorting algorithm
+    void *arrayCopy = allocateSampleBuffer(size);
+    memcpy(arrayCopy, input->data, size);
+    double frequency = getTimerFrequency();
+
+    printf("\n[%s] Sorting in progress...", algorithm->name);
+
+    // Warm-up runs are not timed, they only bring the code and data into the caches
+    for (int w = 0; w < benchmarkOptions.warmups; w++) {
+        sortElements(algorithm, typedFunction, arrayCopy, n, input->type);
+        memcpy(arrayCopy, input->data, size);
+    }
+
+    PerfReading counters;
+    memset(&counters, 0, sizeof(counters));
+    int isValid = 1;
+    #ifdef COUNT_OPERATIONS
+        // Only the timed repetitions are counted
+        atomic_store(&operationComparisons, 0);
+        atomic_store(&operationSwaps, 0);
+        atomic_store(&operationWrites, 0);
+    #endif
+    for (int r = 0; r < benchmarkOptions.repetitions; r++) {
+        // Every repetition sorts the original data, restored outside the timed region
+        if (r > 0) {
+            memcpy(arrayCopy, input->data, size);
+        }
+        if (benchmarkOptions.isColdCache) {
+            flushCaches();
+        }
+
+        // The counters are enabled around the timer so the ioctl calls are not timed
+        perfCountersStart();
+        // Start the timer
+        uint64_t startTicks = readTimer();
+        // Run the sorting algorithm
+        sortElements(algorithm, typedFunction, arrayCopy, n, input->type);
+        // End the timer
+        uint64_t endTicks = readTimer();
+        perfCountersStop(&counters);
+
+        // Calculate the elapsed time
+        samples[r] = (endTicks - startTicks) / frequency;
+
+        // Every repetition is checked, once its time is taken. One report per algorithm is enough.
+        if (isValid && !verifySorted(algorithm, input, arrayCopy)) {
+            isValid = 0;
+        }
+    }
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        counters.values[c] /= benchmarkOptions.repetitions;
+    }
+    // The counters follow the benchmark thread only, the pool workers would go uncounted
+    if (algorithm->isParallel && benchmarkOptions.threads > 1) {
+        memset(&counters, 0, sizeof(counters));
+    }
+    algorithm->counters = counters;
+    #ifdef COUNT_OPERATIONS
+        algorithm->operations.comparisons = atomic_load(&operationComparisons) / benchmarkOptions.repetitions;
+        algorithm->operations.swaps = atomic_load(&operationSwaps) / benchmarkOptions.repetitions;
+        algorithm->operations.writes = atomic_load(&operationWrites) / benchmarkOptions.repetitions;
+    #endif
+
+    // The statistics sort the samples, the results keep them in the order they were taken
+    if (algorithm->samples != NULL) {
+        memcpy(algorithm->samples, samples, benchmarkOptions.repetitions * sizeof(double));
+    }
+    algorithm->stats = computeBenchmarkStats(samples, benchmarkOptions.repetitions);
+    algorithm->time = algorithm->stats.median;
+    algorithm->throughput = algorithm->time > 0.0 ? input->bytes / algorithm->time : 0.0;
+    algorithm->status = isValid ? RUN_OK : RUN_INVALID;
+
+    printf("\n[%s] Sorting finished!", algorithm->name);
+    printf("\n[%s] Time taken: %.9lfsecs (%.1lf MB/s, %.2lf Mkeys/s)", algorithm->name, algorithm->time, algorithm->throughput / 1e6,
+        algorithm->time > 0.0 ? n / algorithm->time / 1e6 : 0.0);
+
+    // Clear and output the sorted data into a file per algorithm. Only the native keys are written.
+    if (input->type == ELEMENT_U64) {
+        writeSortedOutput(algorithm, (unsigned long int *)arrayCopy, n);
+    }
+
+    freeSampleBuffer(arrayCopy, size);
+}
+void sortElements(const SortingAlgorithm *algorithm, void (*typedFunction)(void *, int), void *data, int n, int type) {
+    if (elementTypes[type].directType >= 0) {
+        indirectSort(data, n, elementTypes[type].size, algorithm->function, benchmarkOptions.permuteMode);
+    } else if (typedFunction != NULL) {
+        typedFunction(data, n);
+    } else {
+        algorithm->function((unsigned long int *)data, n);
+    }
+}
+void convertKeys(unsigned long int *keys, int n, int type, TypedArray *typed) {
+    memset(typed, 0, sizeof(*typed));
+    typed->n = n;
+    typed->type = type;
+    typed->bytes = (size_t)n * elementTypes[type].size;
+    if (type == ELEMENT_U64) {
+        typed->data = keys;
+        typed->checksum = checksumElements(keys, n, type);
+        return;
+    }
+
+    typed->data = malloc(n > 0 ? typed->bytes : 1);
+    if (typed->data == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    typed->isDataOwned = 1;
+
+    switch (type) {
+        case ELEMENT_U32: {
+            uint32_t *elements = (uint32_t *)typed->data;
+            for (int i = 0; i < n; i++) {
+                elements[i] = (uint32_t)keys[i];
+            }
+            break;
+        }
+        case ELEMENT_F64: {
+            // Flipping the top bit and reading the key as signed keeps the order and gives negative values too
+            double *elements = (double *)typed->data;
+            for (int i = 0; i < n; i++) {
+                elements[i] = (double)(int64_t)((uint64_t)keys[i] ^ (1ULL << 63));
+            }
+            break;
+        }
+        case ELEMENT_RECORD16:
+        case ELEMENT_RECORD64:
+        case ELEMENT_RECORD256:
+        case ELEMENT_RECORD16_INDIRECT:
+        case ELEMENT_RECORD64_INDIRECT:
+        case ELEMENT_RECORD256_INDIRECT: {
+            // Every record type starts with its key, the payload is filled from the position
+            size_t size = elementTypes[type].size;
+            unsigned char *record = (unsigned char *)typed->data;
+            for (int i = 0; i < n; i++, record += size) {
+                uint64_t key = keys[i];
+                memcpy(record, &key, sizeof(key));
+                memset(record + sizeof(key), (unsigned char)i, size - sizeof(key));
+            }
+            break;
+        }
+        case ELEMENT_STRING: {
+            // The digits of every key, each string terminated, stored back to back
+            char **elements = (char **)typed->data;
+            typed->strings = (char *)malloc((size_t)n * 21 + 1);
+            if (typed->strings == NULL) {
+                perror("Memory allocation failed");
+                exit(EXIT_FAILURE);
+            }
+            char *next = typed->strings;
+            for (int i = 0; i < n; i++) {
+                elements[i] = next;
+                next += formatUnsignedLong(keys[i], next);
+                *next++ = '\0';
+            }
+            typed->bytes += next - typed->strings;
+            break;
+        }
+    }
+    typed->checksum = checksumElements(typed->data, n, type);
+}
+void freeTypedArray(TypedArray *typed) {
+    if (typed->isDataOwned) {
+        free(typed->data);
+    }
+    free(typed->strings);
+    memset(typed, 0, sizeof(*typed));
+}
+#ifdef SIMD_X86
+/**
+ * The vector scans of findUnsortedIndex() for native keys. Each compares a register of keys
+ * with the same keys shifted by one and stops at the first register with a descent.
+*/
+__attribute__((target("avx2")))
+int findDescentAvx2(const unsigned long int *array, int n) {
+    const __m256i signBits = _mm256_set1_epi64x(INT64_MIN);
+    int i = 0;
+    for (; i + 5 <= n; i += 4) {
+        __m256i current = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(array + i)), signBits);
+        __m256i next = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(array + i + 1)), signBits);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(current, next)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    for (; i + 1 < n; i++) {
+        if (array[i] > array[i + 1]) return i;
+    }
+    return -1;
+}
+__attribute__((target("avx512f")))
+int findDescentAvx512(const unsigned long int *array, int n) {
+    int i = 0;
+    for (; i + 9 <= n; i += 8) {
+        __mmask8 mask = _mm512_cmpgt_epu64_mask(_mm512_loadu_si512(array + i), _mm512_loadu_si512(array + i + 1));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    for (; i + 1 < n; i++) {
+        if (array[i] > array[i + 1]) return i;
+    }
+    return -1;
+}
+#endif
+uint64_t checksumElements(const void *data, int n, int type) {
+    uint64_t checksum = 0;
+    for (int i = 0; i < n; i++) {
+        // The hash of an element folds its bytes 8 at a time through the SplitMix64 finalizer
+        uint64_t hash = 0;
+        uint64_t word;
+        switch (type) {
+            case ELEMENT_U32:
+                hash = ((const uint32_t *)data)[i];
+                break;
+            case ELEMENT_U64:
+                hash = ((const unsigned long int *)data)[i];
+                break;
+            case ELEMENT_F64:
+                memcpy(&hash, (const double *)data + i, sizeof(hash));
+                break;
+            case ELEMENT_RECORD16:
+            case ELEMENT_RECORD64:
+            case ELEMENT_RECORD256:
+            case ELEMENT_RECORD16_INDIRECT:
+            case ELEMENT_RECORD64_INDIRECT:
+            case ELEMENT_RECORD256_INDIRECT: {
+                size_t size = elementTypes[type].size;
+                const unsigned char *record = (const unsigned char *)data + i * size;
+                for (size_t offset = 0; offset < size; offset += sizeof(word)) {
+                    memcpy(&word, record + offset, sizeof(word));
+                    hash ^= word;
+                    hash = splitMix64(&hash);
+                }
+                break;
+            }
+            case ELEMENT_STRING: {
+                const char *string = ((char * const *)data)[i];
+                size_t length = strlen(string);
+                for (size_t offset = 0; offset < length; offset += sizeof(word)) {
+                    word = 0;
+                    memcpy(&word, string + offset, length - offset < sizeof(word) ? length - offset : sizeof(word));
+                    hash ^= word;
+                    hash = splitMix64(&hash);
+                }
+                hash ^= length;
+                break;
+            }
+        }
+        checksum += splitMix64(&hash);
+    }
+    return checksum;
+}
+int findUnsortedIndex(const void *data, int n, int type) {
+    switch (type) {
+        case ELEMENT_U32: {
+            const uint32_t *elements = (const uint32_t *)data;
+            for (int i = 0; i + 1 < n; i++) {
+                if (elements[i] > elements[i + 1]) return i;
+            }
+            return -1;
+        }
+        case ELEMENT_U64: {
+            const unsigned long int *elements = (const unsigned long int *)data;
+            #ifdef SIMD_X86
+                int simdLevel = getSimdLevel();
+                if (simdLevel == SIMD_AVX512) {
+                    return findDescentAvx512(elements, n);
+                }
+                if (simdLevel == SIMD_AVX2) {
+                    return findDescentAvx2(elements, n);
+                }
+            #endif
+            for (int i = 0; i + 1 < n; i++) {
+                if (elements[i] > elements[i + 1]) return i;
+            }
+            return -1;
+        }
+        case ELEMENT_F64: {
+            const double *elements = (const double *)data;
+            for (int i = 0; i + 1 < n; i++) {
+                if (elements[i] > elements[i + 1]) return i;
+            }
+            return -1;
+        }
+        case ELEMENT_RECORD16:
+        case ELEMENT_RECORD64:
+        case ELEMENT_RECORD256:
+        case ELEMENT_RECORD16_INDIRECT:
+        case ELEMENT_RECORD64_INDIRECT:
+        case ELEMENT_RECORD256_INDIRECT: {
+            // Every record type starts with its key
+            size_t size = elementTypes[type].size;
+            const unsigned char *record = (const unsigned char *)data;
+            uint64_t key, nextKey;
+            for (int i = 0; i + 1 < n; i++, record += size) {
+                memcpy(&key, record, sizeof(key));
+                memcpy(&nextKey, record + size, sizeof(nextKey));
+                if (key > nextKey) return i;
+            }
+            return -1;
+        }
+        case ELEMENT_STRING: {
+            char * const *elements = (char * const *)data;
+            for (int i = 0; i + 1 < n; i++) {
+                if (strcmp(elements[i], elements[i + 1]) > 0) return i;
+            }
+            return -1;
+        }
+    }
+    return -1;
+}
+int verifySorted(const SortingAlgorithm *algorithm, const TypedArray *input, const void *sorted) {
+    int unsortedIndex = findUnsortedIndex(sorted, input->n, input->type);
+    if (unsortedIndex >= 0) {
+        fprintf(stderr, "\n[%s] VERIFICATION FAILED: element %d is greater than element %d (N = %d, %s)\n",
+            algorithm->name, unsortedIndex, unsortedIndex + 1, input->n, elementTypes[input->type].key);
+        return 0;
+    }
+    if (checksumElements(sorted, input->n, input->type) != input->checksum) {
+        fprintf(stderr, "\n[%s] VERIFICATION FAILED: the output is ordered but its elements differ from the input (N = %d, %s)\n",
+            algorithm->name, input->n, elementTypes[input->type].key);
+        return 0;
+    }
+    return 1;
+}
+int findTypedSort(const SortingAlgorithm *algorithm, int type) {
+    for (int t = 0; t < typedSortsSize; t++) {
+        size_t keyLength = strlen(typedSorts[t].algorithmKey);
+        if (typedSorts[t].type == type && strncmp(algorithm->outputFile, typedSorts[t].algorithmKey, keyLength) == 0
+            && algorithm->outputFile[keyLength] == '.') {
+            return t;
+        }
+    }
+    return -1;
+}
+int isTypeSupported(const SortingAlgorithm *algorithm, int type) {
+    return type == ELEMENT_U64 || elementTypes[type].directType >= 0 || findTypedSort(algorithm, type) >= 0;
+}
+BenchmarkStats computeBenchmarkStats(double *samples, int count) {
+    BenchmarkStats stats = {0};
+    if (count <= 0) return stats;
+
+    qsort(samples, count, sizeof(double), compareDoubles);
+    stats.samples = count;
+    stats.min = samples[0];
+    if (count % 2 == 1) {
+        stats.median = samples[count / 2];
+    } else {
+        stats.median = (samples[count / 2 - 1] + samples[count / 2]) / 2.0;
+    }
+
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) {
+        sum += samples[i];
+    }
+    stats.mean = sum / count;
+
+    // Sample standard deviation, zero for a single run
+    if (count > 1) {
+        double squares = 0.0;
+        for (int i = 0; i < count; i++) {
+            double deviation = samples[i] - stats.mean;
+            squares += deviation * deviation;
+        }
+        stats.stddev = sqrt(squares / (count - 1));
+    }
+
+    // Nearest-rank percentile: the smallest sample with at least 95% of samples at or below it
+    int rank = (95 * count + 99) / 100;
+    stats.p95 = samples[rank - 1];
+    return stats;
+}
+
+/*
+*
+* PROCESS ISOLATION
+*
+*/
+void measureAlgorithmIsolated(SortingAlgorithm *algorithm, const TypedArray *input, double *samples) {
+    #ifdef _WIN32
+        printf("\n[%s] Process isolation is unavailable on Windows, running in-process", algorithm->name);
+        measureAlgorithm(algorithm, input, samples);
+    #else
+        int n = input->n;
+        int channel[2];
+        if (pipe(channel) != 0) {
+            perror("Pipe creation failed");
+            exit(EXIT_FAILURE);
+        }
+
+        // The samples can outgrow the pipe buffer, which the parent only reads once the child exited
+        size_t samplesSize = benchmarkOptions.repetitions * sizeof(double);
+        double *sharedSamples = (double *)mmap(NULL, samplesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (sharedSamples == MAP_FAILED) {
+            perror("Memory allocation failed");
+            exit(EXIT_FAILURE);
+        }
+
+        // Anything still buffered would otherwise be printed by both processes
+        fflush(stdout);
+        fflush(stderr);
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("Fork failed");
+            exit(EXIT_FAILURE);
+        }
+
+        if (pid == 0) {
+            close(channel[0]);
+
+            // The pool workers and the counters belong to the parent, the child starts its own
+            taskPool = NULL;
+            getTaskPool();
+            for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+                perfCounterFds[c] = -1;
+            }
+            if (benchmarkOptions.usePerfCounters) {
+                perfCountersOpen();
+            }
+
+            // The resident size inherited from the parent is sent first, so it arrives even on a timeout
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            long startRss = usage.ru_maxrss;
+            int isWritten = write(channel[1], &startRss, sizeof(startRss)) == sizeof(startRss);
+
+            measureAlgorithm(algorithm, input, samples);
+            if (algorithm->samples != NULL) {
+                memcpy(sharedSamples, algorithm->samples, samplesSize);
+            }
+            isWritten = isWritten && write(channel[1], algorithm, sizeof(*algorithm)) == sizeof(*algorithm);
+            fflush(stdout);
+            _exit(isWritten ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        close(channel[1]);
+
+        // Poll the child so it can be killed as soon as the budget is spent
+        double startTime = getTimeInSeconds();
+        struct rusage usage;
+        memset(&usage, 0, sizeof(usage));
+        int status = 0;
+        int isTimedOut = 0;
+        while (wait4(pid, &status, WNOHANG, &usage) == 0) {
+            if (benchmarkOptions.timeBudget > 0.0 && getTimeInSeconds() - startTime > benchmarkOptions.timeBudget) {
+                kill(pid, SIGKILL);
+                wait4(pid, &status, 0, &usage);
+                isTimedOut = 1;
+                break;
+            }
+            sleepProgram(1);
+        }
+
+        // The pipe holds everything the child wrote, and reads no longer block once it exited
+        long startRss = 0;
+        int hasStart = read(channel[0], &startRss, sizeof(startRss)) == sizeof(startRss);
+        SortingAlgorithm result;
+        int hasResult = !isTimedOut && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS
+            && read(channel[0], &result, sizeof(result)) == sizeof(result);
+        close(channel[0]);
+
+        if (hasResult) {
+            algorithm->stats = result.stats;
+            algorithm->time = result.time;
+            algorithm->counters = result.counters;
+            algorithm->operations = result.operations;
+            algorithm->throughput = result.throughput;
+            algorithm->status = result.status;
+            if (algorithm->samples != NULL) {
+                memcpy(algorithm->samples, sharedSamples, samplesSize);
+            }
+        } else if (isTimedOut) {
+            printf("\n[%s] Killed after the %.3lfsecs time budget", algorithm->name, benchmarkOptions.timeBudget);
+            algorithm->history.timeoutSize = n;
+            markTimedOut(algorithm, n);
+        } else {
+            memset(&algorithm->stats, 0, sizeof(algorithm->stats));
+            algorithm->time = 0.0;
+            algorithm->throughput = 0.0;
+            algorithm->status = RUN_FAILED;
+            printf("\n[%s] The child process failed", algorithm->name);
+        }
+
+        munmap(sharedSamples, samplesSize);
+
+        // ru_maxrss is in KB on Linux and in bytes on macOS
+        long scale = 1;
+        #ifdef __APPLE__
+            scale = 1024;
+        #endif
+        algorithm->memory.isAvailable = 1;
+        algorithm->memory.peakRss = usage.ru_maxrss / scale;
+        algorithm->memory.peakRssGrowth = hasStart ? (usage.ru_maxrss - startRss) / scale : 0;
+        algorithm->memory.minorFaults = usage.ru_minflt;
+        algorithm->memory.majorFaults = usage.ru_majflt;
+    #endif
+}
+void markTimedOut(SortingAlgorithm *algorithm, int n) {
+    memset(&algorithm->stats, 0, sizeof(algorithm->stats));
+    memset(&algorithm->counters, 0, sizeof(algorithm->counters));
+    memset(&algorithm->operations, 0, sizeof(algorithm->operations));
+    algorithm->status = RUN_TIMEOUT;
+    algorithm->throughput = 0.0;
+
+    // The run took at least the budget, whatever the fit says
+    algorithm->estimate = extrapolateTime(&algorithm->history, n);
+    if (algorithm->estimate > 0.0 && algorithm->estimate < benchmarkOptions.timeBudget) {
+        algorithm->estimate = benchmarkOptions.timeBudget;
+    }
+    algorithm->time = algorithm->estimate > 0.0 ? algorithm->estimate : benchmarkOptions.timeBudget;
+    if (algorithm->estimate > 0.0) {
+        printf("\n[%s] Timeout, estimated %.3lfsecs from smaller N", algorithm->name, algorithm->estimate);
+    }
+}
+void recordScaling(ScalingHistory *history, int n, double time) {
+    if (history->count > 0 && history->sizes[history->count - 1] == n) {
+        history->times[history->count - 1] = time;
+    } else if (history->count < 2) {
+        if (history->count == 1 && n < history->sizes[0]) {
+            history->sizes[1] = history->sizes[0];
+            history->times[1] = history->times[0];
+            history->sizes[0] = n;
+            history->times[0] = time;
+        } else {
+            history->sizes[history->count] = n;
+            history->times[history->count] = time;
+        }
+        history->count++;
+    } else if (n > history->sizes[1]) {
+        history->sizes[0] = history->sizes[1];
+        history->times[0] = history->times[1];
+        history->sizes[1] = n;
+        history->times[1] = time;
+    } else if (n > history->sizes[0]) {
+        history->sizes[0] = n;
+        history->times[0] = time;
+    }
+}
+double extrapolateTime(const ScalingHistory *history, int n) {
+    if (history->count < 2 || history->times[0] <= 0.0 || history->times[1] <= 0.0) {
+        return 0.0;
+    }
+
+    // Small timings are noisy, so the exponent is kept at least linear
+    double exponent = log(history->times[1] / history->times[0]) / log((double)history->sizes[1] / history->sizes[0]);
+    if (exponent < 1.0) exponent = 1.0;
+    return history->times[1] * pow((double)n / history->sizes[1], exponent);
+}
+void resetScalingHistory(void) {
+    for (int i = 0; i < algorithmsSize; i++) {
+        memset(&algorithms[i].history, 0, sizeof(algorithms[i].history));
+    }
+}
+void displayMemoryUsage(void) {
+    printf("\n-------------------------------------------------------------------------------------");
+    printf("\n|       Algorithm      | Peak RSS (MB) | RSS growth (MB) | Minor faults | Major faults |");
+    printf("\n-------------------------------------------------------------------------------------");
+    for (int i = 0; i < algorithmsSize; i++) {
+        if (algorithms[i].isSkipped || !algorithms[i].memory.isAvailable) continue;
+        MemoryUsage *memory = &algorithms[i].memory;
+        printf("\n| %20s | %13.1lf | %15.1lf | %12ld | %12ld |", algorithms[i].name,
+            memory->peakRss / 1024.0, memory->peakRssGrowth / 1024.0, memory->minorFaults, memory->majorFaults);
+    }
+    printf("\n-------------------------------------------------------------------------------------");
+}
+
+/*
+*
+* BATCH MODE
+*
+*/
+int runBatchFromArguments(int argc, char *argv[]) {
+    BatchConfig config;
+    memset(&config, 0, sizeof(config));
+    strcpy(config.resultsFile, "batch-results.csv");
+    strcpy(config.jsonFile, "batch-results.jsonl");
+    config.compareThreshold = DEFAULT_COMPARE_THRESHOLD;
+    strcpy(config.profileFile, DEFAULT_PROFILE_FILE);
+
+    // The tuned cutoffs of this machine apply unless the options override them
+    loadCutoffProfile(&config, config.profileFile);
+    strcpy(config.externalOutput, "external-sorted.bin");
+    config.externalAlgorithm = findAlgorithmByKey("quick-sort");
+    config.memoryLimit = 256;
+    config.fanIn = 64;
+
+    // Batch runs are unattended and do not write the sorted arrays by default
+    benchmarkOptions.isBatch = 1;
+    benchmarkOptions.outputFormat = OUTPUT_NONE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            displayBatchUsage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+        if (strncmp(argv[i], "--", 2) != 0) {
+            fprintf(stderr, "Unexpected argument: %s\n", argv[i]);
+            displayBatchUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        // Options are either --key=value, --key value or a --flag
+        char key[MAX_CONFIG_LINE];
+        const char *value = NULL;
+        const char *equals = strchr(argv[i], '=');
+        if (equals != NULL) {
+            snprintf(key, sizeof(key), "%.*s", (int)(equals - argv[i] - 2), argv[i] + 2);
+            value = equals + 1;
+        } else {
+            snprintf(key, sizeof(key), "%s", argv[i] + 2);
+            if (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) {
+                value = argv[++i];
+            }
+        }
+
+        int isValid;
+        if (strcmp(key, "config") == 0) {
+            isValid = value != NULL && loadBatchConfigFile(&config, value);
+        } else {
+            isValid = applyBatchOption(&config, key, value);
+        }
+        if (!isValid) {
+            displayBatchUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The self-test has its own size and thread counts
+    if (config.isSelfTesting) {
+        return runSelfTest(&config);
+    }
+
+    // Fall back to sensible defaults for whatever was not configured
+    if (config.sizesCount == 0 && config.inputFile[0] == '\0') {
+        config.sizes[config.sizesCount++] = 10000;
+    }
+    if (config.generatorsCount == 0) {
+        // The random and increasing methods, the sweep before the others were added
+        config.generators[config.generatorsCount++] = 0;
+        config.generators[config.generatorsCount++] = 1;
+    }
+    if (config.threadCountsCount == 0) {
+        config.threadCounts[config.threadCountsCount++] = benchmarkOptions.threads;
+    }
+    if (config.typesCount == 0) {
+        config.types[config.typesCount++] = ELEMENT_U64;
+    }
+
+    if (config.externalInput[0] != '\0') {
+        return runExternalSort(&config);
+    }
+    if (config.isTuning) {
+        return runTuning(&config);
+    }
+
+    if (config.compareBase[0] != '\0') {
+        // The results of this configuration are the candidate unless another file is given
+        if (config.compareCandidate[0] == '\0') {
+            snprintf(config.compareCandidate, sizeof(config.compareCandidate), "%s", config.jsonFile);
+        }
+        return compareResults(&config);
+    }
+
+    runBatch(&config);
+    if (invalidRunsCount > 0) {
+        fprintf(stderr, "\n%d benchmark(s) produced invalid output\n", invalidRunsCount);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+int applyBatchOption(BatchConfig *config, const char *key, const char *value) {
+    if (strcmp(key, "write-output") == 0) {
+        benchmarkOptions.outputFormat = OUTPUT_TEXT;
+        return 1;
+    }
+    if (strcmp(key, "perf") == 0) {
+        benchmarkOptions.usePerfCounters = 1;
+        return 1;
+    }
+    if (strcmp(key, "tune") == 0) {
+        config->isTuning = 1;
+        return 1;
+    }
+    if (strcmp(key, "analyze") == 0) {
+        config->isAnalyzing = 1;
+        return 1;
+    }
+    if (strcmp(key, "self-test") == 0) {
+        config->isSelfTesting = 1;
+        return 1;
+    }
+    if (strcmp(key, "huge-pages") == 0) {
+        benchmarkOptions.useHugePages = 1;
+        return 1;
+    }
+    if (strcmp(key, "prefault") == 0) {
+        benchmarkOptions.isPrefaulting = 1;
+        return 1;
+    }
+    if (strcmp(key, "cold-cache") == 0) {
+        benchmarkOptions.isColdCache = 1;
+        return 1;
+    }
+    if (strcmp(key, "isolate") == 0) {
+        benchmarkOptions.isIsolated = 1;
+        return 1;
+    }
+    if (value == NULL || *value == '\0') {
+        fprintf(stderr, "Missing value for option: %s\n", key);
+        return 0;
+    }
+
+    if (strcmp(key, "sizes") == 0) {
+        // Comma-separated list, scientific notation such as 1e6 is accepted
+        char list[MAX_CONFIG_LINE];
+        snprintf(list, sizeof(list), "%s", value);
+        config->sizesCount = 0;
+        for (char *token = strtok(list, ","); token != NULL; token = strtok(NULL, ",")) {
+            char *end;
+            double size = strtod(token, &end);
+            if (end == token || size < 1 || size > INT_MAX) {
+                fprintf(stderr, "Invalid size: %s\n", token);
+                return 0;
+            }
+            if (config->sizesCount == MAX_BATCH_SIZES) {
+                fprintf(stderr, "At most %d sizes are supported\n", MAX_BATCH_SIZES);
+                return 0;
+            }
+            config->sizes[config->sizesCount++] = (int)size;
+        }
+    } else if (strcmp(key, "generators") == 0) {
+        char list[MAX_CONFIG_LINE];
+        snprintf(list, sizeof(list), "%s", value);
+        config->generatorsCount = 0;
+        for (char *token = strtok(list, ","); token != NULL; token = strtok(NULL, ",")) {
+            if (strcmp(token, "all") == 0) {
+                for (int i = 0; i < dataGeneratorsSize && config->generatorsCount < MAX_BATCH_GENERATORS; i++) {
+                    config->generators[config->generatorsCount++] = i;
+                }
+                continue;
+            }
+            int method = -1;
+            for (int i = 0; i < dataGeneratorsSize; i++) {
+                if (strcmp(token, dataGenerators[i].key) == 0) method = i;
+            }
+            if (method < 0 || config->generatorsCount == MAX_BATCH_GENERATORS) {
+                fprintf(stderr, "Invalid generator: %s\n", token);
+                return 0;
+            }
+            config->generators[config->generatorsCount++] = method;
+        }
+    } else if (strcmp(key, "types") == 0) {
+        char list[MAX_CONFIG_LINE];
+        snprintf(list, sizeof(list), "%s", value);
+        config->typesCount = 0;
+        for (char *token = strtok(list, ","); token != NULL; token = strtok(NULL, ",")) {
+            if (strcmp(token, "all") == 0) {
+                for (int i = 0; i < ELEMENT_TYPE_COUNT && config->typesCount < ELEMENT_TYPE_COUNT; i++) {
+                    config->types[config->typesCount++] = i;
+                }
+                continue;
+            }
+            int type = -1;
+            for (int i = 0; i < ELEMENT_TYPE_COUNT; i++) {
+                if (strcmp(token, elementTypes[i].key) == 0) type = i;
+            }
+            if (type < 0 || config->typesCount == ELEMENT_TYPE_COUNT) {
+                fprintf(stderr, "Invalid element type: %s\n", token);
+                return 0;
+            }
+            config->types[config->typesCount++] = type;
+        }
+    } else if (strcmp(key, "algorithms") == 0) {
+        char list[MAX_CONFIG_LINE];
+        snprintf(list, sizeof(list), "%s", value);
+        for (int i = 0; i < algorithmsSize; i++) {
+            algorithms[i].isSkipped = 1;
+        }
+        for (char *token = strtok(list, ","); token != NULL; token = strtok(NULL, ",")) {
+            if (strcmp(token, "all") == 0) {
+                for (int i = 0; i < algorithmsSize; i++) {
+                    algorithms[i].isSkipped = 0;
+                }
+                continue;
+            }
+            int index = findAlgorithmByKey(token);
+            if (index < 0) {
+                fprintf(stderr, "Invalid algorithm: %s\n", token);
+                return 0;
+            }
+            algorithms[index].isSkipped = 0;
+        }
+    } else if (strcmp(key, "repeat") == 0) {
+        benchmarkOptions.repetitions = atoi(value);
+        if (benchmarkOptions.repetitions < 1) {
+            fprintf(stderr, "Invalid repetition count: %s\n", value);
+            return 0;
+        }
+    } else if (strcmp(key, "warmup") == 0) {
+        benchmarkOptions.warmups = atoi(value);
+        if (benchmarkOptions.warmups < 0) {
+            fprintf(stderr, "Invalid warm-up count: %s\n", value);
+            return 0;
+        }
+    } else if (strcmp(key, "threads") == 0) {
+        char list[MAX_CONFIG_LINE];
+        snprintf(list, sizeof(list), "%s", value);
+        config->threadCountsCount = 0;
+        for (char *token = strtok(list, ","); token != NULL; token = strtok(NULL, ",")) {
+            // A range such as 1-8 expands to every count in between
+            int first = 0, last = 0;
+            int fields = sscanf(token, "%d-%d", &first, &last);
+            if (fields == 1) last = first;
+            if (fields < 1 || first < 1 || last < first) {
+                fprintf(stderr, "Invalid thread count: %s\n", token);
+                return 0;
+            }
+            for (int t = first; t <= last; t++) {
+                if (config->threadCountsCount == MAX_BATCH_THREADS) {
+                    fprintf(stderr, "At most %d thread counts are supported\n", MAX_BATCH_THREADS);
+                    return 0;
+                }
+                config->threadCounts[config->threadCountsCount++] = t;
+            }
+        }
+    } else if (strcmp(key, "time-budget") == 0) {
+        // Only an isolated run can be stopped, so a budget implies isolation
+        benchmarkOptions.timeBudget = strtod(value, NULL);
+        if (!(benchmarkOptions.timeBudget > 0.0)) {
+            fprintf(stderr, "Invalid time budget: %s\n", value);
+            return 0;
+        }
+        benchmarkOptions.isIsolated = 1;
+    } else if (strcmp(key, "pin") == 0) {
+        char *end;
+        long processor = strtol(value, &end, 10);
+        const int *processors;
+        int processorCount = getAllowedProcessors(&processors);
+        int isAllowed = 0;
+        for (int p = 0; p < processorCount && end != value && *end == '\0'; p++) {
+            isAllowed |= processors[p] == processor;
+        }
+        if (!isAllowed) {
+            fprintf(stderr, "Invalid processor: %s, the process may run on %d processor(s) from %d to %d\n", value,
+                processorCount, processors[0], processors[processorCount - 1]);
+            return 0;
+        }
+        benchmarkOptions.pinProcessor = (int)processor;
+    } else if (strcmp(key, "affinity") == 0) {
+        int affinity = -1;
+        for (int i = 0; i < (int)(sizeof(affinityNames) / sizeof(affinityNames[0])); i++) {
+            if (strcmp(value, affinityNames[i]) == 0) affinity = i;
+        }
+        if (affinity < 0) {
+            fprintf(stderr, "Invalid affinity: %s\n", value);
+            return 0;
+        }
+        benchmarkOptions.affinity = affinity;
+    } else if (strcmp(key, "permute") == 0) {
+        if (strcmp(value, "gather") == 0) {
+            benchmarkOptions.permuteMode = PERMUTE_GATHER;
+        } else if (strcmp(value, "cycles") == 0) {
+            benchmarkOptions.permuteMode = PERMUTE_CYCLES;
+        } else {
+            fprintf(stderr, "Invalid permutation mode: %s\n", value);
+            return 0;
+        }
+    } else if (strcmp(key, "simd") == 0) {
+        if (strcmp(value, "none") == 0) {
+            benchmarkOptions.simdLevel = SIMD_NONE;
+        } else if (strcmp(value, "avx2") == 0) {
+            benchmarkOptions.simdLevel = SIMD_AVX2;
+        } else if (strcmp(value, "avx512") == 0 || strcmp(value, "auto") == 0) {
+            benchmarkOptions.simdLevel = SIMD_AVX512;
+        } else {
+            fprintf(stderr, "Invalid instruction set: %s\n", value);
+            return 0;
+        }
+    } else if (strcmp(key, "grain") == 0 || strcmp(key, "quick-sort-cutoff") == 0 || strcmp(key, "radix-cutoff") == 0
+        || strcmp(key, "vector-leaf") == 0) {
+        for (int i = 0; i < tunableCutoffsSize; i++) {
+            if (strcmp(key, tunableCutoffs[i].key) != 0) continue;
+            int cutoff = atoi(value);
+            if (cutoff < tunableCutoffs[i].minimum || cutoff > tunableCutoffs[i].maximum) {
+                fprintf(stderr, "Invalid %s: %s\n", key, value);
+                return 0;
+            }
+            *tunableCutoffs[i].value = cutoff;
+        }
+    } else if (strcmp(key, "profile") == 0) {
+        snprintf(config->profileFile, sizeof(config->profileFile), "%s", value);
+        loadCutoffProfile(config, config->profileFile);
+    } else if (strcmp(key, "output") == 0) {
+        if (strcmp(value, "none") == 0) {
+            benchmarkOptions.outputFormat = OUTPUT_NONE;
+        } else if (strcmp(value, "text") == 0) {
+            benchmarkOptions.outputFormat = OUTPUT_TEXT;
+        } else if (strcmp(value, "binary") == 0) {
+            benchmarkOptions.outputFormat = OUTPUT_BINARY;
+        } else {
+            fprintf(stderr, "Invalid output format: %s\n", value);
+            return 0;
+        }
+    } else if (strcmp(key, "start") == 0) {
+        generatorOptions.startingValue = strtoul(value, NULL, 10);
+    } else if (strcmp(key, "seed") == 0) {
+        char *end;
+        generatorOptions.seed = strtoull(value, &end, 0);
+        if (end == value || *end != '\0') {
+            fprintf(stderr, "Invalid seed: %s\n", value);
+            return 0;
+        }
+    } else if (strcmp(key, "swaps") == 0) {
+        generatorOptions.swaps = atoi(value);
+        if (generatorOptions.swaps < 0) {
+            fprintf(stderr, "Invalid swap count: %s\n", value);
+            return 0;
+        }
+    } else if (strcmp(key, "unique") == 0) {
+        generatorOptions.uniqueCount = atoi(value);
+        if (generatorOptions.uniqueCount < 1) {
+            fprintf(stderr, "Invalid unique key count: %s\n", value);
+            return 0;
+        }
+    } else if (strcmp(key, "zipf") == 0) {
+        generatorOptions.zipfExponent = strtod(value, NULL);
+        if (!(generatorOptions.zipfExponent > 0.0)) {
+            fprintf(stderr, "Invalid Zipf exponent: %s\n", value);
+            return 0;
+        }
+    } else if (strcmp(key, "run-length") == 0) {
+        generatorOptions.runLength = atoi(value);
+        if (generatorOptions.runLength < 1) {
+            fprintf(stderr, "Invalid run length: %s\n", value);
+            return 0;
+        }
+    } else if (strcmp(key, "external") == 0) {
+        snprintf(config->externalInput, sizeof(config->externalInput), "%s", value);
+    } else if (strcmp(key, "external-output") == 0) {
+        snprintf(config->externalOutput, sizeof(config->externalOutput), "%s", value);
+    } else if (strcmp(key, "chunk-algorithm") == 0) {
+        config->externalAlgorithm = findAlgorithmByKey(value);
+        if (config->externalAlgorithm < 0) {
+            fprintf(stderr, "Invalid algorithm: %s\n", value);
+            return 0;
+        }
+    } else if (strcmp(key, "memory") == 0) {
+        config->memoryLimit = atoi(value);
+        if (config->memoryLimit < 1) {
+            fprintf(stderr, "Invalid memory limit: %s\n", value);
+            return 0;
+        }
+    } else if (strcmp(key, "fan-in") == 0) {
+        config->fanIn = atoi(value);
+        if (config->fanIn < 2) {
+            fprintf(stderr, "Invalid fan-in: %s\n", value);
+            return 0;
+        }
+    } else if (strcmp(key, "input") == 0) {
+        snprintf(config->inputFile, sizeof(config->inputFile), "%s", value);
+    } else if (strcmp(key, "results") == 0) {
+        snprintf(config->resultsFile, sizeof(config->resultsFile), "%s", value);
+    } else if (strcmp(key, "json") == 0) {
+        snprintf(config->jsonFile, sizeof(config->jsonFile), "%s", value);
+    } else if (strcmp(key, "compare") == 0) {
+        snprintf(config->compareBase, sizeof(config->compareBase), "%s", value);
+    } else if (strcmp(key, "compare-to") == 0) {
+        snprintf(config->compareCandidate, sizeof(config->compareCandidate), "%s", value);
+    } else if (strcmp(key, "select") == 0) {
+        char list[MAX_CONFIG_LINE];
+        snprintf(list, sizeof(list), "%s", value);
+        config->selectionsCount = 0;
+        for (char *token = strtok(list, ","); token != NULL; token = strtok(NULL, ",")) {
+            char *end;
+            double selection = strtod(token, &end);
+            if (end == token || !(selection > 0.0) || selection > INT_MAX) {
+                fprintf(stderr, "Invalid k: %s\n", token);
+                return 0;
+            }
+            if (config->selectionsCount == MAX_BATCH_SELECTIONS) {
+                fprintf(stderr, "At most %d values of k are supported\n", MAX_BATCH_SELECTIONS);
+                return 0;
+            }
+            config->selections[config->selectionsCount++] = selection;
+        }
+    } else if (strcmp(key, "threshold") == 0) {
+        config->compareThreshold = strtod(value, NULL);
+        if (!(config->compareThreshold >= 0.0)) {
+            fprintf(stderr, "Invalid threshold: %s\n", value);
+            return 0;
+        }
+    } else {
+        fprintf(stderr, "Unknown option: %s\n", key);
+        return 0;
+    }
+    return 1;
+}
+int loadBatchConfigFile(BatchConfig *config, const char *filename) {
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file: %s\n", filename);
+        return 0;
+    }
+
+    char line[MAX_CONFIG_LINE];
+    int lineNumber = 0;
+    int isValid = 1;
+    while (isValid && fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+
+        // Trim the line and skip blanks and comments
+        char *key = line;
+        while (isspace((unsigned char)*key)) key++;
+        char *end = key + strlen(key);
+        while (end > key && isspace((unsigned char)end[-1])) *--end = '\0';
+        if (*key == '\0' || *key == '#') continue;
+
+        // Split "key = value", a line without '=' is a flag
+        char *value = strchr(key, '=');
+        if (value != NULL) {
+            char *keyEnd = value;
+            *value++ = '\0';
+            while (keyEnd > key && isspace((unsigned char)keyEnd[-1])) *--keyEnd = '\0';
+            while (isspace((unsigned char)*value)) value++;
+        }
+
+        isValid = applyBatchOption(config, key, value);
+        if (!isValid) {
+            fprintf(stderr, "%s:%d: invalid line\n", filename, lineNumber);
+        }
+    }
+
+    fclose(file);
+    return isValid;
+}
+void runBatch(const BatchConfig *config) {
+    // Write the header once so the file can be appended to across runs
+    FILE *existing = fopen(config->resultsFile, "r");
+    if (existing == NULL) {
+        appendStringToFile(config->resultsFile, "n,generator,seed,element_type,algorithm,threads,repetitions,warmups,min,median,mean,stddev,p95,speedup,efficiency,"
+            "cycles,instructions,ipc,branch_misses_per_element,l1d_misses_per_element,llc_misses_per_element,dtlb_misses_per_element,"
+            "status,estimated_time,peak_rss_kb,peak_rss_growth_kb,minor_faults,major_faults,bytes_per_second,keys_per_second,pass_bytes,permuted_bytes,"
+            "direct_over_indirect\n");
+    } else {
+        fclose(existing);
+    }
+
+    // The median of every algorithm at every size of the current sweep, for --analyze
+    double *sweepTimes = (double *)calloc((size_t)algorithmsSize * MAX_BATCH_SIZES, sizeof(double));
+    if (sweepTimes == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // A saved dataset replaces the generators. Each N benchmarks a prefix of it.
+    if (config->inputFile[0] != '\0') {
+        LoadedDataset dataset;
+        printf("\n\nLoading %s...", config->inputFile);
+        double startTime = getTimeInSeconds();
+        if (!loadDataset(config->inputFile, &dataset)) {
+            free(sweepTimes);
+            return;
+        }
+        double loadTime = getTimeInSeconds() - startTime;
+        printf("\nLoaded %d keys in %.6lfsecs (%.1lf MB/s)", dataset.n, loadTime,
+            loadTime > 0.0 ? dataset.fileSize / loadTime / 1e6 : 0.0);
+
+        char source[FILENAME_MAX + 8];
+        snprintf(source, sizeof(source), "file:%s", config->inputFile);
+        int sizesCount = config->sizesCount > 0 ? config->sizesCount : 1;
+        for (int t = 0; t < config->typesCount; t++) {
+            benchmarkOptions.elementType = config->types[t];
+            resetScalingHistory();
+            memset(sweepTimes, 0, (size_t)algorithmsSize * MAX_BATCH_SIZES * sizeof(double));
+            for (int s = 0; s < sizesCount; s++) {
+                int n = config->sizesCount > 0 ? config->sizes[s] : dataset.n;
+                if (n > dataset.n) {
+                    printf("\nSkipping N = %d, the dataset only has %d keys", n, dataset.n);
+                    continue;
+                }
+                printf("\n\n%s | N = %d | %s", config->inputFile, n, elementTypes[benchmarkOptions.elementType].name);
+                runBatchCell(config, source, "", dataset.keys, n);
+                recordSweepTimes(sweepTimes, s);
+            }
+            if (config->isAnalyzing && config->sizesCount > 1) {
+                char label[RUN_NAME_SIZE + 32];
+                snprintf(label, sizeof(label), "%s, %s", source, elementTypes[benchmarkOptions.elementType].key);
+                analyzeSweep(label, config->sizes, config->sizesCount, sweepTimes);
+            }
+        }
+        freeDataset(&dataset);
+        free(sweepTimes);
+        printf("\n\nResults appended to %s\n", config->resultsFile);
+        return;
+    }
+
+    char seed[32];
+    snprintf(seed, sizeof(seed), "%llu", (unsigned long long)generatorOptions.seed);
+    for (int g = 0; g < config->generatorsCount; g++) {
+        int method = config->generators[g];
+        for (int t = 0; t < config->typesCount; t++) {
+            benchmarkOptions.elementType = config->types[t];
+            // Timings on one distribution or element type say little about another
+            resetScalingHistory();
+            memset(sweepTimes, 0, (size_t)algorithmsSize * MAX_BATCH_SIZES * sizeof(double));
+            for (int s = 0; s < config->sizesCount; s++) {
+                int n = config->sizes[s];
+
+                printf("\n\n%s | N = %d | Seed: %s | %s", dataGenerators[method].name, n, seed,
+                    elementTypes[benchmarkOptions.elementType].name);
+                printf("\nGenerating data...");
+                double startTime = getTimeInSeconds();
+                unsigned long int *unsortedArr = generateData(method, n);
+                if (unsortedArr == NULL) {
+                    fprintf(stderr, "\nMemory allocation failed for N = %d\n", n);
+                    continue;
+                }
+                printf(" %.6lfsecs", getTimeInSeconds() - startTime);
+
+                runBatchCell(config, dataGenerators[method].key, seed, unsortedArr, n);
+                recordSweepTimes(sweepTimes, s);
+                free(unsortedArr);
+            }
+            if (config->isAnalyzing && config->sizesCount > 1) {
+                char label[64];
+                snprintf(label, sizeof(label), "%s, %s", dataGenerators[method].key, elementTypes[benchmarkOptions.elementType].key);
+                analyzeSweep(label, config->sizes, config->sizesCount, sweepTimes);
+            }
+        }
+    }
+    free(sweepTimes);
+    printf("\n\nResults appended to %s\n", config->resultsFile);
+}
+void runBatchCell(const BatchConfig *config, const char *source, const char *seed, unsigned long int *array, int n) {
+    if (config->selectionsCount > 0) {
+        runSelectionCell(config, source, seed, array, n);
+        return;
+    }
+
+    // Serial algorithms do not depend on the thread count and are only timed once
+    int *wasSkipped = (int *)malloc(algorithmsSize * sizeof(int));
+    double *baseTimes = (double *)calloc(algorithmsSize, sizeof(double));
+    if (wasSkipped == NULL || baseTimes == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < algorithmsSize; i++) {
+        wasSkipped[i] = algorithms[i].isSkipped;
+    }
+
+    for (int t = 0; t < config->threadCountsCount; t++) {
+        benchmarkOptions.threads = config->threadCounts[t];
+        for (int i = 0; i < algorithmsSize; i++) {
+            algorithms[i].isSkipped = wasSkipped[i] || (t > 0 && !algorithms[i].isParallel)
+                || !isTypeSupported(&algorithms[i], benchmarkOptions.elementType);
+        }
+
+        printf("\n\nThreads: %d", benchmarkOptions.threads);
+        runBenchmark(array, n);
+
+        // Summary table of the cell. Speedup is relative to the first thread count.
+        printf("\n-------------------------------------------------------------------------------------------------------------------------");
+        printf("\n|       Algorithm      |      Min      |     Median    |      Mean     |     Stddev    |      P95      | Speedup |  Eff.  |");
+        printf("\n-------------------------------------------------------------------------------------------------------------------------");
+        for (int i = 0; i < algorithmsSize; i++) {
+            if (algorithms[i].isSkipped) continue;
+            BenchmarkStats *stats = &algorithms[i].stats;
+            if (t == 0) {
+                baseTimes[i] = stats->median;
+            }
+            double speedup = stats->median > 0.0 ? baseTimes[i] / stats->median : 0.0;
+            double efficiency = speedup * config->threadCounts[0] / benchmarkOptions.threads;
+            int threads = algorithms[i].isParallel ? benchmarkOptions.threads : 1;
+            if (algorithms[i].status != RUN_OK) {
+                // Runs that did not finish have no timings, only an estimate when one could be made
+                const char *status = runStatusNames[algorithms[i].status];
+                char detail[96] = "";
+                if (algorithms[i].estimate > 0.0) {
+                    snprintf(detail, sizeof(detail), "(estimated %.9lfsecs from smaller N)", algorithms[i].estimate);
+                }
+                printf("\n| %20s | %-7s %-88s |", algorithms[i].name, status, detail);
+                appendStringToFile(config->resultsFile, "%d,%s,%s,%s,%s,%d,0,%d,,,,,,,,,,,,,,,%s,", n, source, seed,
+                    elementTypes[benchmarkOptions.elementType].key, algorithms[i].name, threads, benchmarkOptions.warmups, status);
+                if (algorithms[i].estimate > 0.0) {
+                    appendStringToFile(config->resultsFile, "%.9lf", algorithms[i].estimate);
+                }
+            } else {
+                printf("\n| %20s | %14.9lf| %14.9lf| %14.9lf| %14.9lf| %14.9lf| %7.3lf | %6.3lf |", algorithms[i].name,
+                    stats->min, stats->median, stats->mean, stats->stddev, stats->p95, speedup, efficiency);
+                appendStringToFile(config->resultsFile, "%d,%s,%s,%s,%s,%d,%d,%d,%.9lf,%.9lf,%.9lf,%.9lf,%.9lf,%.6lf,%.6lf",
+                    n, source, seed, elementTypes[benchmarkOptions.elementType].key, algorithms[i].name, threads,
+                    stats->samples, benchmarkOptions.warmups,
+                    stats->min, stats->median, stats->mean, stats->stddev, stats->p95, speedup, efficiency);
+
+                // Counter columns are left empty when they were not measured
+                PerfReading *counters = &algorithms[i].counters;
+                for (int c = 0; c < 2; c++) {
+                    if (counters->isAvailable[c]) {
+                        appendStringToFile(config->resultsFile, ",%.0lf", counters->values[c]);
+                    } else {
+                        appendStringToFile(config->resultsFile, ",");
+                    }
+                }
+                if (counters->isAvailable[0] && counters->isAvailable[1] && counters->values[0] > 0.0) {
+                    appendStringToFile(config->resultsFile, ",%.4lf", counters->values[1] / counters->values[0]);
+                } else {
+                    appendStringToFile(config->resultsFile, ",");
+                }
+                for (int c = 2; c < PERF_COUNTER_COUNT; c++) {
+                    if (counters->isAvailable[c]) {
+                        appendStringToFile(config->resultsFile, ",%.6lf", counters->values[c] / n);
+                    } else {
+                        appendStringToFile(config->resultsFile, ",");
+                    }
+                }
+                appendStringToFile(config->resultsFile, ",ok,");
+            }
+
+            // Memory columns are left empty outside isolated runs
+            MemoryUsage *memory = &algorithms[i].memory;
+            if (memory->isAvailable) {
+                appendStringToFile(config->resultsFile, ",%ld,%ld,%ld,%ld", memory->peakRss, memory->peakRssGrowth,
+                    memory->minorFaults, memory->majorFaults);
+            } else {
+                appendStringToFile(config->resultsFile, ",,,,");
+            }
+            if (algorithms[i].status == RUN_OK) {
+                appendStringToFile(config->resultsFile, ",%.0lf,%.0lf", algorithms[i].throughput,
+                    stats->median > 0.0 ? n / stats->median : 0.0);
+            } else {
+                appendStringToFile(config->resultsFile, ",,");
+            }
+            appendStringToFile(config->resultsFile, ",%.0lf,%.0lf,\n", passBytes(benchmarkOptions.elementType, n),
+                permutedBytes(benchmarkOptions.elementType, n));
+            appendJsonResult(config->jsonFile, source, seed, n, &algorithms[i], threads);
+        }
+        printf("\n-------------------------------------------------------------------------------------------------------------------------");
+        if (benchmarkOptions.usePerfCounters) {
+            displayPerfCounters(n);
+        }
+        if (benchmarkOptions.isIsolated) {
+            displayMemoryUsage();
+        }
+        #ifdef COUNT_OPERATIONS
+            displayOperationCounts(algorithms, algorithmsSize);
+        #endif
+        if (elementTypes[benchmarkOptions.elementType].directType >= 0) {
+            compareIndirectSort(config, source, seed, array, n);
+        }
+    }
+
+    for (int i = 0; i < algorithmsSize; i++) {
+        algorithms[i].isSkipped = wasSkipped[i];
+    }
+    free(wasSkipped);
+    free(baseTimes);
+}
+void compareIndirectSort(const BatchConfig *config, const char *source, const char *seed, unsigned long int *array, int n) {
+    int indirectType = benchmarkOptions.elementType;
+    int directType = elementTypes[indirectType].directType;
+
+    // The direct run overwrites the results, which the rest of the sweep reads, so they are kept aside
+    SortingAlgorithm *indirect = (SortingAlgorithm *)malloc(algorithmsSize * sizeof(SortingAlgorithm));
+    if (indirect == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(indirect, algorithms, algorithmsSize * sizeof(SortingAlgorithm));
+    int comparedCount = 0;
+    for (int i = 0; i < algorithmsSize; i++) {
+        algorithms[i].isSkipped = indirect[i].isSkipped || indirect[i].status != RUN_OK
+            || findTypedSort(&algorithms[i], directType) < 0;
+        if (!algorithms[i].isSkipped) comparedCount++;
+    }
+    if (comparedCount == 0) {
+        printf("\nNo algorithm that finished has a direct version for %s, nothing to compare", elementTypes[directType].key);
+    } else {
+        printf("\n\nDirect sorts of the same records, %s:", elementTypes[directType].name);
+        benchmarkOptions.elementType = directType;
+        runBenchmark(array, n);
+
+        // Bytes per pass are the elements the algorithm itself moves, n records directly or n
+        // packed words indirectly, the indirect sort then moves the records once more
+        printf("\n--------------------------------------------------------------------------------------------------------------------------------");
+        printf("\n|       Algorithm      |     Direct    |    Indirect   | Direct/Indirect | Pass bytes dir. | Pass bytes ind. | Permuted bytes  |");
+        printf("\n--------------------------------------------------------------------------------------------------------------------------------");
+        for (int i = 0; i < algorithmsSize; i++) {
+            if (algorithms[i].isSkipped) continue;
+            BenchmarkStats *stats = &algorithms[i].stats;
+            int threads = algorithms[i].isParallel ? benchmarkOptions.threads : 1;
+            if (algorithms[i].status != RUN_OK) {
+                printf("\n| %20s | %-7s %-93s |", algorithms[i].name, runStatusNames[algorithms[i].status], "");
+                appendStringToFile(config->resultsFile, "%d,%s,%s,%s,%s,%d,0,%d,,,,,,,,,,,,,,,%s,,,,,,,,%.0lf,0,\n", n, source, seed,
+                    elementTypes[directType].key, algorithms[i].name, threads, benchmarkOptions.warmups,
+                    runStatusNames[algorithms[i].status], passBytes(directType, n));
+                appendJsonResult(config->jsonFile, source, seed, n, &algorithms[i], threads);
+                continue;
+            }
+            double ratio = indirect[i].stats.median > 0.0 ? stats->median / indirect[i].stats.median : 0.0;
+            printf("\n| %20s | %14.9lf| %14.9lf| %15.3lf | %15.0lf | %15.0lf | %15.0lf |", algorithms[i].name, stats->median,
+                indirect[i].stats.median, ratio, passBytes(directType, n), passBytes(indirectType, n), permutedBytes(indirectType, n));
+            // The direct runs are results of the direct type, the ratio has a column of its own
+            appendStringToFile(config->resultsFile, "%d,%s,%s,%s,%s,%d,%d,%d,%.9lf,%.9lf,%.9lf,%.9lf,%.9lf,,,,,,,,,,ok,,,,,,%.0lf,%.0lf,%.0lf,0,%.6lf\n",
+                n, source, seed, elementTypes[directType].key, algorithms[i].name, threads, stats->samples, benchmarkOptions.warmups,
+                stats->min, stats->median, stats->mean, stats->stddev, stats->p95, algorithms[i].throughput,
+                stats->median > 0.0 ? n / stats->median : 0.0, passBytes(directType, n), ratio);
+            appendJsonResult(config->jsonFile, source, seed, n, &algorithms[i], threads);
+        }
+        printf("\n--------------------------------------------------------------------------------------------------------------------------------");
+        benchmarkOptions.elementType = indirectType;
+    }
+
+    // runBenchmark() may have moved the samples buffers, the rest is the indirect results
+    for (int i = 0; i < algorithmsSize; i++) {
+        double *samples = algorithms[i].samples;
+        algorithms[i] = indirect[i];
+        algorithms[i].samples = samples;
+    }
+    free(indirect);
+}
+double passBytes(int type, int n) {
+    return (double)n * (elementTypes[type].directType >= 0 ? sizeof(unsigned long int) : elementTypes[type].size);
+}
+double permutedBytes(int type, int n) {
+    if (elementTypes[type].directType < 0) return 0.0;
+    return (double)n * elementTypes[type].size * (benchmarkOptions.permuteMode == PERMUTE_GATHER ? 2 : 1);
+}
+void displayBatchUsage(const char *program) {
+    printf("Usage: %s [options]\n", program);
+    printf("Runs without prompting when any option is given.\n\n");
+    printf("  --sizes LIST        Comma-separated values of N (e.g. 1000,1e4,1e5)\n");
+    printf("  --generators LIST   Comma-separated data generation methods or 'all' (default random,increasing):");
+    for (int i = 0; i < dataGeneratorsSize; i++) {
+        printf(" %s", dataGenerators[i].key);
+    }
+    printf("\n  --algorithms LIST   Comma-separated algorithms or 'all':");
+    for (int i = 0; i < algorithmsSize; i++) {
+        int keyLength = (int)(strchr(algorithms[i].outputFile, '.') - algorithms[i].outputFile);
+        printf(" %.*s", keyLength, algorithms[i].outputFile);
+    }
+    printf("\n  --types LIST        Comma-separated element types the keys are converted to or 'all' (default u64):");
+    for (int i = 0; i < ELEMENT_TYPE_COUNT; i++) {
+        printf(" %s", elementTypes[i].key);
+    }
+    printf("\n                      Algorithms without a version for a type are skipped for it. Every algorithm\n");
+    printf("                      sorts the -indirect records, by sorting packed (key, index) pairs,\n");
+    printf("                      and is then compared with its direct version where there is one\n");
+    printf("  --permute MODE      How indirect sorts move the records: gather (into a buffer) or cycles\n");
+    printf("                      (in place along the permutation cycles) (default gather)\n");
+    printf("  --repeat K          Timed repetitions per cell (default 1)\n");
+    printf("  --warmup W          Untimed warm-up runs per cell (default 0)\n");
+    printf("  --threads LIST      Thread counts for the parallel algorithms, e.g. 1,2,4 or 1-8 (default: all processors)\n");
+    printf("  --pin CPU           Run the benchmark thread on processor CPU; parallel workers pinned with\n");
+    printf("                      --affinity are placed from it\n");
+    printf("  --prefault          Fault in the sorted copies before timing and keep the memory the sorts\n");
+    printf("                      free mapped, so scratch buffers faulted in by --warmup are reused\n");
+    printf("  --huge-pages        Put the sorted copies on 2MB pages: reserved ones, else transparent (Linux)\n");
+    printf("  --cold-cache        Evict the last-level cache before every timed repetition\n");
+    printf("  --affinity MODE     Pin the workers of the parallel algorithms: none, compact (worker i on\n");
+    printf("                      processor i) or spread (evenly over all processors) (default none)\n");
+    printf("  --grain G           Subarrays up to G elements are not split into tasks (default %d)\n", DEFAULT_GRAIN_SIZE);
+    printf("  --quick-sort-cutoff C  Quick sort ranges up to C keys use insertion sort (default %d)\n", QUICK_SORT_INSERTION_THRESHOLD);
+    printf("  --radix-cutoff C    American flag sort buckets up to C keys use insertion sort (default %d)\n", MSD_INSERTION_THRESHOLD);
+    printf("  --vector-leaf C     Keys per sorting network call of the vector sorts, 8 to %d (default %d)\n", SIMD_LEAF_SIZE, SIMD_LEAF_SIZE);
+    printf("  --tune              Time the candidates of the cutoffs above on random keys of the largest N\n");
+    printf("                      (default %d) and save the fastest to the profile file\n", DEFAULT_TUNING_SIZE);
+    printf("  --self-test         Check the parallel sorts with 2 to 32 workers on inputs with few distinct\n");
+    printf("                      keys, equal keys and runs, and exit with an error if one is not sorted\n");
+    printf("  --profile FILE      Cutoff profile loaded at startup when present and written by --tune\n");
+    printf("                      (default %s)\n", DEFAULT_PROFILE_FILE);
+    printf("  --analyze           Fit c*N^k and c*N*log N to every algorithm and find the crossover N\n");
+    printf("                      between each pair after every sweep over --sizes\n");
+    printf("  --select LIST       Find the k smallest keys instead of sorting, for each k in LIST: fractions\n");
+    printf("                      of N below 1, counts otherwise (e.g. 1e-5,0.01,0.5 or 1000). Times:");
+    for (int i = 0; i < selectionEnginesSize; i++) {
+        printf(" %s", selectionEngines[i].key);
+    }
+    printf("\n");
+    printf("  --simd SET          Widest instruction set of the vector sorts: auto, avx512, avx2 or none\n");
+    printf("                      (default auto, the widest one the processor supports)\n");
+    printf("  --input FILE        Benchmark a saved text or binary dataset instead of the generators;\n");
+    printf("                      each N in --sizes uses its first N keys (default: all of them)\n");
+    printf("  --external FILE     Sort a binary dataset on disk instead of benchmarking\n");
+    printf("  --external-output FILE  Sorted binary file of the external sort (default external-sorted.bin)\n");
+    printf("  --chunk-algorithm A Algorithm that sorts each chunk of the external sort (default quick-sort)\n");
+    printf("  --memory MB         Memory for the chunks and merge buffers of the external sort (default 256);\n");
+    printf("                      merge and radix chunk algorithms allocate up to one more chunk\n");
+    printf("  --fan-in K          Maximum number of runs merged at once (default 64), lowered when\n");
+    printf("                      the merge buffers would not fit in --memory\n");
+    printf("  --seed S            Seed of the generated data (default %d)\n", DEFAULT_SEED);
+    printf("  --start X           Starting value of the sequence-based generators (default 0)\n");
+    printf("  --swaps K           Random swaps of nearly-sorted (default 1%% of N)\n");
+    printf("  --unique K          Distinct keys of few-unique (default %d)\n", DEFAULT_UNIQUE_COUNT);
+    printf("  --zipf S            Exponent of zipf (default 1.0)\n");
+    printf("  --run-length L      Length of each sawtooth run (default: square root of N)\n");
+    printf("  --results FILE      CSV file the statistics are appended to (default batch-results.csv)\n");
+    printf("  --json FILE         JSON Lines file every result is appended to, with the run metadata and\n");
+    printf("                      every timed repetition (default batch-results.jsonl)\n");
+    printf("  --compare BASE      Compare the JSON Lines results of --compare-to (default: the --json file)\n");
+    printf("                      with BASE instead of benchmarking; exits with failure on a regression\n");
+    printf("  --compare-to FILE   The results compared with BASE\n");
+    printf("  --threshold PCT     Significant slowdowns above PCT percent are regressions (default %.0lf)\n", DEFAULT_COMPARE_THRESHOLD);
+    printf("  --output FORMAT     Write the sorted arrays as none, text or binary (default none)\n");
+    printf("  --write-output      Same as --output text\n");
+    printf("  --perf              Read hardware performance counters around each sort (Linux). Parallel\n");
+    printf("                      algorithms with more than one thread are left uncounted\n");
+    printf("  --isolate           Run each algorithm in a child process and report its peak RSS and page faults\n");
+    printf("  --time-budget SECS  Kill an isolated algorithm after SECS and record a timeout, estimated from\n");
+    printf("                      smaller N; larger N are then skipped (implies --isolate)\n");
+    printf("  --config FILE       Read the options above from a file of key = value lines\n");
+}
+
+/*
+*
+* RESULTS STORE
+*
+*/
+const char *getRunMetadata(void) {
+    static char metadata[2048] = "";
+    if (metadata[0] != '\0') return metadata;
+
+    // The run id is the start time and process id, unique enough to group the lines of one run
+    time_t now = time(NULL);
+    char timestamp[32];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    char runId[64];
+    char host[256] = "unknown";
+    const char *operatingSystem = "unknown";
+    #ifdef _WIN32
+        snprintf(runId, sizeof(runId), "%ld-%lu", (long)now, (unsigned long)GetCurrentProcessId());
+        const char *computerName = getenv("COMPUTERNAME");
+        if (computerName != NULL) {
+            snprintf(host, sizeof(host), "%s", computerName);
+        }
+        operatingSystem = "windows";
+    #else
+        snprintf(runId, sizeof(runId), "%ld-%ld", (long)now, (long)getpid());
+        if (gethostname(host, sizeof(host)) != 0) {
+            strcpy(host, "unknown");
+        }
+        host[sizeof(host) - 1] = '\0';
+        #if defined(__APPLE__)
+            operatingSystem = "macos";
+        #elif defined(__linux__)
+            operatingSystem = "linux";
+        #else
+            operatingSystem = "posix";
+        #endif
+    #endif
+
+    char processor[256] = "unknown";
+    #ifdef __linux__
+        FILE *cpuInfo = fopen("/proc/cpuinfo", "r");
+        if (cpuInfo != NULL) {
+            char line[MAX_CONFIG_LINE];
+            while (fgets(line, sizeof(line), cpuInfo) != NULL) {
+                if (strncmp(line, "model name", 10) == 0 && strchr(line, ':') != NULL) {
+                    const char *model = strchr(line, ':') + 1;
+                    while (*model == ' ') model++;
+                    snprintf(processor, sizeof(processor), "%.*s", (int)strcspn(model, "\n"), model);
+                    break;
+                }
+            }
+            fclose(cpuInfo);
+        }
+    #endif
+
+    #if defined(__clang__)
+        const char *compiler = __VERSION__;
+    #elif defined(__GNUC__)
+        const char *compiler = "gcc " __VERSION__;
+    #elif defined(_MSC_VER)
+        char compiler[32];
+        snprintf(compiler, sizeof(compiler), "MSVC %d", _MSC_VER);
+    #else
+        const char *compiler = "unknown";
+    #endif
+    #ifdef COUNT_OPERATIONS
+        const char *build = "counting";
+    #else
+        const char *build = "timing";
+    #endif
+
+    char hostJson[512], operatingSystemJson[64], processorJson[512], compilerJson[512];
+    escapeJsonString(host, hostJson, sizeof(hostJson));
+    escapeJsonString(operatingSystem, operatingSystemJson, sizeof(operatingSystemJson));
+    escapeJsonString(processor, processorJson, sizeof(processorJson));
+    escapeJsonString(compiler, compilerJson, sizeof(compilerJson));
+    size_t length = snprintf(metadata, sizeof(metadata), "\"run_id\":\"%s\",\"timestamp\":\"%s\",\"host\":%s,\"os\":%s,\"cpu\":%s,"
+        "\"processors\":%d,\"compiler\":%s,\"build\":\"%s\",\"simd\":\"%s\",\"affinity\":\"%s\","
+        "\"timer\":\"%s\",\"timer_hz\":%.0lf,\"pin\":%d,\"huge_pages\":%s,\"prefault\":%s,\"cold_cache\":%s,\"cutoffs\":{",
+        runId, timestamp, hostJson, operatingSystemJson, processorJson, getProcessorCount(), compilerJson, build,
+        simdLevelNames[getSimdLevel()], affinityNames[benchmarkOptions.affinity], timerSourceNames[timerSource],
+        getTimerFrequency(), benchmarkOptions.pinProcessor, benchmarkOptions.useHugePages ? "true" : "false",
+        benchmarkOptions.isPrefaulting ? "true" : "false", benchmarkOptions.isColdCache ? "true" : "false");
+    for (int i = 0; i < tunableCutoffsSize && length < sizeof(metadata); i++) {
+        length += snprintf(metadata + length, sizeof(metadata) - length, "%s\"%s\":%d", i > 0 ? "," : "",
+            tunableCutoffs[i].key, *tunableCutoffs[i].value);
+    }
+    if (length + 2 < sizeof(metadata)) {
+        strcat(metadata, "}");
+    }
+    return metadata;
+}
+size_t escapeJsonString(const char *value, char *buffer, size_t size) {
+    size_t length = 0;
+    // Room is kept for the longest escape, the closing quote and the null character
+    buffer[length++] = '"';
+    for (const unsigned char *c = (const unsigned char *)value; *c != '\0' && length + 8 < size; c++) {
+        if (*c == '"' || *c == '\\') {
+            buffer[length++] = '\\';
+            buffer[length++] = (char)*c;
+        } else if (*c < 0x20) {
+            length += snprintf(buffer + length, size - length, "\\u%04x", *c);
+        } else {
+            buffer[length++] = (char)*c;
+        }
+    }
+    buffer[length++] = '"';
+    buffer[length] = '\0';
+    return length;
+}
+void appendJsonResult(const char *filename, const char *source, const char *seed, int n, const SortingAlgorithm *algorithm, int threads) {
+    if (algorithm->isSkipped || algorithm->samples == NULL) return;
+
+    FILE *file = fopen(filename, "a");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file: %s\n", filename);
+        return;
+    }
+
+    char sourceJson[2 * RUN_NAME_SIZE], algorithmJson[128];
+    escapeJsonString(source, sourceJson, sizeof(sourceJson));
+    escapeJsonString(algorithm->name, algorithmJson, sizeof(algorithmJson));
+    fprintf(file, "{%s,\"n\":%d,\"generator\":%s,\"seed\":", getRunMetadata(), n, sourceJson);
+    if (seed[0] != '\0') {
+        fprintf(file, "%s", seed);
+    } else {
+        fprintf(file, "null");
+    }
+    fprintf(file, ",\"element_type\":\"%s\",\"algorithm\":%s,\"threads\":%d,\"grain_size\":%d,\"repetitions\":%d,\"warmups\":%d,\"status\":\"%s\"",
+        elementTypes[benchmarkOptions.elementType].key, algorithmJson, threads, benchmarkOptions.grainSize,
+        benchmarkOptions.repetitions, benchmarkOptions.warmups, runStatusNames[algorithm->status]);
+
+    if (algorithm->status == RUN_OK || algorithm->status == RUN_INVALID) {
+        const BenchmarkStats *stats = &algorithm->stats;
+        fprintf(file, ",\"min\":%.9lf,\"median\":%.9lf,\"mean\":%.9lf,\"stddev\":%.9lf,\"p95\":%.9lf,\"bytes_per_second\":%.0lf,\"keys_per_second\":%.0lf,\"samples\":[",
+            stats->min, stats->median, stats->mean, stats->stddev, stats->p95, algorithm->throughput,
+            stats->median > 0.0 ? n / stats->median : 0.0);
+        for (int r = 0; r < stats->samples; r++) {
+            fprintf(file, r > 0 ? ",%.9lf" : "%.9lf", algorithm->samples[r]);
+        }
+        fprintf(file, "]");
+
+        // Only what was measured is written
+        int hasCounters = 0;
+        for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+            if (!algorithm->counters.isAvailable[c]) continue;
+            fprintf(file, "%s\"%s\":%.0lf", hasCounters ? "," : ",\"counters\":{", perfCounterNames[c], algorithm->counters.values[c]);
+            hasCounters = 1;
+        }
+        if (hasCounters) {
+            const PerfReading *counters = &algorithm->counters;
+            fprintf(file, ",\"running_fraction\":%.4lf}", counters->enabledTime > 0.0 ? counters->runningTime / counters->enabledTime : 1.0);
+        }
+        #ifdef COUNT_OPERATIONS
+            fprintf(file, ",\"comparisons\":%llu,\"swaps\":%llu,\"writes\":%llu", algorithm->operations.comparisons,
+                algorithm->operations.swaps, algorithm->operations.writes);
+        #endif
+    } else if (algorithm->estimate > 0.0) {
+        fprintf(file, ",\"estimated_time\":%.9lf", algorithm->estimate);
+    }
+    if (algorithm->memory.isAvailable) {
+        fprintf(file, ",\"peak_rss_kb\":%ld,\"peak_rss_growth_kb\":%ld,\"minor_faults\":%ld,\"major_faults\":%ld",
+            algorithm->memory.peakRss, algorithm->memory.peakRssGrowth, algorithm->memory.minorFaults, algorithm->memory.majorFaults);
+    }
+    fprintf(file, "}\n");
+    fclose(file);
+}
+const char *findJsonValue(const char *line, const char *key) {
+    const char *next = skipJsonWhitespace(line);
+    if (*next != '{') return NULL;
+    next = skipJsonWhitespace(next + 1);
+
+    // Walk the members of the object, skipping over the values that are not the one wanted
+    size_t keyLength = strlen(key);
+    while (*next == '"') {
+        const char *name = next + 1;
+        const char *nameEnd = skipJsonValue(next);
+        if (nameEnd == NULL) return NULL;
+        next = skipJsonWhitespace(nameEnd);
+        if (*next != ':') return NULL;
+        const char *value = skipJsonWhitespace(next + 1);
+        if ((size_t)(nameEnd - 1 - name) == keyLength && strncmp(name, key, keyLength) == 0) {
+            return value;
+        }
+
+        next = skipJsonValue(value);
+        if (next == NULL) return NULL;
+        next = skipJsonWhitespace(next);
+        if (*next != ',') return NULL;
+        next = skipJsonWhitespace(next + 1);
+    }
+    return NULL;
+}
+const char *skipJsonWhitespace(const char *text) {
+    while (*text == ' ' || *text == '\t' || *text == '\r' || *text == '\n') {
+        text++;
+    }
+    return text;
+}
+const char *skipJsonValue(const char *value) {
+    if (*value == '"') {
+        for (value++; *value != '"'; value++) {
+            if (*value == '\0') return NULL;
+            if (*value == '\\' && value[1] != '\0') value++;
+        }
+        return value + 1;
+    }
+
+    if (*value == '{' || *value == '[') {
+        // Brackets inside the strings of the value do not count
+        int depth = 0;
+        do {
+            if (*value == '"') {
+                value = skipJsonValue(value);
+                if (value == NULL) return NULL;
+                continue;
+            }
+            if (*value == '\0') return NULL;
+            if (*value == '{' || *value == '[') depth++;
+            if (*value == '}' || *value == ']') depth--;
+            value++;
+        } while (depth > 0);
+        return value;
+    }
+
+    // Numbers, true, false and null run up to the next separator
+    const char *start = value;
+    while (*value != '\0' && strchr(",:{}[]\" \t\r\n", *value) == NULL) {
+        value++;
+    }
+    return value > start ? value : NULL;
+}
+void readJsonString(const char *value, char *buffer, size_t size) {
+    size_t length = 0;
+    if (value != NULL && *value == '"') {
+        for (value++; *value != '\0' && *value != '"' && length + 1 < size; value++) {
+            if (*value == '\\' && value[1] != '\0') {
+                value++;
+                if (*value == 'u') {
+                    // Only the control characters escapeJsonString() writes are expected
+                    buffer[length++] = (char)strtol(value + 1, NULL, 16);
+                    value += 4;
+                    continue;
+                }
+            }
+            buffer[length++] = *value;
+        }
+    }
+    buffer[length] = '\0';
+}
+int loadResultRecords(const char *filename, ResultRecord **records, int *count) {
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file: %s\n", filename);
+        return 0;
+    }
+
+    *records = NULL;
+    *count = 0;
+    int capacity = 0;
+    // The members every line needs, the first character of their values ('0' for any digit),
+    // and how many lines lacked each one
+    const char *requiredKeys[] = {"algorithm", "n", "generator", "element_type", "status", "samples"};
+    const char requiredStarts[] = {'"', '0', '"', '"', '"', '['};
+    int requiredKeysCount = sizeof(requiredKeys)/sizeof(requiredKeys[0]);
+    int skippedCounts[sizeof(requiredKeys)/sizeof(requiredKeys[0])] = {0};
+    int lineNumber = 0, linesCount = 0, skippedCount = 0, firstSkipped = 0;
+    size_t lineCapacity = MAX_CONFIG_LINE;
+    char *line = (char *)malloc(lineCapacity);
+    if (line == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    while (fgets(line, (int)lineCapacity, file) != NULL) {
+        // Lines with many samples are longer than the buffer, which grows until they fit
+        size_t length = strlen(line);
+        while (length > 0 && line[length - 1] != '\n' && !feof(file)) {
+            lineCapacity *= 2;
+            char *grown = (char *)realloc(line, lineCapacity);
+            if (grown == NULL) {
+                perror("Memory allocation failed");
+                exit(EXIT_FAILURE);
+            }
+            line = grown;
+            if (fgets(line + length, (int)(lineCapacity - length), file) == NULL) break;
+            length += strlen(line + length);
+        }
+
+        lineNumber++;
+        if (*skipJsonWhitespace(line) == '\0') continue;
+        linesCount++;
+
+        const char *values[sizeof(requiredKeys)/sizeof(requiredKeys[0])];
+        int missing = -1;
+        for (int k = 0; k < requiredKeysCount && missing < 0; k++) {
+            values[k] = findJsonValue(line, requiredKeys[k]);
+            int isPresent = values[k] != NULL
+                && (requiredStarts[k] == '0' ? isdigit((unsigned char)*values[k]) : *values[k] == requiredStarts[k]);
+            // Only the runs that finished have samples, the status comes before them
+            int isOptional = strcmp(requiredKeys[k], "samples") == 0 && strncmp(values[k - 1], "\"ok\"", 4) != 0
+                && strncmp(values[k - 1], "\"invalid\"", 9) != 0;
+            if (!isPresent && !isOptional) {
+                missing = k;
+            }
+        }
+        if (missing >= 0) {
+            skippedCounts[missing]++;
+            if (skippedCount++ == 0) {
+                firstSkipped = lineNumber;
+            }
+            continue;
+        }
+
+        ResultRecord record;
+        memset(&record, 0, sizeof(record));
+        readJsonString(values[0], record.algorithm, sizeof(record.algorithm));
+        readJsonString(values[2], record.generator, sizeof(record.generator));
+        readJsonString(values[3], record.elementType, sizeof(record.elementType));
+        readJsonString(values[4], record.status, sizeof(record.status));
+        record.n = atoi(values[1]);
+        const char *threadsValue = findJsonValue(line, "threads");
+        record.threads = threadsValue != NULL ? atoi(threadsValue) : 1;
+
+        const char *samplesValue = values[5];
+        if (samplesValue != NULL && *samplesValue == '[') {
+            int samplesCapacity = 0;
+            const char *next = skipJsonWhitespace(samplesValue + 1);
+            while (*next != ']' && *next != '\0') {
+                char *end;
+                double sample = strtod(next, &end);
+                if (end == next) break;
+                if (record.samplesCount == samplesCapacity) {
+                    samplesCapacity = samplesCapacity > 0 ? samplesCapacity * 2 : 16;
+                    double *grown = (double *)realloc(record.samples, samplesCapacity * sizeof(double));
+                    if (grown == NULL) {
+                        perror("Memory allocation failed");
+                        exit(EXIT_FAILURE);
+                    }
+                    record.samples = grown;
+                }
+                record.samples[record.samplesCount++] = sample;
+                next = skipJsonWhitespace(end);
+                next = *next == ',' ? skipJsonWhitespace(next + 1) : next;
+            }
+        }
+
+        // A newer line of the same cell replaces the older one
+        int index = -1;
+        for (int i = 0; i < *count && index < 0; i++) {
+            if (isSameResultCell(&(*records)[i], &record)) {
+                index = i;
+            }
+        }
+        if (index >= 0) {
+            free((*records)[index].samples);
+        } else {
+            if (*count == capacity) {
+                capacity = capacity > 0 ? capacity * 2 : 64;
+                ResultRecord *grown = (ResultRecord *)realloc(*records, capacity * sizeof(ResultRecord));
+                if (grown == NULL) {
+                    perror("Memory allocation failed");
+                    exit(EXIT_FAILURE);
+                }
+                *records = grown;
+            }
+            index = (*count)++;
+        }
+        (*records)[index] = record;
+    }
+    free(line);
+    fclose(file);
+
+    if (skippedCount > 0) {
+        fprintf(stderr, "Skipped %d of %d lines of %s (first at line %d):", skippedCount, linesCount, filename, firstSkipped);
+        const char *separator = " ";
+        for (int k = 0; k < requiredKeysCount; k++) {
+            if (skippedCounts[k] > 0) {
+                fprintf(stderr, "%s%d without a valid \"%s\"", separator, skippedCounts[k], requiredKeys[k]);
+                separator = ", ";
+            }
+        }
+        fprintf(stderr, "\n");
+    }
+    return 1;
+}
+void freeResultRecords(ResultRecord *records, int count) {
+    for (int i = 0; i < count; i++) {
+        free(records[i].samples);
+    }
+    free(records);
+}
+int isSameResultCell(const ResultRecord *first, const ResultRecord *second) {
+    return first->n == second->n && first->threads == second->threads && strcmp(first->algorithm, second->algorithm) == 0
+        && strcmp(first->generator, second->generator) == 0 && strcmp(first->elementType, second->elementType) == 0;
+}
+double mannWhitneyGreater(const double *base, int baseCount, const double *candidate, int candidateCount) {
+    int total = baseCount + candidateCount;
+    RankedSample *ranked = (RankedSample *)malloc(total * sizeof(RankedSample));
+    if (ranked == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < baseCount; i++) {
+        ranked[i].value = base[i];
+        ranked[i].isCandidate = 0;
+    }
+    for (int i = 0; i < candidateCount; i++) {
+        ranked[baseCount + i].value = candidate[i];
+        ranked[baseCount + i].isCandidate = 1;
+    }
+    qsort(ranked, total, sizeof(RankedSample), compareRankedSamples);
+
+    // Tied timings share the average of their ranks
+    double candidateRanks = 0.0;
+    double ties = 0.0;
+    for (int i = 0; i < total;) {
+        int j = i;
+        while (j < total && ranked[j].value == ranked[i].value) j++;
+        double rank = (i + 1 + j) / 2.0;
+        for (int k = i; k < j; k++) {
+            if (ranked[k].isCandidate) candidateRanks += rank;
+        }
+        double tied = j - i;
+        ties += tied * tied * tied - tied;
+        i = j;
+    }
+    free(ranked);
+
+    double u = candidateRanks - candidateCount * (candidateCount + 1) / 2.0;
+    double mean = (double)baseCount * candidateCount / 2.0;
+    double variance = (double)baseCount * candidateCount / 12.0 * ((total + 1) - ties / ((double)total * (total - 1)));
+    if (variance <= 0.0) return 1.0;
+    double z = (u - mean - 0.5) / sqrt(variance);
+    return 0.5 * erfc(z / sqrt(2.0));
+}
+int compareRankedSamples(const void *a, const void *b) {
+    double first = ((const RankedSample *)a)->value;
+    double second = ((const RankedSample *)b)->value;
+    return (first > second) - (first < second);
+}
+int compareResults(const BatchConfig *config) {
+    ResultRecord *base, *candidate;
+    int baseCount, candidateCount;
+    if (!loadResultRecords(config->compareBase, &base, &baseCount)) {
+        return EXIT_FAILURE;
+    }
+    if (!loadResultRecords(config->compareCandidate, &candidate, &candidateCount)) {
+        freeResultRecords(base, baseCount);
+        return EXIT_FAILURE;
+    }
+
+    printf("\nBase: %s (%d cells)", config->compareBase, baseCount);
+    printf("\nCandidate: %s (%d cells)", config->compareCandidate, candidateCount);
+    printf("\nSlowdowns above %.1lf%% with p < %.2lf are regressions", config->compareThreshold, COMPARE_ALPHA);
+    printf("\n---------------------------------------------------------------------------------------------------------------------------------------------");
+    printf("\n|       Algorithm      |     N     |   Generator    |   Type   | Threads |  Base median  |  New median   |  Change  | p-value |   Verdict   |");
+    printf("\n---------------------------------------------------------------------------------------------------------------------------------------------");
+    int regressions = 0, compared = 0;
+    for (int i = 0; i < candidateCount; i++) {
+        const ResultRecord *next = &candidate[i];
+        const ResultRecord *previous = NULL;
+        for (int j = 0; j < baseCount && previous == NULL; j++) {
+            if (isSameResultCell(&base[j], next)) {
+                previous = &base[j];
+            }
+        }
+        if (previous == NULL) continue;
+        compared++;
+
+        int isBaseOk = strcmp(previous->status, "ok") == 0 && previous->samplesCount > 0;
+        int isCandidateOk = strcmp(next->status, "ok") == 0 && next->samplesCount > 0;
+        double baseMedian = 0.0, candidateMedian = 0.0;
+        if (isBaseOk) {
+            double *sorted = (double *)malloc(previous->samplesCount * sizeof(double));
+            if (sorted == NULL) {
+                perror("Memory allocation failed");
+                exit(EXIT_FAILURE);
+            }
+            memcpy(sorted, previous->samples, previous->samplesCount * sizeof(double));
+            baseMedian = computeBenchmarkStats(sorted, previous->samplesCount).median;
+            free(sorted);
+        }
+        if (isCandidateOk) {
+            double *sorted = (double *)malloc(next->samplesCount * sizeof(double));
+            if (sorted == NULL) {
+                perror("Memory allocation failed");
+                exit(EXIT_FAILURE);
+            }
+            memcpy(sorted, next->samples, next->samplesCount * sizeof(double));
+            candidateMedian = computeBenchmarkStats(sorted, next->samplesCount).median;
+            free(sorted);
+        }
+
+        // A cell that stops succeeding is a regression whatever its times
+        char verdict[16];
+        double change = 0.0, pValue = -1.0;
+        if (!isCandidateOk) {
+            snprintf(verdict, sizeof(verdict), "%s", isBaseOk ? next->status : "-");
+            for (char *c = verdict; isBaseOk && *c != '\0'; c++) {
+                *c = (char)toupper((unsigned char)*c);
+            }
+            regressions += isBaseOk;
+        } else if (!isBaseOk) {
+            strcpy(verdict, "fixed");
+        } else {
+            change = baseMedian > 0.0 ? (candidateMedian / baseMedian - 1.0) * 100.0 : 0.0;
+            if (previous->samplesCount < COMPARE_MIN_SAMPLES || next->samplesCount < COMPARE_MIN_SAMPLES) {
+                // The test cannot reach significance with so few repetitions
+                strcpy(verdict, "few samples");
+            } else {
+                double pSlower = mannWhitneyGreater(previous->samples, previous->samplesCount, next->samples, next->samplesCount);
+                double pFaster = mannWhitneyGreater(next->samples, next->samplesCount, previous->samples, previous->samplesCount);
+                pValue = change > 0.0 ? pSlower : pFaster;
+                if (pSlower < COMPARE_ALPHA && change > config->compareThreshold) {
+                    strcpy(verdict, "SLOWER");
+                    regressions++;
+                } else if (pFaster < COMPARE_ALPHA && -change > config->compareThreshold) {
+                    strcpy(verdict, "faster");
+                } else {
+                    strcpy(verdict, "same");
+                }
+            }
+        }
+
+        printf("\n| %20s | %9d | %-14.14s | %-8s | %7d |", next->algorithm, next->n, next->generator, next->elementType, next->threads);
+        if (isBaseOk) {
+            printf(" %14.9lf|", baseMedian);
+        } else {
+            printf(" %14s|", previous->status);
+        }
+        if (isCandidateOk) {
+            printf(" %14.9lf|", candidateMedian);
+        } else {
+            printf(" %14s|", next->status);
+        }
+        if (isBaseOk && isCandidateOk) {
+            printf(" %+7.1lf%% |", change);
+        } else {
+            printf(" %8s |", "");
+        }
+        if (pValue >= 0.0) {
+            printf(" %7.4lf |", pValue);
+        } else {
+            printf(" %7s |", "");
+        }
+        printf(" %-11s |", verdict);
+    }
+    printf("\n---------------------------------------------------------------------------------------------------------------------------------------------");
+    printf("\n%d cells compared, %d only in the base, %d only in the candidate", compared, baseCount - compared, candidateCount - compared);
+    printf("\n%d regression(s)\n", regressions);
+
+    // A gate that checked nothing, or not everything, must not pass
+    int unmatched = 0;
+    for (int side = 0; side < 2; side++) {
+        const ResultRecord *records = side == 0 ? base : candidate;
+        const ResultRecord *others = side == 0 ? candidate : base;
+        int recordsCount = side == 0 ? baseCount : candidateCount;
+        int othersCount = side == 0 ? candidateCount : baseCount;
+        for (int i = 0; i < recordsCount; i++) {
+            const ResultRecord *record = &records[i];
+            int isMatched = 0;
+            for (int j = 0; j < othersCount && !isMatched; j++) {
+                isMatched = isSameResultCell(&others[j], record);
+            }
+            if (!isMatched) {
+                fprintf(stderr, "Only in the %s: %s, N = %d, %s, %s, %d thread(s)\n", side == 0 ? "base" : "candidate",
+                    record->algorithm, record->n, record->generator, record->elementType, record->threads);
+                unmatched++;
+            }
+        }
+    }
+    if (compared == 0) {
+        fprintf(stderr, "No cell of %s matches one of %s, nothing was compared\n", config->compareCandidate, config->compareBase);
+    } else if (unmatched > 0) {
+        fprintf(stderr, "%d cell(s) are in only one of the files, run both with the same sweep\n", unmatched);
+    }
+
+    freeResultRecords(base, baseCount);
+    freeResultRecords(candidate, candidateCount);
+    return regressions > 0 || unmatched > 0 || compared == 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/*
+*
+* ANALYSIS AND TUNING
+*
+*/
+void recordSweepTimes(double *sweepTimes, int sizeIndex) {
+    for (int i = 0; i < algorithmsSize; i++) {
+        int isMeasured = !algorithms[i].isSkipped && isTypeSupported(&algorithms[i], benchmarkOptions.elementType)
+            && algorithms[i].status == RUN_OK;
+        sweepTimes[i * MAX_BATCH_SIZES + sizeIndex] = isMeasured ? algorithms[i].time : 0.0;
+    }
+}
+void fitScaling(const int *sizes, const double *times, int count, ScalingFit *fit) {
+    memset(fit, 0, sizeof(*fit));
+
+    // Both models are linear on log scales: log t = log c + k log N and log t = log c + log(N log2 N)
+    double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0, sumOffset = 0.0;
+    for (int s = 0; s < count; s++) {
+        if (times[s] <= 0.0 || sizes[s] < 2) continue;
+        double x = log((double)sizes[s]);
+        double y = log(times[s]);
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+        sumOffset += y - log(sizes[s] * log2((double)sizes[s]));
+        fit->sizesCount++;
+    }
+    if (fit->sizesCount < 2) return;
+
+    int m = fit->sizesCount;
+    double denominator = m * sumXX - sumX * sumX;
+    if (denominator <= 0.0) {
+        fit->sizesCount = 0;
+        return;
+    }
+    fit->exponent = (m * sumXY - sumX * sumY) / denominator;
+    double logPowerCoefficient = (sumY - fit->exponent * sumX) / m;
+    fit->powerCoefficient = exp(logPowerCoefficient);
+    double logLinearithmicCoefficient = sumOffset / m;
+    fit->linearithmicCoefficient = exp(logLinearithmicCoefficient);
+
+    double meanY = sumY / m;
+    double total = 0.0, powerResidual = 0.0, linearithmicResidual = 0.0;
+    for (int s = 0; s < count; s++) {
+        if (times[s] <= 0.0 || sizes[s] < 2) continue;
+        double x = log((double)sizes[s]);
+        double y = log(times[s]);
+        double powerError = y - (logPowerCoefficient + fit->exponent * x);
+        double linearithmicError = y - (logLinearithmicCoefficient + log(sizes[s] * log2((double)sizes[s])));
+        total += (y - meanY) * (y - meanY);
+        powerResidual += powerError * powerError;
+        linearithmicResidual += linearithmicError * linearithmicError;
+    }
+    // Equal times are explained perfectly by a flat power law and not at all by N log N
+    fit->powerRSquared = total > 0.0 ? 1.0 - powerResidual / total : 1.0;
+    fit->linearithmicRSquared = total > 0.0 ? 1.0 - linearithmicResidual / total : 0.0;
+}
+void analyzeSweep(const char *label, const int *sizes, int sizesCount, const double *sweepTimes) {
+    // The sizes in increasing order, so that neighbours bracket the crossovers
+    int order[MAX_BATCH_SIZES];
+    int orderedSizes[MAX_BATCH_SIZES];
+    for (int s = 0; s < sizesCount; s++) {
+        order[s] = s;
+    }
+    for (int s = 1; s < sizesCount; s++) {
+        int current = order[s];
+        int j = s - 1;
+        while (j >= 0 && sizes[order[j]] > sizes[current]) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = current;
+    }
+    for (int s = 0; s < sizesCount; s++) {
+        orderedSizes[s] = sizes[order[s]];
+    }
+
+    printf("\n\nScaling (%s): fits of c*N^k and c*N*log2(N), R^2 on log scales", label);
+    printf("\n-------------------------------------------------------------------------------------------------");
+    printf("\n|       Algorithm      | Sizes |    k    | R^2 N^k | c N log N (ns) | R^2 N log N |  Best model  |");
+    printf("\n-------------------------------------------------------------------------------------------------");
+    double times[MAX_BATCH_SIZES];
+    for (int i = 0; i < algorithmsSize; i++) {
+        for (int s = 0; s < sizesCount; s++) {
+            times[s] = sweepTimes[i * MAX_BATCH_SIZES + order[s]];
+        }
+        ScalingFit fit;
+        fitScaling(orderedSizes, times, sizesCount, &fit);
+        if (fit.sizesCount < 2) continue;
+
+        // N log N is the better model unless the free exponent explains clearly more
+        char model[16];
+        if (fit.linearithmicRSquared >= fit.powerRSquared - 0.01) {
+            strcpy(model, "N log N");
+        } else {
+            snprintf(model, sizeof(model), "N^%.2lf", fit.exponent);
+        }
+        printf("\n| %20s | %5d | %7.3lf | %7.4lf | %14.3lf | %11.4lf | %-12s |", algorithms[i].name, fit.sizesCount,
+            fit.exponent, fit.powerRSquared, fit.linearithmicCoefficient * 1e9, fit.linearithmicRSquared, model);
+    }
+    printf("\n-------------------------------------------------------------------------------------------------");
+
+    // A crossover is where the log of the ratio of two times changes sign between neighbouring sizes
+    printf("\nCrossovers (%s):", label);
+    int crossovers = 0;
+    for (int a = 0; a < algorithmsSize; a++) {
+        for (int b = a + 1; b < algorithmsSize; b++) {
+            int previous = -1;
+            double previousRatio = 0.0;
+            for (int s = 0; s < sizesCount; s++) {
+                double timeA = sweepTimes[a * MAX_BATCH_SIZES + order[s]];
+                double timeB = sweepTimes[b * MAX_BATCH_SIZES + order[s]];
+                if (timeA <= 0.0 || timeB <= 0.0) continue;
+                double ratio = log(timeA / timeB);
+                if (previous >= 0 && ((previousRatio < 0.0 && ratio > 0.0) || (previousRatio > 0.0 && ratio < 0.0))) {
+                    double low = log((double)orderedSizes[previous]);
+                    double high = log((double)orderedSizes[s]);
+                    double crossover = exp(low + (high - low) * previousRatio / (previousRatio - ratio));
+                    int smallWinner = previousRatio < 0.0 ? a : b;
+                    int largeWinner = previousRatio < 0.0 ? b : a;
+                    printf("\n  N ~ %.0lf: %s is faster below, %s above (between N = %d and %d)", crossover,
+                        algorithms[smallWinner].name, algorithms[largeWinner].name, orderedSizes[previous], orderedSizes[s]);
+                    crossovers++;
+                }
+                previous = s;
+                previousRatio = ratio;
+            }
+        }
+    }
+    if (crossovers == 0) {
+        printf("\n  None within the sizes of the sweep");
+    }
+}
+void loadCutoffProfile(BatchConfig *config, const char *filename) {
+    // A missing profile is not an error, the built-in cutoffs are used
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) return;
+    fclose(file);
+    if (loadBatchConfigFile(config, filename)) {
+        printf("Cutoffs loaded from %s\n", filename);
+    }
+}
+double timeTuningRun(const SortingAlgorithm *algorithm, const unsigned long int *keys, int n) {
+    int repetitions = benchmarkOptions.repetitions > TUNING_MIN_REPETITIONS ? benchmarkOptions.repetitions : TUNING_MIN_REPETITIONS;
+    double *samples = (double *)malloc(repetitions * sizeof(double));
+    unsigned long int *array = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    if (samples == NULL || array == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    double frequency = getTimerFrequency();
+    int isSorted = 1;
+    for (int r = 0; r < repetitions && isSorted; r++) {
+        memcpy(array, keys, n * sizeof(unsigned long int));
+        uint64_t startTicks = readTimer();
+        algorithm->function(array, n);
+        samples[r] = (readTimer() - startTicks) / frequency;
+        isSorted = findUnsortedIndex(array, n, ELEMENT_U64) < 0;
+    }
+    double median = isSorted ? computeBenchmarkStats(samples, repetitions).median : -1.0;
+    free(array);
+    free(samples);
+    return median;
+}
+int runTuning(const BatchConfig *config) {
+    int n = DEFAULT_TUNING_SIZE;
+    for (int s = 0; s < config->sizesCount; s++) {
+        if (s == 0 || config->sizes[s] > n) n = config->sizes[s];
+    }
+
+    prepareMeasurement();
+    printf("\nTuning the cutoffs on %d random keys (seed %llu)", n, (unsigned long long)generatorOptions.seed);
+    unsigned long int *keys = generateData(0, n);
+    if (keys == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < tunableCutoffsSize; i++) {
+        TunableCutoff *tunable = &tunableCutoffs[i];
+        int algorithm = findAlgorithmByKey(tunable->algorithmKey);
+        if (algorithm < 0) continue;
+        if (tunable->isParallel && benchmarkOptions.threads < 2) {
+            printf("\n\n%s: kept at %d, it only matters with more than one thread", tunable->key, *tunable->value);
+            continue;
+        }
+
+        printf("\n\n%s (%s):", tunable->key, algorithms[algorithm].name);
+        int best = *tunable->value;
+        double bestTime = -1.0;
+        for (int c = 0; c < tunable->candidatesCount; c++) {
+            *tunable->value = tunable->candidates[c];
+            double time = timeTuningRun(&algorithms[algorithm], keys, n);
+            if (time < 0.0) {
+                fprintf(stderr, "\n%s = %d does not sort, skipped", tunable->key, tunable->candidates[c]);
+                continue;
+            }
+            printf("\n  %6d  %.9lfsecs", tunable->candidates[c], time);
+            if (bestTime < 0.0 || time < bestTime) {
+                best = tunable->candidates[c];
+                bestTime = time;
+            }
+        }
+        *tunable->value = best;
+        printf("\n  Chosen: %d", best);
+    }
+    free(keys);
+
+    FILE *file = fopen(config->profileFile, "w");
+    if (file == NULL) {
+        fprintf(stderr, "Error opening file: %s\n", config->profileFile);
+        return EXIT_FAILURE;
+    }
+    fprintf(file, "# Cutoffs tuned on %d random keys by --tune. Loaded at startup, or with --profile FILE.\n", n);
+    fprintf(file, "# %s\n", getRunMetadata());
+    for (int i = 0; i < tunableCutoffsSize; i++) {
+        fprintf(file, "%s = %d\n", tunableCutoffs[i].key, *tunableCutoffs[i].value);
+    }
+    fclose(file);
+    printf("\n\nCutoffs saved to %s\n", config->profileFile);
+    return EXIT_SUCCESS;
+}
+int runSelfTest(const BatchConfig *config) {
+    // Workers well past the processor count, so tasks interleave even on small machines
+    const int threadCounts[] = {2, 8, 32};
+    const char *generatorKeys[] = {"few-unique", "equal", "sawtooth", "organ-pipe", "random", "sample-killer", "quick-killer"};
+    int threadCountsCount = sizeof(threadCounts)/sizeof(threadCounts[0]);
+    int generatorKeysCount = sizeof(generatorKeys)/sizeof(generatorKeys[0]);
+
+    int n = SELF_TEST_SIZE;
+    for (int s = 0; s < config->sizesCount; s++) {
+        if (s == 0 || config->sizes[s] > n) n = config->sizes[s];
+    }
+    BenchmarkOptions savedOptions = benchmarkOptions;
+    unsigned long int savedUniqueCount = generatorOptions.uniqueCount;
+    benchmarkOptions.grainSize = SELF_TEST_GRAIN_SIZE;
+    generatorOptions.uniqueCount = SELF_TEST_UNIQUE_COUNT;
+
+    unsigned long int *sorted = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    unsigned long int *array = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    if (sorted == NULL || array == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    int failures = 0;
+    printf("\nSelf-test on %d keys, grain %d", n, benchmarkOptions.grainSize);
+    for (int g = 0; g < generatorKeysCount; g++) {
+        int method = 0;
+        while (method < dataGeneratorsSize && strcmp(dataGenerators[method].key, generatorKeys[g]) != 0) {
+            method++;
+        }
+        unsigned long int *keys;
+        if (method < dataGeneratorsSize) {
+            keys = generateData(method, n);
+        } else if (strcmp(generatorKeys[g], "sample-killer") == 0) {
+            keys = generateSampleSortKiller(n);
+        } else {
+            keys = generateQuickSortKiller(n);
+            if (keys == NULL) {
+                printf("\n  %-13s skipped, N = %d is too large for its keys", generatorKeys[g], n);
+                continue;
+            }
+        }
+        if (keys == NULL) {
+            perror("Memory allocation failed");
+            exit(EXIT_FAILURE);
+        }
+        // The reference is the serial merge sort, which shares no code with the parallel sorts
+        memcpy(sorted, keys, n * sizeof(unsigned long int));
+        bottomUpMergeSort(sorted, n);
+
+        for (int a = 0; a < algorithmsSize; a++) {
+            if (!algorithms[a].isParallel) continue;
+            for (int t = 0; t < threadCountsCount; t++) {
+                benchmarkOptions.threads = threadCounts[t];
+                memcpy(array, keys, n * sizeof(unsigned long int));
+                // The time shows an input that makes an algorithm quadratic
+                double startTime = getTimeInSeconds();
+                algorithms[a].function(array, n);
+                double time = getTimeInSeconds() - startTime;
+                int isSorted = memcmp(array, sorted, n * sizeof(unsigned long int)) == 0;
+                if (!isSorted) {
+                    failures++;
+                }
+                printf("\n  %-13s %-22s %2d threads: %-6s %.6lfsecs", generatorKeys[g], algorithms[a].name, threadCounts[t],
+                    isSorted ? "ok" : "FAILED", time);
+            }
+        }
+        free(keys);
+    }
+    free(array);
+    free(sorted);
+    benchmarkOptions = savedOptions;
+    generatorOptions.uniqueCount = savedUniqueCount;
+
+    if (failures > 0) {
+        fprintf(stderr, "\n%d self-test run(s) produced unsorted output\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("\n\nAll self-test runs sorted their input\n");
+    return EXIT_SUCCESS;
+}
+unsigned long int *generateSampleSortKiller(int n) {
+    unsigned long int *array = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    if (array == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) {
+        array[i] = ULONG_MAX - (unsigned long int)(i % 1000);
+    }
+
+    // Replay the draws of parallelSampleSort(). Fewer buckets draw a prefix of the same sequence.
+    RandomGenerator rng;
+    randomSeed(&rng, DEFAULT_SEED, (uint64_t)n);
+    for (int i = 0; i < SAMPLE_SORT_MAX_BUCKETS * SAMPLE_SORT_OVERSAMPLING; i++) {
+        uint64_t index = randomNext(&rng) % (uint64_t)n;
+        array[index] = index;
+    }
+    return array;
+}
+unsigned long int *generateQuickSortKiller(int n) {
+    // Each key is value * N + position, so it remembers where it started. Undecided keys have the
+    // value N, above all others: the partitions only compare keys with the pivot, so they all
+    // stay on its right.
+    unsigned long int size = (unsigned long int)n;
+    if (n < 1 || (double)size * (size + 1) > (double)ULONG_MAX) {
+        return NULL;
+    }
+    unsigned long int *keys = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    unsigned long int *array = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    if (keys == NULL || array == NULL) {
+        free(keys);
+        free(array);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) {
+        keys[i] = size * size + i;
+    }
+
+    // Replay the loop of parallelQuickSortTask(). The first and middle keys of the range become the
+    // two smallest, so the median of three is the second smallest and only one key goes left.
+    unsigned long int value = 0;
+    int low = 0, high = n - 1;
+    while (high - low + 1 > benchmarkOptions.grainSize) {
+        int mid = low + (high - low) / 2;
+        keys[low] = value++ * size + keys[low] % size;
+        keys[mid] = value++ * size + keys[mid] % size;
+        int pivotIndex = hoarePartition(keys, low, high, medianIndex(keys, low, mid, high));
+        if (pivotIndex - low < high - pivotIndex) {
+            low = pivotIndex + 1;
+        } else {
+            high = pivotIndex - 1;
+        }
+    }
+
+    // The keys left undecided come after the others, in the order of their positions
+    for (int i = 0; i < n; i++) {
+        array[keys[i] % size] = keys[i] / size;
+    }
+    for (int i = 0; i < n; i++) {
+        if (array[i] == size) {
+            array[i] = value + i;
+        }
+    }
+    free(keys);
+    return array;
+}
+
+/*
+*
+* SELECTION
+*
+*/
+void introSelect(unsigned long int *array, int n, int k) {
+    // Depth limit of 2*floor(log2(N)), as in the introspective sorts
+    int depthLimit = 0;
+    for (int size = n; size > 1; size >>= 1) {
+        depthLimit += 2;
+    }
+    introSelectHelper(array, 0, n - 1, k - 1, depthLimit);
+}
+void introSelectHelper(unsigned long int *array, int low, int high, int target, int depthLimit) {
+    while (high - low + 1 > cutoffs.quickSortCutoff) {
+        if (depthLimit-- == 0) {
+            // The partitions keep failing to shrink the range, the heap bounds the rest to O(N log k)
+            heapSelect(array + low, high - low + 1, target - low + 1);
+
+            // The root of the heap is the largest of the selected keys, the one that belongs at target
+            COUNT_SWAP();
+            unsigned long int temp = array[low];
+            array[low] = array[target];
+            array[target] = temp;
+            return;
+        }
+
+        // Only the side holding the target is partitioned further. Hoare partitioning splits runs
+        // of equal keys down the middle, so few distinct keys do not degrade to one key per step.
+        int pivotIndex = hoarePartition(array, low, high, medianIndex(array, low, low + (high - low) / 2, high));
+        if (pivotIndex == target) return;
+        if (target < pivotIndex) {
+            high = pivotIndex - 1;
+        } else {
+            low = pivotIndex + 1;
+        }
+    }
+    insertionSort(array + low, high - low + 1);
+}
+void heapSelect(unsigned long int *array, int n, int k) {
+    // Max heap of the k smallest keys seen so far, its root the largest of them
+    for (int i = k / 2 - 1; i >= 0; i--) {
+        heapify(array, k, i);
+    }
+
+    // A smaller key replaces the root, which goes to the key's place in the rest of the array
+    for (int i = k; i < n; i++) {
+        if (COUNT_COMPARISON(array[i] < array[0])) {
+            COUNT_SWAP();
+            unsigned long int temp = array[0];
+            array[0] = array[i];
+            array[i] = temp;
+            heapify(array, k, 0);
+        }
+    }
+}
+void heapTopK(unsigned long int *array, int n, int k) {
+    heapSelect(array, n, k);
+
+    // Extract the k keys from the heap as heapSort() does
+    for (int i = k - 1; i > 0; i--) {
+        COUNT_SWAP();
+        unsigned long int temp = array[0];
+        array[0] = array[i];
+        array[i] = temp;
+        heapify(array, i, 0);
+    }
+}
+void partialQuickSort(unsigned long int *array, int n, int k) {
+    int depthLimit = 0;
+    for (int size = n; size > 1; size >>= 1) {
+        depthLimit += 2;
+    }
+    partialQuickSortHelper(array, 0, n - 1, k, depthLimit);
+}
+void partialQuickSortHelper(unsigned long int *array, int low, int high, int k, int depthLimit) {
+    // Ranges starting at or after index k hold none of the wanted keys
+    while (low < k && high - low + 1 > cutoffs.quickSortCutoff) {
+        if (depthLimit-- == 0) {
+            int last = high < k - 1 ? high : k - 1;
+            heapTopK(array + low, high - low + 1, last - low + 1);
+            return;
+        }
+        int pivotIndex = hoarePartition(array, low, high, medianIndex(array, low, low + (high - low) / 2, high));
+        partialQuickSortHelper(array, low, pivotIndex - 1, k, depthLimit);
+        low = pivotIndex + 1;
+    }
+    if (low < k) {
+        insertionSort(array + low, high - low + 1);
+    }
+}
+void selectAndSort(unsigned long int *array, int n, int k) {
+    introSelect(array, n, k);
+
+    // The kth key is already in place, only the keys before it are sorted
+    if (k > 1) {
+        blockQuickSort(array, k - 1);
+    }
+}
+void fullSortSelect(unsigned long int *array, int n, int k) {
+    (void)k;
+    blockQuickSort(array, n);
+}
+int selectionSize(double selection, int n) {
+    double k = selection < 1.0 ? selection * n : selection;
+    if (k < 1.0) return 1;
+    if (k > n) return n;
+    return (int)k;
+}
+int verifySelection(const SelectionEngine *engine, const unsigned long int *output, const unsigned long int *sorted,
+    int n, int k, uint64_t checksum) {
+    if (checksumElements(output, n, ELEMENT_U64) != checksum) {
+        fprintf(stderr, "\n[%s] VERIFICATION FAILED: the output elements differ from the input (N = %d, k = %d)\n",
+            engine->name, n, k);
+        return 0;
+    }
+
+    if (engine->isOrdered) {
+        for (int i = 0; i < k; i++) {
+            if (output[i] != sorted[i]) {
+                fprintf(stderr, "\n[%s] VERIFICATION FAILED: element %d is not the %d%s smallest key (N = %d, k = %d)\n",
+                    engine->name, i, i + 1, i == 0 ? "st" : i == 1 ? "nd" : i == 2 ? "rd" : "th", n, k);
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    // With the kth key in place and nothing on the wrong side of it, the first k are the k smallest
+    unsigned long int kth = sorted[k - 1];
+    int misplaced = output[k - 1] != kth ? k - 1 : -1;
+    for (int i = 0; i < n && misplaced < 0; i++) {
+        if (i < k ? output[i] > kth : output[i] < kth) {
+            misplaced = i;
+        }
+    }
+    if (misplaced >= 0) {
+        fprintf(stderr, "\n[%s] VERIFICATION FAILED: element %d is on the wrong side of the kth smallest key (N = %d, k = %d)\n",
+            engine->name, misplaced, n, k);
+        return 0;
+    }
+    return 1;
+}
+void measureSelection(const SelectionEngine *engine, const unsigned long int *keys, const unsigned long int *sorted,
+    int n, int k, uint64_t checksum, SortingAlgorithm *result) {
+    unsigned long int *array = (unsigned long int *)allocateSampleBuffer(n * sizeof(unsigned long int));
+    double *samples = (double *)malloc(benchmarkOptions.repetitions * sizeof(double));
+    if (samples == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    double frequency = getTimerFrequency();
+
+    for (int w = 0; w < benchmarkOptions.warmups; w++) {
+        memcpy(array, keys, n * sizeof(unsigned long int));
+        engine->function(array, n, k);
+    }
+
+    int isValid = 1;
+    for (int r = 0; r < benchmarkOptions.repetitions; r++) {
+        memcpy(array, keys, n * sizeof(unsigned long int));
+        if (benchmarkOptions.isColdCache) {
+            flushCaches();
+        }
+        uint64_t startTicks = readTimer();
+        engine->function(array, n, k);
+        samples[r] = (readTimer() - startTicks) / frequency;
+
+        if (isValid && !verifySelection(engine, array, sorted, n, k, checksum)) {
+            isValid = 0;
+        }
+    }
+
+    // The statistics sort the samples, the results keep them in the order they were taken
+    memcpy(result->samples, samples, benchmarkOptions.repetitions * sizeof(double));
+    result->stats = computeBenchmarkStats(samples, benchmarkOptions.repetitions);
+    result->time = result->stats.median;
+    result->throughput = result->time > 0.0 ? n * sizeof(unsigned long int) / result->time : 0.0;
+    result->status = isValid ? RUN_OK : RUN_INVALID;
+    freeSampleBuffer(array, n * sizeof(unsigned long int));
+    free(samples);
+}
+void runSelectionCell(const BatchConfig *config, const char *source, const char *seed, const unsigned long int *keys, int n) {
+    if (benchmarkOptions.elementType != ELEMENT_U64) {
+        printf("\nSkipped, the selection engines only run on %s keys", elementTypes[ELEMENT_U64].key);
+        return;
+    }
+
+    prepareMeasurement();
+
+    // The reference answer for every k, sorted once outside the timers
+    unsigned long int *sorted = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    double *samples = (double *)malloc(benchmarkOptions.repetitions * sizeof(double));
+    if (sorted == NULL || samples == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(sorted, keys, n * sizeof(unsigned long int));
+    blockQuickSort(sorted, n);
+    uint64_t checksum = checksumElements(keys, n, ELEMENT_U64);
+
+    for (int s = 0; s < config->selectionsCount; s++) {
+        int k = selectionSize(config->selections[s], n);
+        printf("\n\nk = %d (k/N = %.6lf)", k, (double)k / n);
+        printf("\n-----------------------------------------------------------------------------------------------------------------");
+        printf("\n|        Engine        |      Min      |     Median    |      Mean     |     Stddev    |      P95      | vs Sort |");
+        printf("\n-----------------------------------------------------------------------------------------------------------------");
+
+        double sortTime = 0.0;
+        // The cheapest engine overall, and the cheapest that also sorts the k keys
+        int cheapest = -1, cheapestOrdered = -1;
+        double cheapestTime = 0.0, cheapestOrderedTime = 0.0;
+        for (int e = 0; e < selectionEnginesSize; e++) {
+            // The results store keys the cells by algorithm name, so the name carries k
+            char name[64];
+            snprintf(name, sizeof(name), "%s (k=%d)", selectionEngines[e].name, k);
+            SortingAlgorithm result;
+            memset(&result, 0, sizeof(result));
+            result.name = name;
+            result.samples = samples;
+            measureSelection(&selectionEngines[e], keys, sorted, n, k, checksum, &result);
+
+            BenchmarkStats *stats = &result.stats;
+            if (result.status != RUN_OK) {
+                invalidRunsCount++;
+                printf("\n| %20s | %-7s %-80s |", selectionEngines[e].name, runStatusNames[result.status], "");
+                appendStringToFile(config->resultsFile, "%d,%s,%s,%s,%s,1,0,%d,,,,,,,,,,,,,,,%s,,,,,,,,%.0lf,0,\n", n, source, seed,
+                    elementTypes[ELEMENT_U64].key, name, benchmarkOptions.warmups, runStatusNames[result.status], passBytes(ELEMENT_U64, n));
+            } else {
+                if (e == 0) {
+                    sortTime = stats->median;
+                }
+                double speedup = stats->median > 0.0 ? sortTime / stats->median : 0.0;
+                printf("\n| %20s | %14.9lf| %14.9lf| %14.9lf| %14.9lf| %14.9lf| %7.2lf |", selectionEngines[e].name,
+                    stats->min, stats->median, stats->mean, stats->stddev, stats->p95, speedup);
+                // The speedup column is over the full sort, the counter and memory columns are left empty
+                appendStringToFile(config->resultsFile, "%d,%s,%s,%s,%s,1,%d,%d,%.9lf,%.9lf,%.9lf,%.9lf,%.9lf,%.6lf,,,,,,,,,ok,,,,,,%.0lf,%.0lf,%.0lf,0,\n",
+                    n, source, seed, elementTypes[ELEMENT_U64].key, name, stats->samples, benchmarkOptions.warmups,
+                    stats->min, stats->median, stats->mean, stats->stddev, stats->p95, speedup, result.throughput,
+                    stats->median > 0.0 ? n / stats->median : 0.0, passBytes(ELEMENT_U64, n));
+                if (cheapest < 0 || stats->median < cheapestTime) {
+                    cheapest = e;
+                    cheapestTime = stats->median;
+                }
+                if (selectionEngines[e].isOrdered && (cheapestOrdered < 0 || stats->median < cheapestOrderedTime)) {
+                    cheapestOrdered = e;
+                    cheapestOrderedTime = stats->median;
+                }
+            }
+            appendJsonResult(config->jsonFile, source, seed, n, &result, 1);
+        }
+        printf("\n-----------------------------------------------------------------------------------------------------------------");
+        if (cheapest >= 0) {
+            printf("\nCheapest for k = %d: %s", k, selectionEngines[cheapest].name);
+            if (cheapest == 0) {
+                printf(" (baseline)");
+            } else if (cheapestTime > 0.0 && sortTime > 0.0) {
+                printf(", %.2lf times faster than sorting all %d keys", sortTime / cheapestTime, n);
+            }
+        }
+        if (cheapestOrdered >= 0 && cheapestOrdered != cheapest) {
+            printf("\nCheapest with the k keys sorted: %s", selectionEngines[cheapestOrdered].name);
+            // The full sort is the baseline the others are measured against
+            if (cheapestOrdered == 0) {
+                printf(" (baseline)");
+            } else if (cheapestOrderedTime > 0.0 && sortTime > 0.0) {
+                printf(", %.2lf times faster", sortTime / cheapestOrderedTime);
+            }
+        }
+    }
+    free(sorted);
+    free(samples);
+}
+
+/*
+*
+* MEASUREMENT
+*
+*/
+void prepareMeasurement(void) {
+    static int isPrepared = 0;
+    if (isPrepared) return;
+    isPrepared = 1;
+
+    // Calibrate before any sample is taken, the calibration itself takes a moment
+    getTimerFrequency();
+
+    // The allowed processors are read before the benchmark thread is pinned to one of them
+    const int *processors;
+    getAllowedProcessors(&processors);
+
+    if (benchmarkOptions.pinProcessor >= 0 && !pinCurrentThread(benchmarkOptions.pinProcessor)) {
+        fprintf(stderr, "\nCould not pin the benchmark to processor %d", benchmarkOptions.pinProcessor);
+    }
+
+    #ifdef __GLIBC__
+        // Memory the sorts free stays in the heap, so the scratch buffers the warm-ups fault in
+        // are reused by the timed runs instead of being unmapped and faulted in again
+        if (benchmarkOptions.isPrefaulting) {
+            mallopt(M_MMAP_MAX, 0);
+            mallopt(M_TRIM_THRESHOLD, INT_MAX);
+        }
+    #endif
+}
+double getTimerFrequency(void) {
+    static double frequency = 0.0;
+    if (frequency > 0.0) return frequency;
+
+    #if defined(TSC_TIMER)
+        // The time stamp counter is only a clock when it ticks at a constant rate in every power state
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1u << 8))) {
+            timerSource = TIMER_TSC;
+
+            // Count the ticks over TIMER_CALIBRATION_TIME of the monotonic clock, several times,
+            // and keep the median rate
+            double rates[TIMER_CALIBRATION_ROUNDS];
+            for (int round = 0; round < TIMER_CALIBRATION_ROUNDS; round++) {
+                double startTime = getTimeInSeconds();
+                uint64_t startTicks = readTimer();
+                double endTime;
+                do {
+                    endTime = getTimeInSeconds();
+                } while (endTime - startTime < TIMER_CALIBRATION_TIME);
+                uint64_t endTicks = readTimer();
+                rates[round] = (endTicks - startTicks) / (endTime - startTime);
+            }
+            frequency = computeBenchmarkStats(rates, TIMER_CALIBRATION_ROUNDS).median;
+            return frequency;
+        }
+    #endif
+
+    #ifdef _WIN32
+        LARGE_INTEGER counterFrequency;
+        QueryPerformanceFrequency(&counterFrequency);
+        frequency = (double)counterFrequency.QuadPart;
+    #else
+        frequency = 1e9;
+    #endif
+    return frequency;
+}
+uint64_t readTimer(void) {
+    #if defined(TSC_TIMER)
+        if (timerSource == TIMER_TSC) {
+            // RDTSCP waits for the earlier instructions, the fence keeps the later ones after it
+            unsigned int processor;
+            uint64_t ticks = __rdtscp(&processor);
+            _mm_lfence();
+            return ticks;
+        }
+    #endif
+    #ifdef _WIN32
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return (uint64_t)counter.QuadPart;
+    #else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    #endif
+}
+void *allocateSampleBuffer(size_t size) {
+    if (size == 0) size = 1;
+    void *buffer = NULL;
+
+    #ifdef __linux__
+        if (benchmarkOptions.useHugePages) {
+            static int isReported = 0;
+            const char *report = "Input copies use reserved 2MB huge pages";
+            size_t mappedSize = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+
+            // Reserved huge pages first, then transparent ones, then regular pages
+            buffer = MAP_FAILED;
+            #ifdef MAP_HUGETLB
+                buffer = mmap(NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            #endif
+            if (buffer == MAP_FAILED) {
+                report = "Input copies use transparent 2MB huge pages";
+                buffer = mmap(NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (buffer == MAP_FAILED) {
+                    perror("Memory allocation failed");
+                    exit(EXIT_FAILURE);
+                }
+                #ifdef MADV_HUGEPAGE
+                    if (madvise(buffer, mappedSize, MADV_HUGEPAGE) != 0) {
+                        report = "Huge pages are unavailable, input copies use regular pages";
+                    }
+                #else
+                    report = "Huge pages are unavailable, input copies use regular pages";
+                #endif
+            }
+            if (!isReported) {
+                printf("\n%s", report);
+                isReported = 1;
+            }
+        }
+    #endif
+    if (buffer == NULL) {
+        buffer = malloc(size);
+        if (buffer == NULL) {
+            perror("Memory allocation failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Touch every page so none is faulted in while a sort is timed
+    if (benchmarkOptions.isPrefaulting || benchmarkOptions.useHugePages) {
+        for (size_t offset = 0; offset < size; offset += PAGE_SIZE_BYTES) {
+            ((volatile char *)buffer)[offset] = 0;
+        }
+    }
+    return buffer;
+}
+void freeSampleBuffer(void *buffer, size_t size) {
+    #ifdef __linux__
+        if (benchmarkOptions.useHugePages) {
+            if (size == 0) size = 1;
+            munmap(buffer, (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+            return;
+        }
+    #endif
+    free(buffer);
+}
+size_t getLastLevelCacheSize(void) {
+    long size = -1;
+    #ifdef _SC_LEVEL3_CACHE_SIZE
+        size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        if (size <= 0) {
+            size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        }
+    #endif
+    return size > 0 ? (size_t)size : DEFAULT_LLC_SIZE;
+}
+void flushCaches(void) {
+    static unsigned char *evictionBuffer = NULL;
+    static size_t evictionSize = 0;
+    if (evictionBuffer == NULL) {
+        evictionSize = 2 * getLastLevelCacheSize();
+        evictionBuffer = (unsigned char *)malloc(evictionSize);
+        if (evictionBuffer == NULL) {
+            perror("Memory allocation failed");
+            exit(EXIT_FAILURE);
+        }
+        memset(evictionBuffer, 0, evictionSize);
+    }
+
+    // Writing a line of a buffer twice the size of the cache evicts what the sort would find there,
+    // and writes back the dirty lines of the restored input
+    for (size_t offset = 0; offset < evictionSize; offset += CACHE_LINE_SIZE) {
+        ((volatile unsigned char *)evictionBuffer)[offset]++;
+    }
+}
+
+/*
+*
+* SORTING ALGORITHMS
+*
+*/
+void selectionSort(unsigned long int *array, int n) {
+    for (int i = 0; i < n - 1; i++) {
+        int minIndex = i;
+        for (int j = i + 1; j < n; j++) {
+            if (COUNT_COMPARISON(array[j] < array[minIndex])) {
+                minIndex = j;
+            }
+        }
+        // Swap
+        COUNT_SWAP();
+        unsigned long int temp = array[i];
+        array[i] = array[minIndex];
+        array[minIndex] = temp;
+    }
+}
+void bubbleSort(unsigned long int *array, int n) {
+    for (int i = 0; i < n - 1; i++) {
+        int swapped = 0;
+        for (int j = 0; j < n - i - 1; j++) {
+            if (COUNT_COMPARISON(array[j] > array[j + 1])) {
+                // Swap
+                COUNT_SWAP();
+                unsigned long int temp = array[j];
+                array[j] = array[j + 1];
+                array[j + 1] = temp;
+                swapped = 1;
+            }
+        }
+        // Stop if already sorted
+        if (!swapped) break;
+    }
+}
+void insertionSort(unsigned long int *array, int n) {
+    for (int i = 1; i < n; i++) {
+        // Store the current element
+        unsigned long int key = array[i];
+        int j = i - 1;
+
+        // Shift elements greater than key to the right
+        while (j >= 0 && COUNT_COMPARISON(array[j] > key)) {
+            array[j + 1] = array[j];
+            j--;
+        }
+
+        // Insert key at the correct position
+        array[j + 1] = key;
+        COUNT_WRITES(i - j);
+    }
+}
+void merge(unsigned long int *array, int left, int mid, int right) {
+    int leftSize = mid - left + 1;
+    int rightSize = right - mid;
+
+    // Allocate memory dynamically
+    unsigned long int *leftArray = (unsigned long int *)malloc(leftSize * sizeof(unsigned long int));
+    unsigned long int *rightArray = (unsigned long int *)malloc(rightSize * sizeof(unsigned long int));
+
+    // Check for memory allocation failure
+    if (leftArray == NULL || rightArray == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Copy data to temporary arrays, then every element is written back once
+    COUNT_WRITES(2 * (leftSize + rightSize));
+    for (int i = 0; i < leftSize; i++) {
+        leftArray[i] = array[left + i];
+    }
+    for (int j = 0; j < rightSize; j++) {
+        rightArray[j] = array[mid + 1 + j];
+    }
+
+    int i = 0, j = 0, k = left;
+    // Merge the temporary arrays back into the main array
+    while (i < leftSize && j < rightSize) {
+        if (COUNT_COMPARISON(leftArray[i] <= rightArray[j])) {
+            array[k++] = leftArray[i++];
+        } else {
+            array[k++] = rightArray[j++];
+        }
+    }
+
+    // Copy remaining elements of leftArray
+    while (i < leftSize) {
+        array[k++] = leftArray[i++];
+    }
+    // Copy remaining elements of rightArray
+    while (j < rightSize) {
+        array[k++] = rightArray[j++];
+    }
+
+    // Free dynamically allocated memory
+    free(leftArray);
+    free(rightArray);
+}
+void mergeSortHelper(unsigned long int *array, int left, int right) {
+    if (left < right) {
+        // Find the middle index
+        int mid = left + (right - left) / 2;
+
+        // Recursively sort first and second halves
+        mergeSortHelper(array, left, mid);
+        mergeSortHelper(array, mid + 1, right);
+
+        // Merge the sorted halves
+        merge(array, left, mid, right);
+    }
+}
+void mergeSort(unsigned long int *array, int n) {
+    mergeSortHelper(array, 0, n - 1);
+}
+void mergeInto(const unsigned long int *source, unsigned long int *target, int left, int mid, int right) {
+    int i = left, j = mid + 1, k = left;
+    COUNT_WRITES(right - left + 1);
+
+    // Take from the left run on ties to keep the sort stable
+    while (i <= mid && j <= right) {
+        if (COUNT_COMPARISON(source[i] <= source[j])) {
+            target[k++] = source[i++];
+        } else {
+            target[k++] = source[j++];
+        }
+    }
+
+    // Copy whichever run has elements remaining
+    while (i <= mid) {
+        target[k++] = source[i++];
+    }
+    while (j <= right) {
+        target[k++] = source[j++];
+    }
+}
+void mergeSortPingPongHelper(unsigned long int *source, unsigned long int *target, int left, int right) {
+    if (left < right) {
+        int mid = left + (right - left) / 2;
+
+        // Sort both halves into source, swapping the roles of the arrays at each level
+        mergeSortPingPongHelper(target, source, left, mid);
+        mergeSortPingPongHelper(target, source, mid + 1, right);
+
+        // Merge the sorted halves straight into target, nothing is copied back
+        mergeInto(source, target, left, mid, right);
+    }
+}
+void mergeSortWithBuffer(unsigned long int *array, int n, unsigned long int *buffer) {
+    if (n < 2) return;
+
+    // Both arrays start with the same contents so either can act as the source of a level
+    memcpy(buffer, array, n * sizeof(unsigned long int));
+    COUNT_WRITES(n);
+    mergeSortPingPongHelper(buffer, array, 0, n - 1);
+}
+void bufferedMergeSort(unsigned long int *array, int n) {
+    if (n < 2) return;
+
+    unsigned long int *buffer = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    if (buffer == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    mergeSortWithBuffer(array, n, buffer);
+    free(buffer);
+}
+void bottomUpMergeSort(unsigned long int *array, int n) {
+    if (n < 2) return;
+
+    unsigned long int *buffer = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    if (buffer == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    unsigned long int *source = array;
+    unsigned long int *target = buffer;
+    for (int width = 1; width < n; width *= 2) {
+        // Merge every pair of adjacent runs of the current width
+        for (int left = 0; left < n; left += 2 * width) {
+            int mid = left + width - 1;
+            int right = left + 2 * width - 1;
+            if (mid >= n - 1) {
+                // A lone run at the end is carried over unchanged
+                mid = n - 1;
+            }
+            if (right > n - 1) {
+                right = n - 1;
+            }
+            mergeInto(source, target, left, mid, right);
+        }
+
+        // The merged runs become the source of the next pass
+        unsigned long int *temp = source;
+        source = target;
+        target = temp;
+
+        if (width > INT_MAX / 2) break;
+    }
+
+    // After an odd number of passes the sorted data sits in the buffer
+    if (source != array) {
+        memcpy(array, source, n * sizeof(unsigned long int));
+        COUNT_WRITES(n);
+    }
+    free(buffer);
+}
+unsigned long int medianOfThree(unsigned long int *array, int low, int high) {
+    int mid = low + (high - low) / 2;
+    
+    // Arrange low, mid, high in sorted order
+    if (COUNT_COMPARISON(array[low] > array[mid])) {
+        COUNT_SWAP();
+        unsigned long int temp = array[low];
+        array[low] = array[mid];
+        array[mid] = temp;
+    }
+    if (COUNT_COMPARISON(array[low] > array[high])) {
+        COUNT_SWAP();
+        unsigned long int temp = array[low];
+        array[low] = array[high];
+        array[high] = temp;
+    }
+    if (COUNT_COMPARISON(array[mid] > array[high])) {
+        COUNT_SWAP();
+        unsigned long int temp = array[mid];
+        array[mid] = array[high];
+        array[high] = temp;
+    }
+    
+    // Median is now at mid, swap it with high so partitioning remains the same
+    COUNT_SWAP();
+    unsigned long int temp = array[mid];
+    array[mid] = array[high];
+    array[high] = temp;
+    
+    return array[high]; // Pivot value
+}
+int quickSortPartition(unsigned long int *array, int low, int high) {
+    // Choose the median-of-three as pivot
+    unsigned long int pivot = medianOfThree(array, low, high);
+    int i = low - 1;
+
+    for (int j = low; j < high; j++) {
+        // If current element is smaller than the pivot, swap
+        if (COUNT_COMPARISON(array[j] < pivot)) {
+            i++;
+            COUNT_SWAP();
+            unsigned long int temp = array[i];
+            array[i] = array[j];
+            array[j] = temp;
+        }
+    }
+
+    // Place pivot at its correct position
+    COUNT_SWAP();
+    unsigned long int temp = array[i + 1];
+    array[i + 1] = array[high];
+    array[high] = temp;
+
+    return i + 1;
+}
+void quickSortHelper(unsigned long int *array, int low, int high) {
+    if (low < high) {
+        // Partition the array and get the pivot index
+        int pivotIndex = quickSortPartition(array, low, high);
+        // Recursively sort elements before and after partition
+        quickSortHelper(array, low, pivotIndex - 1);
+        quickSortHelper(array, pivotIndex + 1, high);
+    }
+}
+int medianIndex(const unsigned long int *array, int a, int b, int c) {
+    if (COUNT_COMPARISON(array[a] < array[b])) {
+        if (COUNT_COMPARISON(array[b] < array[c])) return b;
+        return COUNT_COMPARISON(array[a] < array[c]) ? c : a;
+    }
+    if (COUNT_COMPARISON(array[a] < array[c])) return a;
+    return COUNT_COMPARISON(array[b] < array[c]) ? c : b;
+}
+int hoarePartition(unsigned long int *array, int low, int high, int pivotIndex) {
+    // Park the pivot at low, where it also stops the right-to-left scan
+    COUNT_SWAP();
+    unsigned long int pivot = array[pivotIndex];
+    array[pivotIndex] = array[low];
+    array[low] = pivot;
+
+    int i = low + 1, j = high;
+    while (1) {
+        while (i <= j && COUNT_COMPARISON(array[i] < pivot)) i++;
+        while (COUNT_COMPARISON(array[j] > pivot)) j--;
+        if (i >= j) break;
+
+        COUNT_SWAP();
+        unsigned long int temp = array[i];
+        array[i++] = array[j];
+        array[j--] = temp;
+    }
+
+    // Place pivot at its correct position
+    COUNT_SWAP();
+    array[low] = array[j];
+    array[j] = pivot;
+    return j;
+}
+int equalKeysPartition(unsigned long int *array, int low, int high, unsigned long int pivot) {
+    int i = low;
+    for (int j = low; j <= high; j++) {
+        if (COUNT_COMPARISON(array[j] == pivot)) {
+            COUNT_SWAP();
+            unsigned long int temp = array[i];
+            array[i++] = array[j];
+            array[j] = temp;
+        }
+    }
+    return i - 1;
+}
+void introSortHelper(unsigned long int *array, int low, int high, int depthLimit, int (*partition)(unsigned long int *, int, int, int),
+    int leafSize, void (*leafSort)(unsigned long int *, int)) {
+    while (high - low + 1 > leafSize) {
+        // Too many unbalanced partitions, heap sort guarantees O(N log N) for the rest
+        if (depthLimit-- == 0) {
+            heapSort(array + low, high - low + 1);
+            return;
+        }
+
+        // Median of three for small ranges, the median of three medians (ninther) for large ones
+        int size = high - low + 1;
+        int mid = low + size / 2;
+        int pivotIndex;
+        if (size > QUICK_SORT_NINTHER_THRESHOLD) {
+            int step = size / 8;
+            pivotIndex = medianIndex(array,
+                medianIndex(array, low, low + step, low + 2 * step),
+                medianIndex(array, mid - step, mid, mid + step),
+                medianIndex(array, high - 2 * step, high - step, high));
+        } else {
+            pivotIndex = medianIndex(array, low, mid, high);
+        }
+
+        // A pivot equal to the key before the range is the smallest key of the range. Every key
+        // equal to it is then in its final place, so runs of duplicates are removed in linear time.
+        if (low > 0 && COUNT_COMPARISON(array[low - 1] == array[pivotIndex])) {
+            low = equalKeysPartition(array, low, high, array[pivotIndex]) + 1;
+            continue;
+        }
+
+        int partitionIndex = partition(array, low, high, pivotIndex);
+
+        // Recurse into the smaller side and loop on the larger one to bound the stack to O(log N)
+        if (partitionIndex - low < high - partitionIndex) {
+            introSortHelper(array, low, partitionIndex - 1, depthLimit, partition, leafSize, leafSort);
+            low = partitionIndex + 1;
+        } else {
+            introSortHelper(array, partitionIndex + 1, high, depthLimit, partition, leafSize, leafSort);
+            high = partitionIndex - 1;
+        }
+    }
+    if (high > low) {
+        leafSort(array + low, high - low + 1);
+    }
+}
+void quickSort(unsigned long int *array, int n) {
+    // Depth limit of 2*floor(log2(N))
+    int depthLimit = 0;
+    for (int size = n; size > 1; size >>= 1) {
+        depthLimit += 2;
+    }
+    introSortHelper(array, 0, n - 1, depthLimit, hoarePartition, cutoffs.quickSortCutoff, insertionSort);
+}
+void lomutoQuickSort(unsigned long int *array, int n) {
+    quickSortHelper(array, 0, n - 1);
+}
+int blockPartition(unsigned long int *array, int low, int high, int pivotIndex) {
+    // Park the pivot at low
+    COUNT_SWAP();
+    unsigned long int pivot = array[pivotIndex];
+    array[pivotIndex] = array[low];
+    array[low] = pivot;
+
+    // array[low+1..left-1] < pivot and array[right+1..high] >= pivot, the rest is unpartitioned
+    int left = low + 1, right = high;
+    unsigned char offsetsLeft[PARTITION_BLOCK_SIZE];
+    unsigned char offsetsRight[PARTITION_BLOCK_SIZE];
+    int countLeft = 0, countRight = 0;
+    int startLeft = 0, startRight = 0;
+
+    while (right - left + 1 >= 2 * PARTITION_BLOCK_SIZE) {
+        // Record which keys of each block are on the wrong side. The comparison result is
+        // added to the count instead of branched on, so there is nothing to mispredict.
+        if (countLeft == 0) {
+            startLeft = 0;
+            for (int i = 0; i < PARTITION_BLOCK_SIZE; i++) {
+                offsetsLeft[countLeft] = (unsigned char)i;
+                countLeft += COUNT_COMPARISON(array[left + i] >= pivot);
+            }
+        }
+        if (countRight == 0) {
+            startRight = 0;
+            for (int i = 0; i < PARTITION_BLOCK_SIZE; i++) {
+                offsetsRight[countRight] = (unsigned char)i;
+                countRight += COUNT_COMPARISON(array[right - i] < pivot);
+            }
+        }
+
+        // Swap the misplaced keys pairwise in one batch
+        int count = countLeft < countRight ? countLeft : countRight;
+        for (int k = 0; k < count; k++) {
+            int i = left + offsetsLeft[startLeft + k];
+            int j = right - offsetsRight[startRight + k];
+            COUNT_SWAP();
+            unsigned long int temp = array[i];
+            array[i] = array[j];
+            array[j] = temp;
+        }
+        countLeft -= count;
+        countRight -= count;
+        startLeft += count;
+        startRight += count;
+
+        // A block with no misplaced keys left is done
+        if (countLeft == 0) left += PARTITION_BLOCK_SIZE;
+        if (countRight == 0) right -= PARTITION_BLOCK_SIZE;
+    }
+
+    // Fewer than three blocks remain, including any partly swapped one. Finish them one key at a time.
+    while (1) {
+        while (left <= right && COUNT_COMPARISON(array[left] < pivot)) left++;
+        while (left <= right && COUNT_COMPARISON(array[right] >= pivot)) right--;
+        if (left >= right) break;
+
+        COUNT_SWAP();
+        unsigned long int temp = array[left];
+        array[left++] = array[right];
+        array[right--] = temp;
+    }
+
+    // Place pivot at its correct position
+    COUNT_SWAP();
+    array[low] = array[left - 1];
+    array[left - 1] = pivot;
+    return left - 1;
+}
+void blockQuickSort(unsigned long int *array, int n) {
+    // Depth limit of 2*floor(log2(N))
+    int depthLimit = 0;
+    for (int size = n; size > 1; size >>= 1) {
+        depthLimit += 2;
+    }
+    introSortHelper(array, 0, n - 1, depthLimit, blockPartition, cutoffs.quickSortCutoff, insertionSort);
+}
+void heapify(unsigned long int *array, int n, int root) {
+    int largest = root;
+    int leftChild = 2 * root + 1;
+    int rightChild = 2 * root + 2;
+
+    // Check if left child is larger than root
+    if (leftChild < n && COUNT_COMPARISON(array[leftChild] > array[largest])) {
+        largest = leftChild;
+    }
+
+    // Check if right child is larger than the largest so far
+    if (rightChild < n && COUNT_COMPARISON(array[rightChild] > array[largest])) {
+        largest = rightChild;
+    }
+
+    // Swap and continue heapifying if root is not the largest
+    if (largest != root) {
+        COUNT_SWAP();
+        unsigned long int temp = array[root];
+        array[root] = array[largest];
+        array[largest] = temp;
+
+        heapify(array, n, largest);
+    }
+}
+void heapSort(unsigned long int *array, int n) {
+    // Build a max heap
+    for (int i = n / 2 - 1; i >= 0; i--) {
+        heapify(array, n, i);
+    }
+
+    // Extract elements one by one from heap
+    for (int i = n - 1; i > 0; i--) {
+        // Swap root (largest) with the last element
+        COUNT_SWAP();
+        unsigned long int temp = array[0];
+        array[0] = array[i];
+        array[i] = temp;
+
+        // Heapify the reduced heap
+        heapify(array, i, 0);
+    }
+}
+void bottomUpSiftDown(unsigned long int *heap, int n, int root, int arity) {
+    unsigned long int value = heap[root];
+    int hole = root;
+
+    // Move the hole down to a leaf, pulling up the largest child of each level
+    int firstChild;
+    while ((firstChild = arity * hole + 1) < n) {
+        // The grandchildren are needed on the next level whichever child wins
+        int firstGrandchild = arity * firstChild + 1;
+        int lastGrandchild = arity * (firstChild + arity - 1) + arity;
+        if (lastGrandchild > n) lastGrandchild = n;
+        for (int g = firstGrandchild; g < lastGrandchild; g += CACHE_LINE_SIZE / (int)sizeof(unsigned long int)) {
+            PREFETCH(&heap[g]);
+        }
+
+        int largest = firstChild;
+        int lastChild = firstChild + arity < n ? firstChild + arity : n;
+        for (int child = firstChild + 1; child < lastChild; child++) {
+            if (COUNT_COMPARISON(heap[child] > heap[largest])) {
+                largest = child;
+            }
+        }
+        heap[hole] = heap[largest];
+        COUNT_WRITES(1);
+        hole = largest;
+    }
+
+    // Climb back up to the place of the displaced key
+    while (hole > root) {
+        int parent = (hole - 1) / arity;
+        if (!COUNT_COMPARISON(heap[parent] < value)) break;
+        heap[hole] = heap[parent];
+        COUNT_WRITES(1);
+        hole = parent;
+    }
+    heap[hole] = value;
+    COUNT_WRITES(1);
+}
+void bottomUpHeapSortEngine(unsigned long int *heap, int n, int arity) {
+    // Build a max heap from the last internal node up
+    for (int i = (n - 2) / arity; i >= 0 && n > 1; i--) {
+        bottomUpSiftDown(heap, n, i, arity);
+    }
+
+    // Move the root behind the shrinking heap and sift the key it displaces
+    for (int i = n - 1; i > 0; i--) {
+        COUNT_SWAP();
+        unsigned long int temp = heap[0];
+        heap[0] = heap[i];
+        heap[i] = temp;
+        bottomUpSiftDown(heap, i, 0, arity);
+    }
+}
+void bottomUpHeapSort(unsigned long int *array, int n) {
+    bottomUpHeapSortEngine(array, n, 2);
+}
+void alignedHeapSort(unsigned long int *array, int n, int arity) {
+    if (n < 2) return;
+
+    // The children of node i sit at slot arity*(i+1) of the buffer, a multiple of arity
+    int keysPerLine = CACHE_LINE_SIZE / (int)sizeof(unsigned long int);
+    unsigned long int *buffer = (unsigned long int *)malloc((n + arity + keysPerLine) * sizeof(unsigned long int));
+    if (buffer == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    unsigned long int *aligned = (unsigned long int *)(((uintptr_t)buffer + CACHE_LINE_SIZE - 1) & ~(uintptr_t)(CACHE_LINE_SIZE - 1));
+    unsigned long int *heap = aligned + arity - 1;
+
+    memcpy(heap, array, n * sizeof(unsigned long int));
+    bottomUpHeapSortEngine(heap, n, arity);
+    memcpy(array, heap, n * sizeof(unsigned long int));
+    COUNT_WRITES(2 * (unsigned long long)n);
+    free(buffer);
+}
+void quaternaryHeapSort(unsigned long int *array, int n) {
+    alignedHeapSort(array, n, 4);
+}
+void octonaryHeapSort(unsigned long int *array, int n) {
+    alignedHeapSort(array, n, 8);
+}
+
+void mergeRanges(const unsigned long int *source, int leftStart, int leftEnd, int rightStart, int rightEnd, unsigned long int *target, int outStart) {
+    int i = leftStart, j = rightStart, k = outStart;
+    COUNT_WRITES((leftEnd - leftStart + 1) + (rightEnd - rightStart + 1));
+
+    // Take from the left range on ties to keep the sort stable
+    while (i <= leftEnd && j <= rightEnd) {
+        if (COUNT_COMPARISON(source[i] <= source[j])) {
+            target[k++] = source[i++];
+        } else {
+            target[k++] = source[j++];
+        }
+    }
+    while (i <= leftEnd) {
+        target[k++] = source[i++];
+    }
+    while (j <= rightEnd) {
+        target[k++] = source[j++];
+    }
+}
+
+/**
+ * The arguments of the parallel merge and sort tasks. They are copied into the task itself.
+*/
+typedef struct {
+    TaskPool *pool;
+    const unsigned long int *source;
+    unsigned long int *target;
+    int leftStart, leftEnd, rightStart, rightEnd, outStart;
+} ParallelMergeArguments;
+typedef struct {
+    TaskPool *pool;
+    unsigned long int *array;
+    unsigned long int *buffer;
+    int low, high;
+    // Partitions the quick sort may still make before it falls back to heap sort
+    int depthLimit;
+} ParallelSortArguments;
+
+void parallelMergeTask(void *argument) {
+    ParallelMergeArguments *arguments = (ParallelMergeArguments *)argument;
+    parallelMerge(arguments->pool, arguments->source, arguments->leftStart, arguments->leftEnd,
+        arguments->rightStart, arguments->rightEnd, arguments->target, arguments->outStart);
+}
+void parallelMerge(TaskPool *pool, const unsigned long int *source, int leftStart, int leftEnd, int rightStart, int rightEnd, unsigned long int *target, int outStart) {
+    int leftSize = leftEnd - leftStart + 1;
+    int rightSize = rightEnd - rightStart + 1;
+    if (leftSize + rightSize <= benchmarkOptions.grainSize || leftSize <= 0 || rightSize <= 0) {
+        mergeRanges(source, leftStart, leftEnd, rightStart, rightEnd, target, outStart);
+        return;
+    }
+
+    // Split the larger range at its middle and find where that element lands in the other one.
+    // Equal keys of the left range stay before those of the right range to keep the merge stable.
+    int leftSplit, rightSplit;
+    if (leftSize >= rightSize) {
+        leftSplit = leftStart + leftSize / 2;
+        unsigned long int value = source[leftSplit];
+        int low = rightStart, high = rightEnd + 1;
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (COUNT_COMPARISON(source[mid] < value)) low = mid + 1; else high = mid;
+        }
+        rightSplit = low;
+    } else {
+        rightSplit = rightStart + rightSize / 2;
+        unsigned long int value = source[rightSplit];
+        int low = leftStart, high = leftEnd + 1;
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (COUNT_COMPARISON(source[mid] <= value)) low = mid + 1; else high = mid;
+        }
+        leftSplit = low;
+    }
+    int outSplit = outStart + (leftSplit - leftStart) + (rightSplit - rightStart);
+
+    // Merge the lower parts as a task while this thread merges the upper parts
+    TaskGroup group = {0};
+    ParallelMergeArguments lower = {pool, source, target, leftStart, leftSplit - 1, rightStart, rightSplit - 1, outStart};
+    taskPoolSpawn(pool, &group, parallelMergeTask, &lower, sizeof(lower));
+    parallelMerge(pool, source, leftSplit, leftEnd, rightSplit, rightEnd, target, outSplit);
+    taskPoolWait(pool, &group);
+}
+void parallelQuickSortTask(void *argument) {
+    ParallelSortArguments *arguments = (ParallelSortArguments *)argument;
+    TaskPool *pool = arguments->pool;
+    unsigned long int *array = arguments->array;
+    int low = arguments->low;
+    int high = arguments->high;
+    int depthLimit = arguments->depthLimit;
+
+    TaskGroup group = {0};
+    while (high - low + 1 > benchmarkOptions.grainSize) {
+        // Too many unbalanced partitions, heap sort bounds the rest to O(N log N) as in introSortHelper()
+        if (depthLimit-- == 0) {
+            heapSort(array + low, high - low + 1);
+            taskPoolWait(pool, &group);
+            return;
+        }
+
+        int mid = low + (high - low) / 2;
+        int pivotIndex = hoarePartition(array, low, high, medianIndex(array, low, mid, high));
+
+        // Hand the smaller side to the pool and keep partitioning the larger one
+        ParallelSortArguments smaller = {pool, array, NULL, low, pivotIndex - 1, depthLimit};
+        if (pivotIndex - low < high - pivotIndex) {
+            low = pivotIndex + 1;
+        } else {
+            smaller.low = pivotIndex + 1;
+            smaller.high = high;
+            high = pivotIndex - 1;
+        }
+        taskPoolSpawn(pool, &group, parallelQuickSortTask, &smaller, sizeof(smaller));
+    }
+    // The serial introsort continues with what is left of the budget
+    introSortHelper(array, low, high, depthLimit, hoarePartition, cutoffs.quickSortCutoff, insertionSort);
+    taskPoolWait(pool, &group);
+}
+void parallelQuickSort(unsigned long int *array, int n) {
+    // Depth limit of 2*floor(log2(N)), shared by the tasks and their serial introsorts
+    int depthLimit = 0;
+    for (int size = n; size > 1; size >>= 1) {
+        depthLimit += 2;
+    }
+    TaskPool *pool = getTaskPool();
+    ParallelSortArguments arguments = {pool, array, NULL, 0, n - 1, depthLimit};
+    parallelQuickSortTask(&arguments);
+}
+void parallelMergeSortTask(void *argument) {
+    // Sorts buffer[low..high] into array[low..high], like mergeSortPingPongHelper()
+    ParallelSortArguments *arguments = (ParallelSortArguments *)argument;
+    TaskPool *pool = arguments->pool;
+    unsigned long int *source = arguments->buffer;
+    unsigned long int *target = arguments->array;
+    int low = arguments->low;
+    int high = arguments->high;
+
+    if (high - low + 1 <= benchmarkOptions.grainSize) {
+        mergeSortPingPongHelper(source, target, low, high);
+        return;
+    }
+
+    // Sort both halves into source, the first one as a task
+    int mid = low + (high - low) / 2;
+    TaskGroup group = {0};
+    ParallelSortArguments leftHalf = {pool, source, target, low, mid, 0};
+    ParallelSortArguments rightHalf = {pool, source, target, mid + 1, high, 0};
+    taskPoolSpawn(pool, &group, parallelMergeSortTask, &leftHalf, sizeof(leftHalf));
+    parallelMergeSortTask(&rightHalf);
+    taskPoolWait(pool, &group);
+
+    parallelMerge(pool, source, low, mid, mid + 1, high, target, low);
+}
+void parallelMergeSort(unsigned long int *array, int n) {
+    if (n < 2) return;
+
+    unsigned long int *buffer = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    if (buffer == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(buffer, array, n * sizeof(unsigned long int));
+    COUNT_WRITES(n);
+
+    ParallelSortArguments arguments = {getTaskPool(), array, buffer, 0, n - 1, 0};
+    parallelMergeSortTask(&arguments);
+    free(buffer);
+}
+/**
+ * The shared state of the phases of parallelSampleSort() and parallelRadixSort(). Every phase
+ * runs one task per block of blockSize consecutive keys, which only gets the state and its block.
+*/
+typedef struct {
+    void *state;
+    int block;
+} BlockTaskArguments;
+typedef struct {
+    TaskPool *pool;
+    unsigned long int *array;
+    unsigned long int *buffer;
+    unsigned short *oracle;
+    const unsigned long int *splitters;
+    int splittersCount;
+    int bucketsCount;
+    int blocksCount;
+    int blockSize;
+    int n;
+    int *counts;
+    int *bucketStarts;
+} SampleSortState;
+typedef struct {
+    TaskPool *pool;
+    const unsigned long int *source;
+    unsigned long int *target;
+    unsigned long int *andMasks;
+    unsigned long int *orMasks;
+    int *counts;
+    int blocksCount;
+    int blockSize;
+    int n;
+    int shift;
+} ParallelRadixState;
+
+void runBlockTasks(TaskPool *pool, void (*function)(void *), void *state, int blocksCount) {
+    // The calling thread takes the first block instead of waiting idle
+    TaskGroup group = {0};
+    for (int block = 1; block < blocksCount; block++) {
+        BlockTaskArguments arguments = {state, block};
+        taskPoolSpawn(pool, &group, function, &arguments, sizeof(arguments));
+    }
+    BlockTaskArguments first = {state, 0};
+    function(&first);
+    taskPoolWait(pool, &group);
+}
+void sampleSortClassifyTask(void *argument) {
+    BlockTaskArguments *arguments = (BlockTaskArguments *)argument;
+    SampleSortState *state = (SampleSortState *)arguments->state;
+    int start = arguments->block * state->blockSize;
+    int end = start + state->blockSize < state->n ? start + state->blockSize : state->n;
+    int *counts = state->counts + arguments->block * state->bucketsCount;
+    const unsigned long int *splitters = state->splitters;
+
+    for (int i = start; i < end; i++) {
+        unsigned long int key = state->array[i];
+
+        // Number of splitters below the key, by a binary search the compiler can keep free of
+        // branches. Keys equal to a splitter get the bucket after it, which holds nothing else.
+        int low = 0, count = state->splittersCount;
+        while (count > 1) {
+            int half = count / 2;
+            low += COUNT_COMPARISON(splitters[low + half - 1] < key) ? half : 0;
+            count -= half;
+        }
+        low += count == 1 && COUNT_COMPARISON(splitters[low] < key);
+        int bucket = 2 * low + (low < state->splittersCount && COUNT_COMPARISON(splitters[low] == key));
+        state->oracle[i] = (unsigned short)bucket;
+        counts[bucket]++;
+    }
+}
+void sampleSortScatterTask(void *argument) {
+    BlockTaskArguments *arguments = (BlockTaskArguments *)argument;
+    SampleSortState *state = (SampleSortState *)arguments->state;
+    int start = arguments->block * state->blockSize;
+    int end = start + state->blockSize < state->n ? start + state->blockSize : state->n;
+    int *offsets = state->counts + arguments->block * state->bucketsCount;
+
+    // Keys are gathered per bucket in a cache line of this thread and written out a line at a time
+    const int lineKeys = SAMPLE_SORT_WRITE_KEYS;
+    unsigned long int *lines = (unsigned long int *)malloc((size_t)state->bucketsCount * lineKeys * sizeof(unsigned long int));
+    int *filled = (int *)calloc(state->bucketsCount, sizeof(int));
+    if (lines == NULL || filled == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = start; i < end; i++) {
+        int bucket = state->oracle[i];
+        unsigned long int *line = lines + bucket * lineKeys;
+        line[filled[bucket]++] = state->array[i];
+        if (filled[bucket] == lineKeys) {
+            memcpy(state->buffer + offsets[bucket], line, lineKeys * sizeof(unsigned long int));
+            offsets[bucket] += lineKeys;
+            filled[bucket] = 0;
+        }
+    }
+    for (int bucket = 0; bucket < state->bucketsCount; bucket++) {
+        memcpy(state->buffer + offsets[bucket], lines + bucket * lineKeys, filled[bucket] * sizeof(unsigned long int));
+    }
+    COUNT_WRITES(end - start);
+    free(lines);
+    free(filled);
+}
+void sampleSortBucketTask(void *argument) {
+    BlockTaskArguments *arguments = (BlockTaskArguments *)argument;
+    SampleSortState *state = (SampleSortState *)arguments->state;
+    int bucket = arguments->block;
+    int start = state->bucketStarts[bucket];
+    int end = state->bucketStarts[bucket + 1];
+
+    // The odd buckets hold keys equal to a splitter and are already in order. A bucket much
+    // larger than expected, from an unlucky sample, is split further by the parallel quick sort.
+    int expectedSize = state->n / (state->splittersCount + 1);
+    if (bucket % 2 == 0 && end - start > 1) {
+        if (end - start > 2 * expectedSize && end - start > benchmarkOptions.grainSize) {
+            // The bucket is its own array: the introsort looks at the key before its range,
+            // which here would be the last key of a bucket another worker is sorting
+            int depthLimit = 0;
+            for (int size = end - start; size > 1; size >>= 1) {
+                depthLimit += 2;
+            }
+            ParallelSortArguments sortArguments = {state->pool, state->buffer + start, NULL, 0, end - start - 1, depthLimit};
+            parallelQuickSortTask(&sortArguments);
+        } else {
+            blockQuickSort(state->buffer + start, end - start);
+        }
+    }
+    memcpy(state->array + start, state->buffer + start, (end - start) * sizeof(unsigned long int));
+    COUNT_WRITES(end - start);
+}
+void parallelSampleSort(unsigned long int *array, int n) {
+    if (n <= benchmarkOptions.grainSize) {
+        blockQuickSort(array, n);
+        return;
+    }
+
+    TaskPool *pool = getTaskPool();
+    int buckets = pool->threadCount * SAMPLE_SORT_BUCKETS_PER_THREAD;
+    if (buckets > SAMPLE_SORT_MAX_BUCKETS) {
+        buckets = SAMPLE_SORT_MAX_BUCKETS;
+    }
+
+    // Sort an oversampled random sample and keep every SAMPLE_SORT_OVERSAMPLING-th key as a
+    // splitter. Repeated splitters are dropped, their keys go to the equality buckets.
+    int samplesCount = buckets * SAMPLE_SORT_OVERSAMPLING;
+    unsigned long int *samples = (unsigned long int *)malloc(samplesCount * sizeof(unsigned long int));
+    unsigned long int *splitters = (unsigned long int *)malloc(buckets * sizeof(unsigned long int));
+    if (samples == NULL || splitters == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    RandomGenerator rng;
+    randomSeed(&rng, DEFAULT_SEED, (uint64_t)n);
+    for (int i = 0; i < samplesCount; i++) {
+        samples[i] = array[randomNext(&rng) % (uint64_t)n];
+    }
+    blockQuickSort(samples, samplesCount);
+    int splittersCount = 0;
+    for (int i = 1; i < buckets; i++) {
+        unsigned long int splitter = samples[i * SAMPLE_SORT_OVERSAMPLING - 1];
+        if (splittersCount == 0 || COUNT_COMPARISON(splitter != splitters[splittersCount - 1])) {
+            splitters[splittersCount++] = splitter;
+        }
+    }
+    free(samples);
+
+    SampleSortState state;
+    state.pool = pool;
+    state.array = array;
+    state.splitters = splitters;
+    state.splittersCount = splittersCount;
+    state.bucketsCount = 2 * splittersCount + 1;
+    state.blocksCount = pool->threadCount < n ? pool->threadCount : n;
+    state.blockSize = (n + state.blocksCount - 1) / state.blocksCount;
+    state.n = n;
+    state.buffer = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    state.oracle = (unsigned short *)malloc(n * sizeof(unsigned short));
+    state.counts = (int *)calloc((size_t)state.blocksCount * state.bucketsCount, sizeof(int));
+    state.bucketStarts = (int *)malloc((state.bucketsCount + 1) * sizeof(int));
+    if (state.buffer == NULL || state.oracle == NULL || state.counts == NULL || state.bucketStarts == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Every block counts its keys per bucket, remembering the bucket of each key
+    runBlockTasks(pool, sampleSortClassifyTask, &state, state.blocksCount);
+
+    // Each bucket holds the keys of block 0, then those of block 1, and so on
+    int offset = 0;
+    for (int bucket = 0; bucket < state.bucketsCount; bucket++) {
+        state.bucketStarts[bucket] = offset;
+        for (int block = 0; block < state.blocksCount; block++) {
+            int *count = &state.counts[block * state.bucketsCount + bucket];
+            int bucketSize = *count;
+            *count = offset;
+            offset += bucketSize;
+        }
+    }
+    state.bucketStarts[state.bucketsCount] = n;
+
+    runBlockTasks(pool, sampleSortScatterTask, &state, state.blocksCount);
+    runBlockTasks(pool, sampleSortBucketTask, &state, state.bucketsCount);
+
+    free(state.buffer);
+    free(state.oracle);
+    free(state.counts);
+    free(state.bucketStarts);
+    free(splitters);
+}
+void parallelRadixMaskTask(void *argument) {
+    BlockTaskArguments *arguments = (BlockTaskArguments *)argument;
+    ParallelRadixState *state = (ParallelRadixState *)arguments->state;
+    int start = arguments->block * state->blockSize;
+    int end = start + state->blockSize < state->n ? start + state->blockSize : state->n;
+
+    unsigned long int andMask = ~0UL, orMask = 0;
+    for (int i = start; i < end; i++) {
+        andMask &= state->source[i];
+        orMask |= state->source[i];
+    }
+    state->andMasks[arguments->block] = andMask;
+    state->orMasks[arguments->block] = orMask;
+}
+void parallelRadixCountTask(void *argument) {
+    BlockTaskArguments *arguments = (BlockTaskArguments *)argument;
+    ParallelRadixState *state = (ParallelRadixState *)arguments->state;
+    int start = arguments->block * state->blockSize;
+    int end = start + state->blockSize < state->n ? start + state->blockSize : state->n;
+    const unsigned long int mask = (1UL << LSD_RADIX_BITS) - 1;
+
+    int *count = state->counts + (arguments->block << LSD_RADIX_BITS);
+    memset(count, 0, sizeof(int) << LSD_RADIX_BITS);
+    for (int i = start; i < end; i++) {
+        count[(state->source[i] >> state->shift) & mask]++;
+    }
+}
+void parallelRadixScatterTask(void *argument) {
+    BlockTaskArguments *arguments = (BlockTaskArguments *)argument;
+    ParallelRadixState *state = (ParallelRadixState *)arguments->state;
+    int start = arguments->block * state->blockSize;
+    int end = start + state->blockSize < state->n ? start + state->blockSize : state->n;
+    const unsigned long int mask = (1UL << LSD_RADIX_BITS) - 1;
+
+    int *offsets = state->counts + (arguments->block << LSD_RADIX_BITS);
+    for (int i = start; i < end; i++) {
+        unsigned long int key = state->source[i];
+        state->target[offsets[(key >> state->shift) & mask]++] = key;
+    }
+    COUNT_WRITES(end - start);
+}
+void parallelRadixCopyTask(void *argument) {
+    BlockTaskArguments *arguments = (BlockTaskArguments *)argument;
+    ParallelRadixState *state = (ParallelRadixState *)arguments->state;
+    int start = arguments->block * state->blockSize;
+    int end = start + state->blockSize < state->n ? start + state->blockSize : state->n;
+
+    memcpy(state->target + start, state->source + start, (end - start) * sizeof(unsigned long int));
+    COUNT_WRITES(end - start);
+}
+void parallelRadixSort(unsigned long int *array, int n) {
+    if (n < 2) return;
+
+    TaskPool *pool = getTaskPool();
+    const int radix = 1 << LSD_RADIX_BITS;
+    ParallelRadixState state;
+    state.pool = pool;
+    state.blocksCount = pool->threadCount < n ? pool->threadCount : n;
+    state.blockSize = (n + state.blocksCount - 1) / state.blocksCount;
+    state.n = n;
+    unsigned long int *buffer = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    state.andMasks = (unsigned long int *)malloc(state.blocksCount * sizeof(unsigned long int));
+    state.orMasks = (unsigned long int *)malloc(state.blocksCount * sizeof(unsigned long int));
+    state.counts = (int *)malloc((size_t)state.blocksCount * radix * sizeof(int));
+    if (buffer == NULL || state.andMasks == NULL || state.orMasks == NULL || state.counts == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // The bits that differ between any two keys, so digits shared by every key can be skipped
+    state.source = array;
+    runBlockTasks(pool, parallelRadixMaskTask, &state, state.blocksCount);
+    unsigned long int andMask = ~0UL, orMask = 0;
+    for (int block = 0; block < state.blocksCount; block++) {
+        andMask &= state.andMasks[block];
+        orMask |= state.orMasks[block];
+    }
+    unsigned long int varyingBits = andMask ^ orMask;
+
+    unsigned long int *source = array;
+    unsigned long int *target = buffer;
+    for (int shift = 0; shift < KEY_BITS; shift += LSD_RADIX_BITS) {
+        if (((varyingBits >> shift) & (unsigned long int)(radix - 1)) == 0) continue;
+        state.source = source;
+        state.target = target;
+        state.shift = shift;
+
+        // Per-block histograms of the digit, prefix-summed digit-major so that every block
+        // scatters its keys after those of the blocks before it, which keeps the sort stable
+        runBlockTasks(pool, parallelRadixCountTask, &state, state.blocksCount);
+        int offset = 0;
+        for (int digit = 0; digit < radix; digit++) {
+            for (int block = 0; block < state.blocksCount; block++) {
+                int *count = &state.counts[(block << LSD_RADIX_BITS) + digit];
+                int bucketSize = *count;
+                *count = offset;
+                offset += bucketSize;
+            }
+        }
+        runBlockTasks(pool, parallelRadixScatterTask, &state, state.blocksCount);
+
+        unsigned long int *temp = source;
+        source = target;
+        target = temp;
+    }
+    if (source != array) {
+        state.source = source;
+        state.target = array;
+        runBlockTasks(pool, parallelRadixCopyTask, &state, state.blocksCount);
+    }
+
+    free(buffer);
+    free(state.andMasks);
+    free(state.orMasks);
+    free(state.counts);
+}
+void lsdRadixSort(unsigned long int *array, int n) {
+    if (n < 2) return;
+
+    const int radix = 1 << LSD_RADIX_BITS;
+    const unsigned long int mask = (unsigned long int)radix - 1;
+    const int digits = (KEY_BITS + LSD_RADIX_BITS - 1) / LSD_RADIX_BITS;
+
+    int *counts = (int *)calloc((size_t)digits * radix, sizeof(int));
+    unsigned long int *buffer = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    if (counts == NULL || buffer == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Count every digit of every key in a single pass over the data
+    for (int i = 0; i < n; i++) {
+        unsigned long int key = array[i];
+        for (int d = 0; d < digits; d++) {
+            counts[d * radix + ((key >> (d * LSD_RADIX_BITS)) & mask)]++;
+        }
+    }
+
+    unsigned long int *source = array;
+    unsigned long int *target = buffer;
+    for (int d = 0; d < digits; d++) {
+        int *count = counts + d * radix;
+        int shift = d * LSD_RADIX_BITS;
+
+        // A digit shared by every key would leave the order unchanged
+        if (count[(source[0] >> shift) & mask] == n) continue;
+
+        // Turn the counts into the starting offset of each bucket
+        int offset = 0;
+        for (int b = 0; b < radix; b++) {
+            int bucketSize = count[b];
+            count[b] = offset;
+            offset += bucketSize;
+        }
+
+        // Stable scatter into the other array
+        COUNT_WRITES(n);
+        for (int i = 0; i < n; i++) {
+            unsigned long int key = source[i];
+            target[count[(key >> shift) & mask]++] = key;
+        }
+
+        unsigned long int *temp = source;
+        source = target;
+        target = temp;
+    }
+
+    // After an odd number of passes the sorted data sits in the buffer
+    if (source != array) {
+        memcpy(array, source, n * sizeof(unsigned long int));
+        COUNT_WRITES(n);
+    }
+    free(buffer);
+    free(counts);
+}
+void americanFlagSortHelper(unsigned long int *array, int low, int high, int shift) {
+    const int radix = 1 << MSD_RADIX_BITS;
+    const unsigned long int mask = (unsigned long int)radix - 1;
+
+    while (shift >= 0) {
+        // Small buckets are cheaper to finish with insertion sort
+        if (high - low + 1 <= cutoffs.radixCutoff) {
+            insertionSort(array + low, high - low + 1);
+            return;
+        }
+
+        int counts[1 << MSD_RADIX_BITS] = {0};
+        for (int i = low; i <= high; i++) {
+            counts[(array[i] >> shift) & mask]++;
+        }
+
+        // Move on to the next digit without permuting when every key shares this one
+        if (counts[(array[low] >> shift) & mask] == high - low + 1) {
+            shift -= MSD_RADIX_BITS;
+            continue;
+        }
+
+        // heads[b] is the next slot to fill in bucket b, tails[b] is where bucket b ends
+        int heads[1 << MSD_RADIX_BITS];
+        int tails[1 << MSD_RADIX_BITS];
+        int offset = low;
+        for (int b = 0; b < radix; b++) {
+            heads[b] = offset;
+            offset += counts[b];
+            tails[b] = offset;
+        }
+
+        // Cycle each misplaced key into its bucket, swapping out the key found there.
+        // Every slot of the range is written exactly once.
+        COUNT_WRITES(high - low + 1);
+        for (int b = 0; b < radix; b++) {
+            while (heads[b] < tails[b]) {
+                unsigned long int key = array[heads[b]];
+                int bucket = (int)((key >> shift) & mask);
+                while (bucket != b) {
+                    unsigned long int temp = array[heads[bucket]];
+                    array[heads[bucket]++] = key;
+                    key = temp;
+                    bucket = (int)((key >> shift) & mask);
+                }
+                array[heads[b]++] = key;
+            }
+        }
+
+        // Sort every bucket by the remaining digits
+        if (shift > 0) {
+            int start = low;
+            for (int b = 0; b < radix; b++) {
+                if (tails[b] - start > 1) {
+                    americanFlagSortHelper(array, start, tails[b] - 1, shift - MSD_RADIX_BITS);
+                }
+                start = tails[b];
+            }
+        }
+        return;
+    }
+}
+void americanFlagSort(unsigned long int *array, int n) {
+    // Start at the most significant digit, which may be narrower than the others
+    int topShift = ((KEY_BITS - 1) / MSD_RADIX_BITS) * MSD_RADIX_BITS;
+    if (n > 1) {
+        americanFlagSortHelper(array, 0, n - 1, topShift);
+    }
+}
+
+/**
+ * The state of a TimSort: the pending runs and the merge buffer.
+ * runBase[i] and runLength[i] describe the i-th run from the bottom of the stack.
+*/
+typedef struct {
+    unsigned long int *array;
+    unsigned long int *buffer;
+    int bufferSize;
+    int minGallop;
+    int runBase[TIM_SORT_MAX_RUNS];
+    int runLength[TIM_SORT_MAX_RUNS];
+    int stackSize;
+} TimSortState;
+
+void binaryInsertionSort(unsigned long int *array, int low, int high, int start) {
+    if (start == low) start++;
+    for (; start < high; start++) {
+        unsigned long int pivot = array[start];
+
+        // The insertion point is after any key equal to the pivot, which keeps the sort stable
+        int left = low, right = start;
+        while (left < right) {
+            int mid = left + (right - left) / 2;
+            if (COUNT_COMPARISON(pivot < array[mid])) {
+                right = mid;
+            } else {
+                left = mid + 1;
+            }
+        }
+        memmove(array + left + 1, array + left, (start - left) * sizeof(unsigned long int));
+        array[left] = pivot;
+        COUNT_WRITES(start - left + 1);
+    }
+}
+int countRunAndMakeAscending(unsigned long int *array, int low, int high) {
+    int runHigh = low + 1;
+    if (runHigh == high) return 1;
+
+    if (COUNT_COMPARISON(array[runHigh++] < array[low])) {
+        // Only strictly descending runs are reversed, so equal keys keep their order
+        while (runHigh < high && COUNT_COMPARISON(array[runHigh] < array[runHigh - 1])) {
+            runHigh++;
+        }
+        for (int i = low, j = runHigh - 1; i < j; i++, j--) {
+            COUNT_SWAP();
+            unsigned long int temp = array[i];
+            array[i] = array[j];
+            array[j] = temp;
+        }
+    } else {
+        while (runHigh < high && COUNT_COMPARISON(array[runHigh] >= array[runHigh - 1])) {
+            runHigh++;
+        }
+    }
+    return runHigh - low;
+}
+int timSortMinRun(int n) {
+    // Keep the top bits of n, plus one if any of the shifted-out bits is set
+    int remainder = 0;
+    while (n >= TIM_SORT_MIN_MERGE) {
+        remainder |= n & 1;
+        n >>= 1;
+    }
+    return n + remainder;
+}
+int gallopLeft(unsigned long int key, const unsigned long int *run, int length, int hint) {
+    int lastOffset = 0;
+    int offset = 1;
+    if (COUNT_COMPARISON(key > run[hint])) {
+        // Gallop right until run[hint + lastOffset] < key <= run[hint + offset]
+        int maxOffset = length - hint;
+        while (offset < maxOffset && COUNT_COMPARISON(key > run[hint + offset])) {
+            lastOffset = offset;
+            offset = offset * 2 + 1;
+            if (offset <= 0) offset = maxOffset;
+        }
+        if (offset > maxOffset) offset = maxOffset;
+        lastOffset += hint;
+        offset += hint;
+    } else {
+        // Gallop left until run[hint - offset] < key <= run[hint - lastOffset]
+        int maxOffset = hint + 1;
+        while (offset < maxOffset && COUNT_COMPARISON(key <= run[hint - offset])) {
+            lastOffset = offset;
+            offset = offset * 2 + 1;
+            if (offset <= 0) offset = maxOffset;
+        }
+        if (offset > maxOffset) offset = maxOffset;
+        int temp = lastOffset;
+        lastOffset = hint - offset;
+        offset = hint - temp;
+    }
+
+    // Binary search in run[lastOffset + 1 .. offset]
+    lastOffset++;
+    while (lastOffset < offset) {
+        int mid = lastOffset + (offset - lastOffset) / 2;
+        if (COUNT_COMPARISON(key > run[mid])) {
+            lastOffset = mid + 1;
+        } else {
+            offset = mid;
+        }
+    }
+    return offset;
+}
+int gallopRight(unsigned long int key, const unsigned long int *run, int length, int hint) {
+    int lastOffset = 0;
+    int offset = 1;
+    if (COUNT_COMPARISON(key < run[hint])) {
+        // Gallop left until run[hint - offset] <= key < run[hint - lastOffset]
+        int maxOffset = hint + 1;
+        while (offset < maxOffset && COUNT_COMPARISON(key < run[hint - offset])) {
+            lastOffset = offset;
+            offset = offset * 2 + 1;
+            if (offset <= 0) offset = maxOffset;
+        }
+        if (offset > maxOffset) offset = maxOffset;
+        int temp = lastOffset;
+        lastOffset = hint - offset;
+        offset = hint - temp;
+    } else {
+        // Gallop right until run[hint + lastOffset] <= key < run[hint + offset]
+        int maxOffset = length - hint;
+        while (offset < maxOffset && COUNT_COMPARISON(key >= run[hint + offset])) {
+            lastOffset = offset;
+            offset = offset * 2 + 1;
+            if (offset <= 0) offset = maxOffset;
+        }
+        if (offset > maxOffset) offset = maxOffset;
+        lastOffset += hint;
+        offset += hint;
+    }
+
+    // Binary search in run[lastOffset + 1 .. offset]
+    lastOffset++;
+    while (lastOffset < offset) {
+        int mid = lastOffset + (offset - lastOffset) / 2;
+        if (COUNT_COMPARISON(key < run[mid])) {
+            offset = mid;
+        } else {
+            lastOffset = mid + 1;
+        }
+    }
+    return offset;
+}
+unsigned long int *timSortBuffer(TimSortState *state, int size) {
+    // Grown on demand, presorted inputs may never need it
+    if (state->bufferSize < size) {
+        int newSize = state->bufferSize * 2 > size ? state->bufferSize * 2 : size;
+        unsigned long int *buffer = (unsigned long int *)realloc(state->buffer, newSize * sizeof(unsigned long int));
+        if (buffer == NULL) {
+            perror("Memory allocation failed");
+            exit(EXIT_FAILURE);
+        }
+        state->buffer = buffer;
+        state->bufferSize = newSize;
+    }
+    return state->buffer;
+}
+void timSortMergeLow(TimSortState *state, int base1, int length1, int base2, int length2) {
+    // The first run is the shorter one. It moves to the buffer and the merge fills the array from the left.
+    unsigned long int *array = state->array;
+    unsigned long int *buffer = timSortBuffer(state, length1);
+    memcpy(buffer, array + base1, length1 * sizeof(unsigned long int));
+    COUNT_WRITES(length1);
+
+    int cursor1 = 0;
+    int cursor2 = base2;
+    int destination = base1;
+    array[destination++] = array[cursor2++];
+    COUNT_WRITES(1);
+    if (--length2 == 0) {
+        memcpy(array + destination, buffer + cursor1, length1 * sizeof(unsigned long int));
+        COUNT_WRITES(length1);
+        return;
+    }
+    if (length1 == 1) {
+        memmove(array + destination, array + cursor2, length2 * sizeof(unsigned long int));
+        array[destination + length2] = buffer[cursor1];
+        COUNT_WRITES(length2 + 1);
+        return;
+    }
+
+    int minGallop = state->minGallop;
+    int isDone = 0;
+    while (!isDone) {
+        // One key at a time until a run wins minGallop times in a row
+        int count1 = 0, count2 = 0;
+        while (1) {
+            COUNT_WRITES(1);
+            if (COUNT_COMPARISON(array[cursor2] < buffer[cursor1])) {
+                array[destination++] = array[cursor2++];
+                count2++;
+                count1 = 0;
+                if (--length2 == 0) { isDone = 1; break; }
+            } else {
+                array[destination++] = buffer[cursor1++];
+                count1++;
+                count2 = 0;
+                if (--length1 == 1) { isDone = 1; break; }
+            }
+            if ((count1 | count2) >= minGallop) break;
+        }
+        if (isDone) break;
+
+        // Galloping: copy whole stretches while one run keeps winning
+        while (1) {
+            count1 = gallopRight(array[cursor2], buffer + cursor1, length1, 0);
+            if (count1 != 0) {
+                memcpy(array + destination, buffer + cursor1, count1 * sizeof(unsigned long int));
+                COUNT_WRITES(count1);
+                destination += count1;
+                cursor1 += count1;
+                length1 -= count1;
+                if (length1 <= 1) { isDone = 1; break; }
+            }
+            array[destination++] = array[cursor2++];
+            COUNT_WRITES(1);
+            if (--length2 == 0) { isDone = 1; break; }
+
+            count2 = gallopLeft(buffer[cursor1], array + cursor2, length2, 0);
+            if (count2 != 0) {
+                memmove(array + destination, array + cursor2, count2 * sizeof(unsigned long int));
+                COUNT_WRITES(count2);
+                destination += count2;
+                cursor2 += count2;
+                length2 -= count2;
+                if (length2 == 0) { isDone = 1; break; }
+            }
+            array[destination++] = buffer[cursor1++];
+            COUNT_WRITES(1);
+            if (--length1 == 1) { isDone = 1; break; }
+
+            minGallop--;
+            if (count1 < TIM_SORT_MIN_GALLOP && count2 < TIM_SORT_MIN_GALLOP) break;
+        }
+        if (isDone) break;
+
+        // Galloping stopped paying off, so it takes longer to enter next time
+        if (minGallop < 0) minGallop = 0;
+        minGallop += 2;
+    }
+    state->minGallop = minGallop < 1 ? 1 : minGallop;
+
+    if (length1 == 1) {
+        memmove(array + destination, array + cursor2, length2 * sizeof(unsigned long int));
+        array[destination + length2] = buffer[cursor1];
+        COUNT_WRITES(length2 + 1);
+    } else if (length1 > 0) {
+        memcpy(array + destination, buffer + cursor1, length1 * sizeof(unsigned long int));
+        COUNT_WRITES(length1);
+    }
+}
+void timSortMergeHigh(TimSortState *state, int base1, int length1, int base2, int length2) {
+    // The second run is the shorter one. It moves to the buffer and the merge fills the array from the right.
+    unsigned long int *array = state->array;
+    unsigned long int *buffer = timSortBuffer(state, length2);
+    memcpy(buffer, array + base2, length2 * sizeof(unsigned long int));
+    COUNT_WRITES(length2);
+
+    int cursor1 = base1 + length1 - 1;
+    int cursor2 = length2 - 1;
+    int destination = base2 + length2 - 1;
+    array[destination--] = array[cursor1--];
+    COUNT_WRITES(1);
+    if (--length1 == 0) {
+        memcpy(array + destination - (length2 - 1), buffer, length2 * sizeof(unsigned long int));
+        COUNT_WRITES(length2);
+        return;
+    }
+    if (length2 == 1) {
+        destination -= length1;
+        cursor1 -= length1;
+        memmove(array + destination + 1, array + cursor1 + 1, length1 * sizeof(unsigned long int));
+        array[destination] = buffer[cursor2];
+        COUNT_WRITES(length1 + 1);
+        return;
+    }
+
+    int minGallop = state->minGallop;
+    int isDone = 0;
+    while (!isDone) {
+        // One key at a time until a run wins minGallop times in a row
+        int count1 = 0, count2 = 0;
+        while (1) {
+            COUNT_WRITES(1);
+            if (COUNT_COMPARISON(buffer[cursor2] < array[cursor1])) {
+                array[destination--] = array[cursor1--];
+                count1++;
+                count2 = 0;
+                if (--length1 == 0) { isDone = 1; break; }
+            } else {
+                array[destination--] = buffer[cursor2--];
+                count2++;
+                count1 = 0;
+                if (--length2 == 1) { isDone = 1; break; }
+            }
+            if ((count1 | count2) >= minGallop) break;
+        }
+        if (isDone) break;
+
+        // Galloping: copy whole stretches while one run keeps winning
+        while (1) {
+            count1 = length1 - gallopRight(buffer[cursor2], array + base1, length1, length1 - 1);
+            if (count1 != 0) {
+                destination -= count1;
+                cursor1 -= count1;
+                length1 -= count1;
+                memmove(array + destination + 1, array + cursor1 + 1, count1 * sizeof(unsigned long int));
+                COUNT_WRITES(count1);
+                if (length1 == 0) { isDone = 1; break; }
+            }
+            array[destination--] = buffer[cursor2--];
+            COUNT_WRITES(1);
+            if (--length2 == 1) { isDone = 1; break; }
+
+            count2 = length2 - gallopLeft(array[cursor1], buffer, length2, length2 - 1);
+            if (count2 != 0) {
+                destination -= count2;
+                cursor2 -= count2;
+                length2 -= count2;
+                memcpy(array + destination + 1, buffer + cursor2 + 1, count2 * sizeof(unsigned long int));
+                COUNT_WRITES(count2);
+                if (length2 <= 1) { isDone = 1; break; }
+            }
+            array[destination--] = array[cursor1--];
+            COUNT_WRITES(1);
+            if (--length1 == 0) { isDone = 1; break; }
+
+            minGallop--;
+            if (count1 < TIM_SORT_MIN_GALLOP && count2 < TIM_SORT_MIN_GALLOP) break;
+        }
+        if (isDone) break;
+
+        // Galloping stopped paying off, so it takes longer to enter next time
+        if (minGallop < 0) minGallop = 0;
+        minGallop += 2;
+    }
+    state->minGallop = minGallop < 1 ? 1 : minGallop;
+
+    if (length2 == 1) {
+        destination -= length1;
+        cursor1 -= length1;
+        memmove(array + destination + 1, array + cursor1 + 1, length1 * sizeof(unsigned long int));
+        array[destination] = buffer[cursor2];
+        COUNT_WRITES(length1 + 1);
+    } else if (length2 > 0) {
+        memcpy(array + destination - (length2 - 1), buffer, length2 * sizeof(unsigned long int));
+        COUNT_WRITES(length2);
+    }
+}
+void timSortMergeAt(TimSortState *state, int i) {
+    unsigned long int *array = state->array;
+    int base1 = state->runBase[i];
+    int length1 = state->runLength[i];
+    int base2 = state->runBase[i + 1];
+    int length2 = state->runLength[i + 1];
+
+    // The merged run replaces runs i and i + 1. The top run slides down when i is the third from the top.
+    state->runLength[i] = length1 + length2;
+    if (i == state->stackSize - 3) {
+        state->runBase[i + 1] = state->runBase[i + 2];
+        state->runLength[i + 1] = state->runLength[i + 2];
+    }
+    state->stackSize--;
+
+    // Keys of the first run below the start of the second, and of the second above the end of the first, stay put
+    int skip = gallopRight(array[base2], array + base1, length1, 0);
+    base1 += skip;
+    length1 -= skip;
+    if (length1 == 0) return;
+    length2 = gallopLeft(array[base1 + length1 - 1], array + base2, length2, length2 - 1);
+    if (length2 == 0) return;
+
+    // Only the shorter run is copied to the buffer
+    if (length1 <= length2) {
+        timSortMergeLow(state, base1, length1, base2, length2);
+    } else {
+        timSortMergeHigh(state, base1, length1, base2, length2);
+    }
+}
+void timSortMergeCollapse(TimSortState *state) {
+    // Merge until every run is longer than the next two together and than the next one,
+    // checking the fourth run from the top too as the original invariant can fail otherwise
+    while (state->stackSize > 1) {
+        int *length = state->runLength;
+        int i = state->stackSize - 2;
+        if ((i > 0 && length[i - 1] <= length[i] + length[i + 1]) || (i > 1 && length[i - 2] <= length[i] + length[i - 1])) {
+            if (length[i - 1] < length[i + 1]) i--;
+        } else if (length[i] > length[i + 1]) {
+            break;
+        }
+        timSortMergeAt(state, i);
+    }
+}
+void timSort(unsigned long int *array, int n) {
+    if (n < 2) return;
+
+    // Small arrays are one run extended by binary insertion
+    if (n < TIM_SORT_MIN_MERGE) {
+        int runLength = countRunAndMakeAscending(array, 0, n);
+        binaryInsertionSort(array, 0, n, runLength);
+        return;
+    }
+
+    TimSortState state;
+    state.array = array;
+    state.buffer = NULL;
+    state.bufferSize = 0;
+    state.minGallop = TIM_SORT_MIN_GALLOP;
+    state.stackSize = 0;
+
+    int minRun = timSortMinRun(n);
+    int low = 0;
+    int remaining = n;
+    while (remaining > 0) {
+        // Extend short natural runs to minRun keys
+        int runLength = countRunAndMakeAscending(array, low, n);
+        if (runLength < minRun) {
+            int forced = remaining <= minRun ? remaining : minRun;
+            binaryInsertionSort(array, low, low + forced, low + runLength);
+            runLength = forced;
+        }
+
+        state.runBase[state.stackSize] = low;
+        state.runLength[state.stackSize] = runLength;
+        state.stackSize++;
+        timSortMergeCollapse(&state);
+
+        low += runLength;
+        remaining -= runLength;
+    }
+
+    // Merge what is left on the stack, always the smaller neighbour first
+    while (state.stackSize > 1) {
+        int i = state.stackSize - 2;
+        if (i > 0 && state.runLength[i - 1] < state.runLength[i + 1]) i--;
+        timSortMergeAt(&state, i);
+    }
+    free(state.buffer);
+}
+int compareKeys(const void *a, const void *b) {
+    unsigned long int keyA = *(const unsigned long int *)a;
+    unsigned long int keyB = *(const unsigned long int *)b;
+
+    if (COUNT_COMPARISON(keyA < keyB)) return -1;
+    return keyA > keyB;
+}
+void libcQsort(unsigned long int *array, int n) {
+    qsort(array, n, sizeof(unsigned long int), compareKeys);
+}
+
+/*
+*
+* VECTORIZED SORTING ALGORITHMS
+*
+*/
+#ifdef SIMD_X86
+/**
+ * Puts the lane-wise minimum and maximum of two vectors of unsigned keys in minimum and
+ * maximum. AVX2 only compares signed 64-bit lanes, so the sign bits are flipped first.
+*/
+#define MIN_MAX_AVX2(a, b, minimum, maximum) do { \
+    __m256i greater = _mm256_cmpgt_epi64(_mm256_xor_si256(a, signBits), _mm256_xor_si256(b, signBits)); \
+    minimum = _mm256_blendv_epi8(a, b, greater); \
+    maximum = _mm256_blendv_epi8(b, a, greater); \
+} while (0)
+
+/**
+ * Compare-exchanges the lanes of v with the lanes PERMUTATION pairs them with, keeping the
+ * maximum in the 32-bit lanes set in MAX_LANES.
+*/
+#define COMPARE_LANES_AVX2(v, PERMUTATION, MAX_LANES) do { \
+    __m256i permuted = _mm256_permute4x64_epi64(v, PERMUTATION); \
+    __m256i laneMinimum, laneMaximum; \
+    MIN_MAX_AVX2(v, permuted, laneMinimum, laneMaximum); \
+    v = _mm256_blend_epi32(laneMinimum, laneMaximum, MAX_LANES); \
+} while (0)
+
+/**
+ * Merges two sorted vectors: low gets the 4 smallest keys and high the 4 largest, both sorted.
+*/
+#define MERGE_VECTORS_AVX2(low, high) do { \
+    __m256i reversed = _mm256_permute4x64_epi64(high, 0x1B); \
+    __m256i merged = low; \
+    MIN_MAX_AVX2(merged, reversed, low, high); \
+    COMPARE_LANES_AVX2(low, 0x4E, 0xF0); \
+    COMPARE_LANES_AVX2(low, 0xB1, 0xCC); \
+    COMPARE_LANES_AVX2(high, 0x4E, 0xF0); \
+    COMPARE_LANES_AVX2(high, 0xB1, 0xCC); \
+} while (0)
+
+/**
+ * Compare-exchanges the lanes of v with the lanes the permutation pairs them with, keeping the
+ * maximum in the lanes set in maxLanes.
+*/
+#define COMPARE_LANES_AVX512(v, permutation, maxLanes) do { \
+    __m512i permuted = _mm512_permutexvar_epi64(permutation, v); \
+    v = _mm512_mask_blend_epi64(maxLanes, _mm512_min_epu64(v, permuted), _mm512_max_epu64(v, permuted)); \
+} while (0)
+
+/**
+ * Sorts the low and high 4 lanes of two bitonic vectors, after their first merge step.
+*/
+#define CLEAN_VECTOR_AVX512(v) do { \
+    COMPARE_LANES_AVX512(v, halves, 0xF0); \
+    COMPARE_LANES_AVX512(v, quarters, 0xCC); \
+    COMPARE_LANES_AVX512(v, pairs, 0xAA); \
+} while (0)
+
+/**
+ * Sorts array[0..n) with a bitonic network in AVX2 registers of 4 keys. n is a power of two
+ * of at least 8. Every stage of size k first compares key i with key k-1-i of each block
+ * (a flip), which leaves both halves bitonic, then halves the compare distance down to 1,
+ * so every block ends up ascending and no descending pass is needed.
+*/
+__attribute__((target("avx2")))
+void bitonicSortAvx2(unsigned long int *array, int n) {
+    const __m256i signBits = _mm256_set1_epi64x(INT64_MIN);
+    for (int k = 2; k <= n; k *= 2) {
+        if (k == 2) {
+            for (int i = 0; i < n; i += 4) {
+                __m256i v = _mm256_loadu_si256((const __m256i *)(array + i));
+                COMPARE_LANES_AVX2(v, 0xB1, 0xCC);
+                _mm256_storeu_si256((__m256i *)(array + i), v);
+            }
+        } else if (k == 4) {
+            for (int i = 0; i < n; i += 4) {
+                __m256i v = _mm256_loadu_si256((const __m256i *)(array + i));
+                COMPARE_LANES_AVX2(v, 0x1B, 0xF0);
+                _mm256_storeu_si256((__m256i *)(array + i), v);
+            }
+        } else {
+            for (int block = 0; block < n; block += k) {
+                for (int t = 0; t < k / 2; t += 4) {
+                    unsigned long int *low = array + block + t;
+                    unsigned long int *high = array + block + k - 4 - t;
+                    __m256i a = _mm256_loadu_si256((const __m256i *)low);
+                    __m256i b = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i *)high), 0x1B);
+                    __m256i minimum, maximum;
+                    MIN_MAX_AVX2(a, b, minimum, maximum);
+                    _mm256_storeu_si256((__m256i *)low, minimum);
+                    _mm256_storeu_si256((__m256i *)high, _mm256_permute4x64_epi64(maximum, 0x1B));
+                }
+            }
+        }
+
+        // Distances of a vector or more pair whole registers, shorter ones pair lanes
+        for (int j = k / 4; j >= 4; j /= 2) {
+            for (int block = 0; block < n; block += 2 * j) {
+                for (int t = 0; t < j; t += 4) {
+                    unsigned long int *low = array + block + t;
+                    __m256i a = _mm256_loadu_si256((const __m256i *)low);
+                    __m256i b = _mm256_loadu_si256((const __m256i *)(low + j));
+                    __m256i minimum, maximum;
+                    MIN_MAX_AVX2(a, b, minimum, maximum);
+                    _mm256_storeu_si256((__m256i *)low, minimum);
+                    _mm256_storeu_si256((__m256i *)(low + j), maximum);
+                }
+            }
+        }
+        if (k >= 4) {
+            for (int i = 0; i < n; i += 4) {
+                __m256i v = _mm256_loadu_si256((const __m256i *)(array + i));
+                if (k >= 8) {
+                    COMPARE_LANES_AVX2(v, 0x4E, 0xF0);
+                }
+                COMPARE_LANES_AVX2(v, 0xB1, 0xCC);
+                _mm256_storeu_si256((__m256i *)(array + i), v);
+            }
+        }
+    }
+}
+/**
+ * The bitonic network of bitonicSortAvx2() in AVX-512 registers of 8 keys. n is a power of
+ * two of at least 8.
+*/
+__attribute__((target("avx512f")))
+void bitonicSortAvx512(unsigned long int *array, int n) {
+    const __m512i pairs = _mm512_set_epi64(6, 7, 4, 5, 2, 3, 0, 1);
+    const __m512i quarters = _mm512_set_epi64(5, 4, 7, 6, 1, 0, 3, 2);
+    const __m512i halves = _mm512_set_epi64(3, 2, 1, 0, 7, 6, 5, 4);
+    const __m512i reverseQuarters = _mm512_set_epi64(4, 5, 6, 7, 0, 1, 2, 3);
+    const __m512i reverseHalves = _mm512_set_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+
+    // Stages of up to 8 keys stay in one register
+    for (int i = 0; i < n; i += 8) {
+        __m512i v = _mm512_loadu_si512(array + i);
+        COMPARE_LANES_AVX512(v, pairs, 0xAA);
+        COMPARE_LANES_AVX512(v, reverseQuarters, 0xCC);
+        COMPARE_LANES_AVX512(v, pairs, 0xAA);
+        COMPARE_LANES_AVX512(v, reverseHalves, 0xF0);
+        COMPARE_LANES_AVX512(v, quarters, 0xCC);
+        COMPARE_LANES_AVX512(v, pairs, 0xAA);
+        _mm512_storeu_si512(array + i, v);
+    }
+    for (int k = 16; k <= n; k *= 2) {
+        for (int block = 0; block < n; block += k) {
+            for (int t = 0; t < k / 2; t += 8) {
+                unsigned long int *low = array + block + t;
+                unsigned long int *high = array + block + k - 8 - t;
+                __m512i a = _mm512_loadu_si512(low);
+                __m512i b = _mm512_permutexvar_epi64(reverseHalves, _mm512_loadu_si512(high));
+                _mm512_storeu_si512(low, _mm512_min_epu64(a, b));
+                _mm512_storeu_si512(high, _mm512_permutexvar_epi64(reverseHalves, _mm512_max_epu64(a, b)));
+            }
+        }
+        for (int j = k / 4; j >= 8; j /= 2) {
+            for (int block = 0; block < n; block += 2 * j) {
+                for (int t = 0; t < j; t += 8) {
+                    unsigned long int *low = array + block + t;
+                    __m512i a = _mm512_loadu_si512(low);
+                    __m512i b = _mm512_loadu_si512(low + j);
+                    _mm512_storeu_si512(low, _mm512_min_epu64(a, b));
+                    _mm512_storeu_si512(low + j, _mm512_max_epu64(a, b));
+                }
+            }
+        }
+        for (int i = 0; i < n; i += 8) {
+            __m512i v = _mm512_loadu_si512(array + i);
+            CLEAN_VECTOR_AVX512(v);
+            _mm512_storeu_si512(array + i, v);
+        }
+    }
+}
+/**
+ * The merge of simdMerge() in AVX2 registers. Both runs have at least 4 keys.
+*/
+__attribute__((target("avx2")))
+void bitonicMergeAvx2(const unsigned long int *left, int leftLength, const unsigned long int *right, int rightLength, unsigned long int *target) {
+    const __m256i signBits = _mm256_set1_epi64x(INT64_MIN);
+    const unsigned long int *leftEnd = left + leftLength;
+    const unsigned long int *rightEnd = right + rightLength;
+    __m256i low = _mm256_loadu_si256((const __m256i *)left);
+    __m256i high = _mm256_loadu_si256((const __m256i *)right);
+    left += 4;
+    right += 4;
+    MERGE_VECTORS_AVX2(low, high);
+    _mm256_storeu_si256((__m256i *)target, low);
+    target += 4;
+
+    // high holds the 4 largest keys merged so far. The run with the smaller next key must
+    // provide the next register, or one of its keys could be output too late.
+    while (1) {
+        const unsigned long int **next;
+        if (left < leftEnd && (right == rightEnd || *left <= *right)) {
+            next = &left;
+        } else {
+            next = &right;
+        }
+        if (*next + 4 > (next == &left ? leftEnd : rightEnd)) break;
+        low = _mm256_loadu_si256((const __m256i *)*next);
+        *next += 4;
+        MERGE_VECTORS_AVX2(low, high);
+        _mm256_storeu_si256((__m256i *)target, low);
+        target += 4;
+    }
+    unsigned long int pending[4];
+    _mm256_storeu_si256((__m256i *)pending, high);
+    mergeTail(pending, 4, left, (int)(leftEnd - left), right, (int)(rightEnd - right), target);
+}
+/**
+ * The merge of simdMerge() in AVX-512 registers. Both runs have at least 8 keys.
+*/
+__attribute__((target("avx512f")))
+void bitonicMergeAvx512(const unsigned long int *left, int leftLength, const unsigned long int *right, int rightLength, unsigned long int *target) {
+    const __m512i pairs = _mm512_set_epi64(6, 7, 4, 5, 2, 3, 0, 1);
+    const __m512i quarters = _mm512_set_epi64(5, 4, 7, 6, 1, 0, 3, 2);
+    const __m512i halves = _mm512_set_epi64(3, 2, 1, 0, 7, 6, 5, 4);
+    const __m512i reverseHalves = _mm512_set_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+    const unsigned long int *leftEnd = left + leftLength;
+    const unsigned long int *rightEnd = right + rightLength;
+    __m512i low = _mm512_loadu_si512(left);
+    __m512i high = _mm512_loadu_si512(right);
+    left += 8;
+    right += 8;
+    while (1) {
+        __m512i reversed = _mm512_permutexvar_epi64(reverseHalves, high);
+        high = _mm512_max_epu64(low, reversed);
+        low = _mm512_min_epu64(low, reversed);
+        CLEAN_VECTOR_AVX512(low);
+        CLEAN_VECTOR_AVX512(high);
+        _mm512_storeu_si512(target, low);
+        target += 8;
+
+        // Same choice of the next register as bitonicMergeAvx2()
+        const unsigned long int **next;
+        if (left < leftEnd && (right == rightEnd || *left <= *right)) {
+            next = &left;
+        } else {
+            next = &right;
+        }
+        if (*next + 8 > (next == &left ? leftEnd : rightEnd)) break;
+        low = _mm512_loadu_si512(*next);
+        *next += 8;
+    }
+    unsigned long int pending[8];
+    _mm512_storeu_si512(pending, high);
+    mergeTail(pending, 8, left, (int)(leftEnd - left), right, (int)(rightEnd - right), target);
+}
+#endif
+void simdSortNetwork(unsigned long int *array, int n) {
+    int simdLevel = getSimdLevel();
+    if (simdLevel == SIMD_NONE || n < 8) {
+        insertionSort(array, n);
+        return;
+    }
+    #ifdef SIMD_X86
+        // The network sorts a power of two keys, the padding keys sort last and are dropped
+        int size = 8;
+        while (size < n) size *= 2;
+        unsigned long int padded[SIMD_LEAF_SIZE];
+        unsigned long int *keys = array;
+        if (size != n) {
+            memcpy(padded, array, n * sizeof(unsigned long int));
+            for (int i = n; i < size; i++) {
+                padded[i] = ULONG_MAX;
+            }
+            keys = padded;
+        }
+        if (simdLevel == SIMD_AVX512) {
+            bitonicSortAvx512(keys, size);
+        } else {
+            bitonicSortAvx2(keys, size);
+        }
+        if (keys != array) {
+            memcpy(array, padded, n * sizeof(unsigned long int));
+        }
+    #endif
+}
+void mergeTail(const unsigned long int *first, int firstLength, const unsigned long int *second, int secondLength,
+    const unsigned long int *third, int thirdLength, unsigned long int *target) {
+    const unsigned long int *firstEnd = first + firstLength;
+    const unsigned long int *secondEnd = second + secondLength;
+    const unsigned long int *thirdEnd = third + thirdLength;
+    while (first < firstEnd && second < secondEnd && third < thirdEnd) {
+        if (*first <= *second && *first <= *third) {
+            *target++ = *first++;
+        } else if (*second <= *third) {
+            *target++ = *second++;
+        } else {
+            *target++ = *third++;
+        }
+    }
+
+    // Move the sequence that ran out last so that two are left
+    if (first == firstEnd) {
+        first = third;
+        firstEnd = thirdEnd;
+    } else if (second == secondEnd) {
+        second = third;
+        secondEnd = thirdEnd;
+    }
+    while (first < firstEnd && second < secondEnd) {
+        *target++ = *first <= *second ? *first++ : *second++;
+    }
+    memcpy(target, first, (firstEnd - first) * sizeof(unsigned long int));
+    target += firstEnd - first;
+    memcpy(target, second, (secondEnd - second) * sizeof(unsigned long int));
+}
+void simdMerge(const unsigned long int *source, int leftStart, int leftEnd, int rightStart, int rightEnd, unsigned long int *target, int outStart) {
+    int simdLevel = getSimdLevel();
+    int leftLength = leftEnd - leftStart + 1;
+    int rightLength = rightEnd - rightStart + 1;
+    #ifdef SIMD_X86
+        if (simdLevel == SIMD_AVX512 && leftLength >= 8 && rightLength >= 8) {
+            bitonicMergeAvx512(source + leftStart, leftLength, source + rightStart, rightLength, target + outStart);
+            return;
+        }
+        if (simdLevel != SIMD_NONE && leftLength >= 4 && rightLength >= 4) {
+            bitonicMergeAvx2(source + leftStart, leftLength, source + rightStart, rightLength, target + outStart);
+            return;
+        }
+    #else
+        (void)simdLevel;
+        (void)leftLength;
+        (void)rightLength;
+    #endif
+    mergeRanges(source, leftStart, leftEnd, rightStart, rightEnd, target, outStart);
+}
+void vectorQuickSort(unsigned long int *array, int n) {
+    // Depth limit of 2*floor(log2(N))
+    int depthLimit = 0;
+    for (int size = n; size > 1; size >>= 1) {
+        depthLimit += 2;
+    }
+    introSortHelper(array, 0, n - 1, depthLimit, blockPartition, cutoffs.vectorLeafSize, simdSortNetwork);
+}
+void vectorMergeSort(unsigned long int *array, int n) {
+    int leafSize = cutoffs.vectorLeafSize;
+    for (int low = 0; low < n; low += leafSize) {
+        simdSortNetwork(array + low, n - low < leafSize ? n - low : leafSize);
+    }
+    if (n <= leafSize) return;
+
+    unsigned long int *buffer = malloc(n * sizeof(unsigned long int));
+    if (buffer == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Merge passes alternate between the array and the buffer
+    unsigned long int *source = array;
+    unsigned long int *target = buffer;
+    for (int width = leafSize; width < n; width *= 2) {
+        for (int low = 0; low < n; low += 2 * width) {
+            int mid = low + width < n ? low + width : n;
+            int high = low + 2 * width < n ? low + 2 * width : n;
+            if (mid < high) {
+                simdMerge(source, low, mid - 1, mid, high - 1, target, low);
+            } else {
+                memcpy(target + low, source + low, (high - low) * sizeof(unsigned long int));
+            }
+        }
+        unsigned long int *temp = source;
+        source = target;
+        target = temp;
+    }
+    if (source != array) {
+        memcpy(array, source, n * sizeof(unsigned long int));
+    }
+    free(buffer);
+}
+
+/*
+*
+* TYPED SORTING ALGORITHMS
+*
+*/
+/**
+ * Generates the serial comparison sorts of one element type. LESS(a, b) compares two elements.
+ * Each follows the u64 sort of the same name, moving whole elements, so the record sizes show
+ * in the timings. The quick sorts are the same introsort as quickSort(): ninther pivots, the
+ * equal-key pass, cutoffs.quickSortCutoff and the heap sort fallback.
+*/
+#define DEFINE_COMPARISON_SORTS(SUFFIX, TYPE, LESS) \
+void swap##SUFFIX(TYPE *array, int i, int j) { \
+    COUNT_SWAP(); \
+    TYPE temp = array[i]; \
+    array[i] = array[j]; \
+    array[j] = temp; \
+} \
+void selectionSort##SUFFIX(void *data, int n) { \
+    TYPE *array = (TYPE *)data; \
+    for (int i = 0; i < n - 1; i++) { \
+        int minIndex = i; \
+        for (int j = i + 1; j < n; j++) { \
+            if (COUNT_COMPARISON(LESS(array[j], array[minIndex]))) minIndex = j; \
+        } \
+        swap##SUFFIX(array, i, minIndex); \
+    } \
+} \
+void bubbleSort##SUFFIX(void *data, int n) { \
+    TYPE *array = (TYPE *)data; \
+    for (int i = 0; i < n - 1; i++) { \
+        int swapped = 0; \
+        for (int j = 0; j < n - i - 1; j++) { \
+            if (COUNT_COMPARISON(LESS(array[j + 1], array[j]))) { \
+                swap##SUFFIX(array, j, j + 1); \
+                swapped = 1; \
+            } \
+        } \
+        if (!swapped) break; \
+    } \
+} \
+void insertionSort##SUFFIX(void *data, int n) { \
+    TYPE *array = (TYPE *)data; \
+    for (int i = 1; i < n; i++) { \
+        TYPE key = array[i]; \
+        int j = i - 1; \
+        while (j >= 0 && COUNT_COMPARISON(LESS(key, array[j]))) { \
+            array[j + 1] = array[j]; \
+            j--; \
+        } \
+        array[j + 1] = key; \
+        COUNT_WRITES(i - j); \
+    } \
+} \
+void merge##SUFFIX(TYPE *array, int left, int mid, int right) { \
+    int leftSize = mid - left + 1; \
+    int rightSize = right - mid; \
+    TYPE *leftArray = (TYPE *)malloc(leftSize * sizeof(TYPE)); \
+    TYPE *rightArray = (TYPE *)malloc(rightSize * sizeof(TYPE)); \
+    if (leftArray == NULL || rightArray == NULL) { \
+        perror("Memory allocation failed"); \
+        exit(EXIT_FAILURE); \
+    } \
+    COUNT_WRITES(2 * (leftSize + rightSize)); \
+    memcpy(leftArray, array + left, leftSize * sizeof(TYPE)); \
+    memcpy(rightArray, array + mid + 1, rightSize * sizeof(TYPE)); \
+    int i = 0, j = 0, k = left; \
+    while (i < leftSize && j < rightSize) { \
+        if (COUNT_COMPARISON(!LESS(rightArray[j], leftArray[i]))) { \
+            array[k++] = leftArray[i++]; \
+        } else { \
+            array[k++] = rightArray[j++]; \
+        } \
+    } \
+    while (i < leftSize) array[k++] = leftArray[i++]; \
+    while (j < rightSize) array[k++] = rightArray[j++]; \
+    free(leftArray); \
+    free(rightArray); \
+} \
+void mergeSortHelper##SUFFIX(TYPE *array, int left, int right) { \
+    if (left < right) { \
+        int mid = left + (right - left) / 2; \
+        mergeSortHelper##SUFFIX(array, left, mid); \
+        mergeSortHelper##SUFFIX(array, mid + 1, right); \
+        merge##SUFFIX(array, left, mid, right); \
+    } \
+} \
+void mergeSort##SUFFIX(void *data, int n) { \
+    mergeSortHelper##SUFFIX((TYPE *)data, 0, n - 1); \
+} \
+void mergeInto##SUFFIX(TYPE *source, TYPE *target, int left, int mid, int right) { \
+    int i = left, j = mid + 1, k = left; \
+    COUNT_WRITES(right - left + 1); \
+    while (i <= mid && j <= right) { \
+        if (COUNT_COMPARISON(!LESS(source[j], source[i]))) { \
+            target[k++] = source[i++]; \
+        } else { \
+            target[k++] = source[j++]; \
+        } \
+    } \
+    while (i <= mid) target[k++] = source[i++]; \
+    while (j <= right) target[k++] = source[j++]; \
+} \
+void mergeSortPingPongHelper##SUFFIX(TYPE *source, TYPE *target, int left, int right) { \
+    if (left < right) { \
+        int mid = left + (right - left) / 2; \
+        mergeSortPingPongHelper##SUFFIX(target, source, left, mid); \
+        mergeSortPingPongHelper##SUFFIX(target, source, mid + 1, right); \
+        mergeInto##SUFFIX(source, target, left, mid, right); \
+    } \
+} \
+void bufferedMergeSort##SUFFIX(void *data, int n) { \
+    if (n < 2) return; \
+    TYPE *array = (TYPE *)data; \
+    TYPE *buffer = (TYPE *)malloc(n * sizeof(TYPE)); \
+    if (buffer == NULL) { \
+        perror("Memory allocation failed"); \
+        exit(EXIT_FAILURE); \
+    } \
+    memcpy(buffer, array, n * sizeof(TYPE)); \
+    COUNT_WRITES(n); \
+    mergeSortPingPongHelper##SUFFIX(buffer, array, 0, n - 1); \
+    free(buffer); \
+} \
+void bottomUpSiftDown##SUFFIX(TYPE *heap, int n, int root, int arity) { \
+    TYPE value = heap[root]; \
+    int hole = root; \
+    /* Large elements span a cache line or more, every grandchild is then prefetched */ \
+    int step = CACHE_LINE_SIZE / (int)sizeof(TYPE) > 0 ? CACHE_LINE_SIZE / (int)sizeof(TYPE) : 1; \
+    int firstChild; \
+    while ((firstChild = arity * hole + 1) < n) { \
+        int firstGrandchild = arity * firstChild + 1; \
+        int lastGrandchild = arity * (firstChild + arity - 1) + arity; \
+        if (lastGrandchild > n) lastGrandchild = n; \
+        for (int g = firstGrandchild; g < lastGrandchild; g += step) { \
+            PREFETCH(&heap[g]); \
+        } \
+        int largest = firstChild; \
+        int lastChild = firstChild + arity < n ? firstChild + arity : n; \
+        for (int child = firstChild + 1; child < lastChild; child++) { \
+            if (COUNT_COMPARISON(LESS(heap[largest], heap[child]))) largest = child; \
+        } \
+        heap[hole] = heap[largest]; \
+        COUNT_WRITES(1); \
+        hole = largest; \
+    } \
+    while (hole > root) { \
+        int parent = (hole - 1) / arity; \
+        if (!COUNT_COMPARISON(LESS(heap[parent], value))) break; \
+        heap[hole] = heap[parent]; \
+        COUNT_WRITES(1); \
+        hole = parent; \
+    } \
+    heap[hole] = value; \
+    COUNT_WRITES(1); \
+} \
+void bottomUpHeapSortEngine##SUFFIX(TYPE *heap, int n, int arity) { \
+    for (int i = (n - 2) / arity; i >= 0 && n > 1; i--) { \
+        bottomUpSiftDown##SUFFIX(heap, n, i, arity); \
+    } \
+    for (int i = n - 1; i > 0; i--) { \
+        swap##SUFFIX(heap, 0, i); \
+        bottomUpSiftDown##SUFFIX(heap, i, 0, arity); \
+    } \
+} \
+void bottomUpHeapSort##SUFFIX(void *data, int n) { \
+    bottomUpHeapSortEngine##SUFFIX((TYPE *)data, n, 2); \
+} \
+void alignedHeapSort##SUFFIX(TYPE *array, int n, int arity) { \
+    if (n < 2) return; \
+    /* The children of node i sit at slot arity*(i+1) of the buffer, a multiple of arity */ \
+    int perLine = CACHE_LINE_SIZE / (int)sizeof(TYPE) > 0 ? CACHE_LINE_SIZE / (int)sizeof(TYPE) : 1; \
+    TYPE *buffer = (TYPE *)malloc((n + arity + perLine) * sizeof(TYPE)); \
+    if (buffer == NULL) { \
+        perror("Memory allocation failed"); \
+        exit(EXIT_FAILURE); \
+    } \
+    TYPE *aligned = (TYPE *)(((uintptr_t)buffer + CACHE_LINE_SIZE - 1) & ~(uintptr_t)(CACHE_LINE_SIZE - 1)); \
+    TYPE *heap = aligned + arity - 1; \
+    memcpy(heap, array, n * sizeof(TYPE)); \
+    bottomUpHeapSortEngine##SUFFIX(heap, n, arity); \
+    memcpy(array, heap, n * sizeof(TYPE)); \
+    COUNT_WRITES(2 * (unsigned long long)n); \
+    free(buffer); \
+} \
+void quaternaryHeapSort##SUFFIX(void *data, int n) { \
+    alignedHeapSort##SUFFIX((TYPE *)data, n, 4); \
+} \
+void octonaryHeapSort##SUFFIX(void *data, int n) { \
+    alignedHeapSort##SUFFIX((TYPE *)data, n, 8); \
+} \
+TYPE medianOfThree##SUFFIX(TYPE *array, int low, int high) { \
+    int mid = low + (high - low) / 2; \
+    if (COUNT_COMPARISON(LESS(array[mid], array[low]))) swap##SUFFIX(array, low, mid); \
+    if (COUNT_COMPARISON(LESS(array[high], array[low]))) swap##SUFFIX(array, low, high); \
+    if (COUNT_COMPARISON(LESS(array[high], array[mid]))) swap##SUFFIX(array, mid, high); \
+    swap##SUFFIX(array, mid, high); \
+    return array[high]; \
+} \
+int quickSortPartition##SUFFIX(TYPE *array, int low, int high) { \
+    TYPE pivot = medianOfThree##SUFFIX(array, low, high); \
+    int i = low - 1; \
+    for (int j = low; j < high; j++) { \
+        if (COUNT_COMPARISON(LESS(array[j], pivot))) swap##SUFFIX(array, ++i, j); \
+    } \
+    swap##SUFFIX(array, i + 1, high); \
+    return i + 1; \
+} \
+void quickSortHelper##SUFFIX(TYPE *array, int low, int high) { \
+    if (low < high) { \
+        int pivotIndex = quickSortPartition##SUFFIX(array, low, high); \
+        quickSortHelper##SUFFIX(array, low, pivotIndex - 1); \
+        quickSortHelper##SUFFIX(array, pivotIndex + 1, high); \
+    } \
+} \
+void lomutoQuickSort##SUFFIX(void *data, int n) { \
+    quickSortHelper##SUFFIX((TYPE *)data, 0, n - 1); \
+} \
+int blockPartition##SUFFIX(TYPE *array, int low, int high, int pivotIndex) { \
+    swap##SUFFIX(array, low, pivotIndex); \
+    TYPE pivot = array[low]; \
+    int left = low + 1, right = high; \
+    unsigned char offsetsLeft[PARTITION_BLOCK_SIZE]; \
+    unsigned char offsetsRight[PARTITION_BLOCK_SIZE]; \
+    int countLeft = 0, countRight = 0; \
+    int startLeft = 0, startRight = 0; \
+    while (right - left + 1 >= 2 * PARTITION_BLOCK_SIZE) { \
+        if (countLeft == 0) { \
+            startLeft = 0; \
+            for (int i = 0; i < PARTITION_BLOCK_SIZE; i++) { \
+                offsetsLeft[countLeft] = (unsigned char)i; \
+                countLeft += COUNT_COMPARISON(!LESS(array[left + i], pivot)); \
+            } \
+        } \
+        if (countRight == 0) { \
+            startRight = 0; \
+            for (int i = 0; i < PARTITION_BLOCK_SIZE; i++) { \
+                offsetsRight[countRight] = (unsigned char)i; \
+                countRight += COUNT_COMPARISON(LESS(array[right - i], pivot)); \
+            } \
+        } \
+        int count = countLeft < countRight ? countLeft : countRight; \
+        for (int k = 0; k < count; k++) { \
+            swap##SUFFIX(array, left + offsetsLeft[startLeft + k], right - offsetsRight[startRight + k]); \
+        } \
+        countLeft -= count; \
+        countRight -= count; \
+        startLeft += count; \
+        startRight += count; \
+        if (countLeft == 0) left += PARTITION_BLOCK_SIZE; \
+        if (countRight == 0) right -= PARTITION_BLOCK_SIZE; \
+    } \
+    while (1) { \
+        while (left <= right && COUNT_COMPARISON(LESS(array[left], pivot))) left++; \
+        while (left <= right && COUNT_COMPARISON(!LESS(array[right], pivot))) right--; \
+        if (left >= right) break; \
+        swap##SUFFIX(array, left++, right--); \
+    } \
+    swap##SUFFIX(array, low, left - 1); \
+    return left - 1; \
+} \
+void heapify##SUFFIX(TYPE *array, int n, int root) { \
+    int largest = root; \
+    int leftChild = 2 * root + 1; \
+    int rightChild = 2 * root + 2; \
+    if (leftChild < n && COUNT_COMPARISON(LESS(array[largest], array[leftChild]))) largest = leftChild; \
+    if (rightChild < n && COUNT_COMPARISON(LESS(array[largest], array[rightChild]))) largest = rightChild; \
+    if (largest != root) { \
+        swap##SUFFIX(array, root, largest); \
+        heapify##SUFFIX(array, n, largest); \
+    } \
+} \
+void heapSort##SUFFIX(void *data, int n) { \
+    TYPE *array = (TYPE *)data; \
+    for (int i = n / 2 - 1; i >= 0; i--) { \
+        heapify##SUFFIX(array, n, i); \
+    } \
+    for (int i = n - 1; i > 0; i--) { \
+        swap##SUFFIX(array, 0, i); \
+        heapify##SUFFIX(array, i, 0); \
+    } \
+} \
+int medianIndex##SUFFIX(TYPE *array, int a, int b, int c) { \
+    if (COUNT_COMPARISON(LESS(array[a], array[b]))) { \
+        if (COUNT_COMPARISON(LESS(array[b], array[c]))) return b; \
+        return COUNT_COMPARISON(LESS(array[a], array[c])) ? c : a; \
+    } \
+    if (COUNT_COMPARISON(LESS(array[a], array[c]))) return a; \
+    return COUNT_COMPARISON(LESS(array[b], array[c])) ? c : b; \
+} \
+int hoarePartition##SUFFIX(TYPE *array, int low, int high, int pivotIndex) { \
+    swap##SUFFIX(array, low, pivotIndex); \
+    TYPE pivot = array[low]; \
+    int i = low + 1, j = high; \
+    while (1) { \
+        while (i <= j && COUNT_COMPARISON(LESS(array[i], pivot))) i++; \
+        while (COUNT_COMPARISON(LESS(pivot, array[j]))) j--; \
+        if (i >= j) break; \
+        swap##SUFFIX(array, i++, j--); \
+    } \
+    swap##SUFFIX(array, low, j); \
+    return j; \
+} \
+int equalKeysPartition##SUFFIX(TYPE *array, int low, int high, TYPE pivot) { \
+    /* No key of the range is smaller than the pivot, so not greater means equal */ \
+    int i = low; \
+    for (int j = low; j <= high; j++) { \
+        if (COUNT_COMPARISON(!LESS(pivot, array[j]))) swap##SUFFIX(array, i++, j); \
+    } \
+    return i - 1; \
+} \
+void introSortHelper##SUFFIX(TYPE *array, int low, int high, int depthLimit, int (*partition)(TYPE *, int, int, int)) { \
+    while (high - low + 1 > cutoffs.quickSortCutoff) { \
+        if (depthLimit-- == 0) { \
+            heapSort##SUFFIX(array + low, high - low + 1); \
+            return; \
+        } \
+        int size = high - low + 1; \
+        int mid = low + size / 2; \
+        int pivotIndex; \
+        if (size > QUICK_SORT_NINTHER_THRESHOLD) { \
+            int step = size / 8; \
+            pivotIndex = medianIndex##SUFFIX(array, \
+                medianIndex##SUFFIX(array, low, low + step, low + 2 * step), \
+                medianIndex##SUFFIX(array, mid - step, mid, mid + step), \
+                medianIndex##SUFFIX(array, high - 2 * step, high - step, high)); \
+        } else { \
+            pivotIndex = medianIndex##SUFFIX(array, low, mid, high); \
+        } \
+        /* A pivot equal to the key before the range is the smallest key of the range */ \
+        if (low > 0 && COUNT_COMPARISON(!LESS(array[low - 1], array[pivotIndex]))) { \
+            low = equalKeysPartition##SUFFIX(array, low, high, array[pivotIndex]) + 1; \
+            continue; \
+        } \
+        int partitionIndex = partition(array, low, high, pivotIndex); \
+        if (partitionIndex - low < high - partitionIndex) { \
+            introSortHelper##SUFFIX(array, low, partitionIndex - 1, depthLimit, partition); \
+            low = partitionIndex + 1; \
+        } else { \
+            introSortHelper##SUFFIX(array, partitionIndex + 1, high, depthLimit, partition); \
+            high = partitionIndex - 1; \
+        } \
+    } \
+    if (high > low) { \
+        insertionSort##SUFFIX(array + low, high - low + 1); \
+    } \
+} \
+void quickSort##SUFFIX(void *data, int n) { \
+    int depthLimit = 0; \
+    for (int size = n; size > 1; size >>= 1) { \
+        depthLimit += 2; \
+    } \
+    introSortHelper##SUFFIX((TYPE *)data, 0, n - 1, depthLimit, hoarePartition##SUFFIX); \
+} \
+void blockQuickSort##SUFFIX(void *data, int n) { \
+    int depthLimit = 0; \
+    for (int size = n; size > 1; size >>= 1) { \
+        depthLimit += 2; \
+    } \
+    introSortHelper##SUFFIX((TYPE *)data, 0, n - 1, depthLimit, blockPartition##SUFFIX); \
+} \
+void bottomUpMergeSort##SUFFIX(void *data, int n) { \
+    if (n < 2) return; \
+    TYPE *array = (TYPE *)data; \
+    TYPE *buffer = (TYPE *)malloc(n * sizeof(TYPE)); \
+    if (buffer == NULL) { \
+        perror("Memory allocation failed"); \
+        exit(EXIT_FAILURE); \
+    } \
+    TYPE *source = array; \
+    TYPE *target = buffer; \
+    for (int width = 1; width < n; width *= 2) { \
+        for (int left = 0; left < n; left += 2 * width) { \
+            int mid = left + width < n ? left + width : n; \
+            int right = left + 2 * width < n ? left + 2 * width : n; \
+            int i = left, j = mid, k = left; \
+            while (i < mid && j < right) { \
+                if (COUNT_COMPARISON(!LESS(source[j], source[i]))) { \
+                    target[k++] = source[i++]; \
+                } else { \
+                    target[k++] = source[j++]; \
+                } \
+            } \
+            while (i < mid) target[k++] = source[i++]; \
+            while (j < right) target[k++] = source[j++]; \
+        } \
+        COUNT_WRITES(n); \
+        TYPE *temp = source; \
+        source = target; \
+        target = temp; \
+        if (width > INT_MAX / 2) break; \
+    } \
+    if (source != array) { \
+        memcpy(array, source, n * sizeof(TYPE)); \
+        COUNT_WRITES(n); \
+    } \
+    free(buffer); \
+}
 
-int main(void) { 
-    int isExit = 0;
-    while(!isExit) {
-        clearScreen();
-        displayHeader();
+/**
+ * Generates the TimSort of one element type with LESS(a, b), following timSort() and its helpers
+ * with a TimSortState per type. timSortMinRun() does not depend on the type and is shared.
+*/
+#define DEFINE_TIM_SORT(SUFFIX, TYPE, LESS) \
+typedef struct { \
+    TYPE *array; \
+    TYPE *buffer; \
+    int bufferSize; \
+    int minGallop; \
+    int runBase[TIM_SORT_MAX_RUNS]; \
+    int runLength[TIM_SORT_MAX_RUNS]; \
+    int stackSize; \
+} TimSortState##SUFFIX; \
+void binaryInsertionSort##SUFFIX(TYPE *array, int low, int high, int start) { \
+    if (start == low) start++; \
+    for (; start < high; start++) { \
+        TYPE pivot = array[start]; \
+        int left = low, right = start; \
+        while (left < right) { \
+            int mid = left + (right - left) / 2; \
+            if (COUNT_COMPARISON(LESS(pivot, array[mid]))) { \
+                right = mid; \
+            } else { \
+                left = mid + 1; \
+            } \
+        } \
+        memmove(array + left + 1, array + left, (start - left) * sizeof(TYPE)); \
+        array[left] = pivot; \
+        COUNT_WRITES(start - left + 1); \
+    } \
+} \
+int countRunAndMakeAscending##SUFFIX(TYPE *array, int low, int high) { \
+    int runHigh = low + 1; \
+    if (runHigh == high) return 1; \
+    int isDescending = COUNT_COMPARISON(LESS(array[runHigh], array[low])); \
+    runHigh++; \
+    if (isDescending) { \
+        while (runHigh < high && COUNT_COMPARISON(LESS(array[runHigh], array[runHigh - 1]))) runHigh++; \
+        for (int i = low, j = runHigh - 1; i < j; i++, j--) { \
+            COUNT_SWAP(); \
+            TYPE temp = array[i]; \
+            array[i] = array[j]; \
+            array[j] = temp; \
+        } \
+    } else { \
+        while (runHigh < high && COUNT_COMPARISON(!LESS(array[runHigh], array[runHigh - 1]))) runHigh++; \
+    } \
+    return runHigh - low; \
+} \
+int gallopLeft##SUFFIX(TYPE key, TYPE *run, int length, int hint) { \
+    int lastOffset = 0; \
+    int offset = 1; \
+    if (COUNT_COMPARISON(LESS(run[hint], key))) { \
+        int maxOffset = length - hint; \
+        while (offset < maxOffset && COUNT_COMPARISON(LESS(run[hint + offset], key))) { \
+            lastOffset = offset; \
+            offset = offset * 2 + 1; \
+            if (offset <= 0) offset = maxOffset; \
+        } \
+        if (offset > maxOffset) offset = maxOffset; \
+        lastOffset += hint; \
+        offset += hint; \
+    } else { \
+        int maxOffset = hint + 1; \
+        while (offset < maxOffset && COUNT_COMPARISON(!LESS(run[hint - offset], key))) { \
+            lastOffset = offset; \
+            offset = offset * 2 + 1; \
+            if (offset <= 0) offset = maxOffset; \
+        } \
+        if (offset > maxOffset) offset = maxOffset; \
+        int temp = lastOffset; \
+        lastOffset = hint - offset; \
+        offset = hint - temp; \
+    } \
+    lastOffset++; \
+    while (lastOffset < offset) { \
+        int mid = lastOffset + (offset - lastOffset) / 2; \
+        if (COUNT_COMPARISON(LESS(run[mid], key))) { \
+            lastOffset = mid + 1; \
+        } else { \
+            offset = mid; \
+        } \
+    } \
+    return offset; \
+} \
+int gallopRight##SUFFIX(TYPE key, TYPE *run, int length, int hint) { \
+    int lastOffset = 0; \
+    int offset = 1; \
+    if (COUNT_COMPARISON(LESS(key, run[hint]))) { \
+        int maxOffset = hint + 1; \
+        while (offset < maxOffset && COUNT_COMPARISON(LESS(key, run[hint - offset]))) { \
+            lastOffset = offset; \
+            offset = offset * 2 + 1; \
+            if (offset <= 0) offset = maxOffset; \
+        } \
+        if (offset > maxOffset) offset = maxOffset; \
+        int temp = lastOffset; \
+        lastOffset = hint - offset; \
+        offset = hint - temp; \
+    } else { \
+        int maxOffset = length - hint; \
+        while (offset < maxOffset && COUNT_COMPARISON(!LESS(key, run[hint + offset]))) { \
+            lastOffset = offset; \
+            offset = offset * 2 + 1; \
+            if (offset <= 0) offset = maxOffset; \
+        } \
+        if (offset > maxOffset) offset = maxOffset; \
+        lastOffset += hint; \
+        offset += hint; \
+    } \
+    lastOffset++; \
+    while (lastOffset < offset) { \
+        int mid = lastOffset + (offset - lastOffset) / 2; \
+        if (COUNT_COMPARISON(LESS(key, run[mid]))) { \
+            offset = mid; \
+        } else { \
+            lastOffset = mid + 1; \
+        } \
+    } \
+    return offset; \
+} \
+TYPE *timSortBuffer##SUFFIX(TimSortState##SUFFIX *state, int size) { \
+    if (state->bufferSize < size) { \
+        int newSize = state->bufferSize * 2 > size ? state->bufferSize * 2 : size; \
+        TYPE *buffer = (TYPE *)realloc(state->buffer, newSize * sizeof(TYPE)); \
+        if (buffer == NULL) { \
+            perror("Memory allocation failed"); \
+            exit(EXIT_FAILURE); \
+        } \
+        state->buffer = buffer; \
+        state->bufferSize = newSize; \
+    } \
+    return state->buffer; \
+} \
+void timSortMergeLow##SUFFIX(TimSortState##SUFFIX *state, int base1, int length1, int base2, int length2) { \
+    TYPE *array = state->array; \
+    TYPE *buffer = timSortBuffer##SUFFIX(state, length1); \
+    memcpy(buffer, array + base1, length1 * sizeof(TYPE)); \
+    COUNT_WRITES(length1); \
+    int cursor1 = 0; \
+    int cursor2 = base2; \
+    int destination = base1; \
+    array[destination++] = array[cursor2++]; \
+    COUNT_WRITES(1); \
+    if (--length2 == 0) { \
+        memcpy(array + destination, buffer + cursor1, length1 * sizeof(TYPE)); \
+        COUNT_WRITES(length1); \
+        return; \
+    } \
+    if (length1 == 1) { \
+        memmove(array + destination, array + cursor2, length2 * sizeof(TYPE)); \
+        array[destination + length2] = buffer[cursor1]; \
+        COUNT_WRITES(length2 + 1); \
+        return; \
+    } \
+    int minGallop = state->minGallop; \
+    int isDone = 0; \
+    while (!isDone) { \
+        int count1 = 0, count2 = 0; \
+        while (1) { \
+            COUNT_WRITES(1); \
+            if (COUNT_COMPARISON(LESS(array[cursor2], buffer[cursor1]))) { \
+                array[destination++] = array[cursor2++]; \
+                count2++; \
+                count1 = 0; \
+                if (--length2 == 0) { isDone = 1; break; } \
+            } else { \
+                array[destination++] = buffer[cursor1++]; \
+                count1++; \
+                count2 = 0; \
+                if (--length1 == 1) { isDone = 1; break; } \
+            } \
+            if ((count1 | count2) >= minGallop) break; \
+        } \
+        if (isDone) break; \
+        while (1) { \
+            count1 = gallopRight##SUFFIX(array[cursor2], buffer + cursor1, length1, 0); \
+            if (count1 != 0) { \
+                memcpy(array + destination, buffer + cursor1, count1 * sizeof(TYPE)); \
+                COUNT_WRITES(count1); \
+                destination += count1; \
+                cursor1 += count1; \
+                length1 -= count1; \
+                if (length1 <= 1) { isDone = 1; break; } \
+            } \
+            array[destination++] = array[cursor2++]; \
+            COUNT_WRITES(1); \
+            if (--length2 == 0) { isDone = 1; break; } \
+            count2 = gallopLeft##SUFFIX(buffer[cursor1], array + cursor2, length2, 0); \
+            if (count2 != 0) { \
+                memmove(array + destination, array + cursor2, count2 * sizeof(TYPE)); \
+                COUNT_WRITES(count2); \
+                destination += count2; \
+                cursor2 += count2; \
+                length2 -= count2; \
+                if (length2 == 0) { isDone = 1; break; } \
+            } \
+            array[destination++] = buffer[cursor1++]; \
+            COUNT_WRITES(1); \
+            if (--length1 == 1) { isDone = 1; break; } \
+            minGallop--; \
+            if (count1 < TIM_SORT_MIN_GALLOP && count2 < TIM_SORT_MIN_GALLOP) break; \
+        } \
+        if (isDone) break; \
+        if (minGallop < 0) minGallop = 0; \
+        minGallop += 2; \
+    } \
+    state->minGallop = minGallop < 1 ? 1 : minGallop; \
+    if (length1 == 1) { \
+        memmove(array + destination, array + cursor2, length2 * sizeof(TYPE)); \
+        array[destination + length2] = buffer[cursor1]; \
+        COUNT_WRITES(length2 + 1); \
+    } else if (length1 > 0) { \
+        memcpy(array + destination, buffer + cursor1, length1 * sizeof(TYPE)); \
+        COUNT_WRITES(length1); \
+    } \
+} \
+void timSortMergeHigh##SUFFIX(TimSortState##SUFFIX *state, int base1, int length1, int base2, int length2) { \
+    TYPE *array = state->array; \
+    TYPE *buffer = timSortBuffer##SUFFIX(state, length2); \
+    memcpy(buffer, array + base2, length2 * sizeof(TYPE)); \
+    COUNT_WRITES(length2); \
+    int cursor1 = base1 + length1 - 1; \
+    int cursor2 = length2 - 1; \
+    int destination = base2 + length2 - 1; \
+    array[destination--] = array[cursor1--]; \
+    COUNT_WRITES(1); \
+    if (--length1 == 0) { \
+        memcpy(array + destination - (length2 - 1), buffer, length2 * sizeof(TYPE)); \
+        COUNT_WRITES(length2); \
+        return; \
+    } \
+    if (length2 == 1) { \
+        destination -= length1; \
+        cursor1 -= length1; \
+        memmove(array + destination + 1, array + cursor1 + 1, length1 * sizeof(TYPE)); \
+        array[destination] = buffer[cursor2]; \
+        COUNT_WRITES(length1 + 1); \
+        return; \
+    } \
+    int minGallop = state->minGallop; \
+    int isDone = 0; \
+    while (!isDone) { \
+        int count1 = 0, count2 = 0; \
+        while (1) { \
+            COUNT_WRITES(1); \
+            if (COUNT_COMPARISON(LESS(buffer[cursor2], array[cursor1]))) { \
+                array[destination--] = array[cursor1--]; \
+                count1++; \
+                count2 = 0; \
+                if (--length1 == 0) { isDone = 1; break; } \
+            } else { \
+                array[destination--] = buffer[cursor2--]; \
+                count2++; \
+                count1 = 0; \
+                if (--length2 == 1) { isDone = 1; break; } \
+            } \
+            if ((count1 | count2) >= minGallop) break; \
+        } \
+        if (isDone) break; \
+        while (1) { \
+            count1 = length1 - gallopRight##SUFFIX(buffer[cursor2], array + base1, length1, length1 - 1); \
+            if (count1 != 0) { \
+                destination -= count1; \
+                cursor1 -= count1; \
+                length1 -= count1; \
+                memmove(array + destination + 1, array + cursor1 + 1, count1 * sizeof(TYPE)); \
+                COUNT_WRITES(count1); \
+                if (length1 == 0) { isDone = 1; break; } \
+            } \
+            array[destination--] = buffer[cursor2--]; \
+            COUNT_WRITES(1); \
+            if (--length2 == 1) { isDone = 1; break; } \
+            count2 = length2 - gallopLeft##SUFFIX(array[cursor1], buffer, length2, length2 - 1); \
+            if (count2 != 0) { \
+                destination -= count2; \
+                cursor2 -= count2; \
+                length2 -= count2; \
+                memcpy(array + destination + 1, buffer + cursor2 + 1, count2 * sizeof(TYPE)); \
+                COUNT_WRITES(count2); \
+                if (length2 <= 1) { isDone = 1; break; } \
+            } \
+            array[destination--] = array[cursor1--]; \
+            COUNT_WRITES(1); \
+            if (--length1 == 0) { isDone = 1; break; } \
+            minGallop--; \
+            if (count1 < TIM_SORT_MIN_GALLOP && count2 < TIM_SORT_MIN_GALLOP) break; \
+        } \
+        if (isDone) break; \
+        if (minGallop < 0) minGallop = 0; \
+        minGallop += 2; \
+    } \
+    state->minGallop = minGallop < 1 ? 1 : minGallop; \
+    if (length2 == 1) { \
+        destination -= length1; \
+        cursor1 -= length1; \
+        memmove(array + destination + 1, array + cursor1 + 1, length1 * sizeof(TYPE)); \
+        array[destination] = buffer[cursor2]; \
+        COUNT_WRITES(length1 + 1); \
+    } else if (length2 > 0) { \
+        memcpy(array + destination - (length2 - 1), buffer, length2 * sizeof(TYPE)); \
+        COUNT_WRITES(length2); \
+    } \
+} \
+void timSortMergeAt##SUFFIX(TimSortState##SUFFIX *state, int i) { \
+    TYPE *array = state->array; \
+    int base1 = state->runBase[i]; \
+    int length1 = state->runLength[i]; \
+    int base2 = state->runBase[i + 1]; \
+    int length2 = state->runLength[i + 1]; \
+    state->runLength[i] = length1 + length2; \
+    if (i == state->stackSize - 3) { \
+        state->runBase[i + 1] = state->runBase[i + 2]; \
+        state->runLength[i + 1] = state->runLength[i + 2]; \
+    } \
+    state->stackSize--; \
+    int skip = gallopRight##SUFFIX(array[base2], array + base1, length1, 0); \
+    base1 += skip; \
+    length1 -= skip; \
+    if (length1 == 0) return; \
+    length2 = gallopLeft##SUFFIX(array[base1 + length1 - 1], array + base2, length2, length2 - 1); \
+    if (length2 == 0) return; \
+    if (length1 <= length2) { \
+        timSortMergeLow##SUFFIX(state, base1, length1, base2, length2); \
+    } else { \
+        timSortMergeHigh##SUFFIX(state, base1, length1, base2, length2); \
+    } \
+} \
+void timSortMergeCollapse##SUFFIX(TimSortState##SUFFIX *state) { \
+    while (state->stackSize > 1) { \
+        int *length = state->runLength; \
+        int i = state->stackSize - 2; \
+        if ((i > 0 && length[i - 1] <= length[i] + length[i + 1]) || (i > 1 && length[i - 2] <= length[i] + length[i - 1])) { \
+            if (length[i - 1] < length[i + 1]) i--; \
+        } else if (length[i] > length[i + 1]) { \
+            break; \
+        } \
+        timSortMergeAt##SUFFIX(state, i); \
+    } \
+} \
+void timSort##SUFFIX(void *data, int n) { \
+    if (n < 2) return; \
+    TYPE *array = (TYPE *)data; \
+    if (n < TIM_SORT_MIN_MERGE) { \
+        int runLength = countRunAndMakeAscending##SUFFIX(array, 0, n); \
+        binaryInsertionSort##SUFFIX(array, 0, n, runLength); \
+        return; \
+    } \
+    TimSortState##SUFFIX state; \
+    state.array = array; \
+    state.buffer = NULL; \
+    state.bufferSize = 0; \
+    state.minGallop = TIM_SORT_MIN_GALLOP; \
+    state.stackSize = 0; \
+    int minRun = timSortMinRun(n); \
+    int low = 0; \
+    int remaining = n; \
+    while (remaining > 0) { \
+        int runLength = countRunAndMakeAscending##SUFFIX(array, low, n); \
+        if (runLength < minRun) { \
+            int forced = remaining <= minRun ? remaining : minRun; \
+            binaryInsertionSort##SUFFIX(array, low, low + forced, low + runLength); \
+            runLength = forced; \
+        } \
+        state.runBase[state.stackSize] = low; \
+        state.runLength[state.stackSize] = runLength; \
+        state.stackSize++; \
+        timSortMergeCollapse##SUFFIX(&state); \
+        low += runLength; \
+        remaining -= runLength; \
+    } \
+    while (state.stackSize > 1) { \
+        int i = state.stackSize - 2; \
+        if (i > 0 && state.runLength[i - 1] < state.runLength[i + 1]) i--; \
+        timSortMergeAt##SUFFIX(&state, i); \
+    } \
+    free(state.buffer); \
+}
 
-        // Prompt for N
-        printf("\n");
-        int numOfIntegers = (int)getPositiveInteger("Number of integers (N): ");
+/**
+ * Generates the LSD radix sort and the American flag sort of one element type, following
+ * lsdRadixSort() and americanFlagSort(). RADIX_KEY(element) gives the unsigned key of an element,
+ * of which the low BITS bits are sorted on. The American flag sort needs the insertion sort
+ * DEFINE_COMPARISON_SORTS() generates for the same type.
+*/
+#define DEFINE_RADIX_SORT(SUFFIX, TYPE, RADIX_KEY, BITS) \
+void lsdRadixSort##SUFFIX(void *data, int n) { \
+    if (n < 2) return; \
+    TYPE *array = (TYPE *)data; \
+    const int radix = 1 << LSD_RADIX_BITS; \
+    const uint64_t mask = (uint64_t)radix - 1; \
+    const int digits = ((BITS) + LSD_RADIX_BITS - 1) / LSD_RADIX_BITS; \
+    int *counts = (int *)calloc((size_t)digits * radix, sizeof(int)); \
+    TYPE *buffer = (TYPE *)malloc(n * sizeof(TYPE)); \
+    if (counts == NULL || buffer == NULL) { \
+        perror("Memory allocation failed"); \
+        exit(EXIT_FAILURE); \
+    } \
+    for (int i = 0; i < n; i++) { \
+        uint64_t key = RADIX_KEY(array[i]); \
+        for (int d = 0; d < digits; d++) { \
+            counts[d * radix + ((key >> (d * LSD_RADIX_BITS)) & mask)]++; \
+        } \
+    } \
+    TYPE *source = array; \
+    TYPE *target = buffer; \
+    for (int d = 0; d < digits; d++) { \
+        int *count = counts + d * radix; \
+        int shift = d * LSD_RADIX_BITS; \
+        if (count[(RADIX_KEY(source[0]) >> shift) & mask] == n) continue; \
+        int offset = 0; \
+        for (int b = 0; b < radix; b++) { \
+            int bucketSize = count[b]; \
+            count[b] = offset; \
+            offset += bucketSize; \
+        } \
+        COUNT_WRITES(n); \
+        for (int i = 0; i < n; i++) { \
+            target[count[(RADIX_KEY(source[i]) >> shift) & mask]++] = source[i]; \
+        } \
+        TYPE *temp = source; \
+        source = target; \
+        target = temp; \
+    } \
+    if (source != array) { \
+        memcpy(array, source, n * sizeof(TYPE)); \
+        COUNT_WRITES(n); \
+    } \
+    free(buffer); \
+    free(counts); \
+} \
+void americanFlagSortHelper##SUFFIX(TYPE *array, int low, int high, int shift) { \
+    const int radix = 1 << MSD_RADIX_BITS; \
+    const uint64_t mask = (uint64_t)radix - 1; \
+    while (shift >= 0) { \
+        if (high - low + 1 <= cutoffs.radixCutoff) { \
+            insertionSort##SUFFIX(array + low, high - low + 1); \
+            return; \
+        } \
+        int counts[1 << MSD_RADIX_BITS] = {0}; \
+        for (int i = low; i <= high; i++) { \
+            counts[(RADIX_KEY(array[i]) >> shift) & mask]++; \
+        } \
+        if (counts[(RADIX_KEY(array[low]) >> shift) & mask] == high - low + 1) { \
+            shift -= MSD_RADIX_BITS; \
+            continue; \
+        } \
+        int heads[1 << MSD_RADIX_BITS]; \
+        int tails[1 << MSD_RADIX_BITS]; \
+        int offset = low; \
+        for (int b = 0; b < radix; b++) { \
+            heads[b] = offset; \
+            offset += counts[b]; \
+            tails[b] = offset; \
+        } \
+        COUNT_WRITES(high - low + 1); \
+        for (int b = 0; b < radix; b++) { \
+            while (heads[b] < tails[b]) { \
+                TYPE element = array[heads[b]]; \
+                int bucket = (int)((RADIX_KEY(element) >> shift) & mask); \
+                while (bucket != b) { \
+                    TYPE temp = array[heads[bucket]]; \
+                    array[heads[bucket]++] = element; \
+                    element = temp; \
+                    bucket = (int)((RADIX_KEY(element) >> shift) & mask); \
+                } \
+                array[heads[b]++] = element; \
+            } \
+        } \
+        if (shift > 0) { \
+            int start = low; \
+            for (int b = 0; b < radix; b++) { \
+                if (tails[b] - start > 1) { \
+                    americanFlagSortHelper##SUFFIX(array, start, tails[b] - 1, shift - MSD_RADIX_BITS); \
+                } \
+                start = tails[b]; \
+            } \
+        } \
+        return; \
+    } \
+} \
+void americanFlagSort##SUFFIX(void *data, int n) { \
+    int topShift = (((BITS) - 1) / MSD_RADIX_BITS) * MSD_RADIX_BITS; \
+    if (n > 1) { \
+        americanFlagSortHelper##SUFFIX((TYPE *)data, 0, n - 1, topShift); \
+    } \
+}
 
-        // Print data generation methods
-        char *dataGenerationMethods[] = {
-            "Random integers",
-            "Increasing Sequence"
-        };
-        int dataGenerationMethodsSize = sizeof(dataGenerationMethods)/sizeof(dataGenerationMethods[0]);
-        printf("Data Generation Method:");
-        for(int i = 0; i < dataGenerationMethodsSize; i++) {
-            printf("\n\t%d) %s", i+1, dataGenerationMethods[i]);
-        }
+/**
+ * Generates qsort() on one element type with a comparator built from LESS(a, b), following libcQsort().
+*/
+#define DEFINE_QSORT(SUFFIX, TYPE, LESS) \
+int compareElements##SUFFIX(const void *a, const void *b) { \
+    const TYPE *elementA = (const TYPE *)a; \
+    const TYPE *elementB = (const TYPE *)b; \
+    if (COUNT_COMPARISON(LESS(*elementA, *elementB))) return -1; \
+    return LESS(*elementB, *elementA); \
+} \
+void libcQsort##SUFFIX(void *data, int n) { \
+    qsort(data, n, sizeof(TYPE), compareElements##SUFFIX); \
+}
 
-        // Get data generation method
-        int selectedGenerationMethod = 0;
-        printf("\nPlease choose a method: ");
-        scanf("%d", &selectedGenerationMethod);
+#define LESS_VALUE(a, b) ((a) < (b))
+#define LESS_RECORD(a, b) ((a).key < (b).key)
+#define LESS_STRING(a, b) (strcmp((a), (b)) < 0)
+#define RADIX_VALUE(element) ((uint64_t)(element))
+#define RADIX_DOUBLE(element) doubleRadixKey(element)
+#define RADIX_RECORD(element) ((element).key)
 
-        unsigned long int *unsortedArr;
-        unsigned long int startingValue = 0;
-        char *unsortedArrayOutputFile = "unsorted.txt";
+DEFINE_COMPARISON_SORTS(U32, uint32_t, LESS_VALUE)
+DEFINE_COMPARISON_SORTS(F64, double, LESS_VALUE)
+DEFINE_COMPARISON_SORTS(Record16, Record16, LESS_RECORD)
+DEFINE_COMPARISON_SORTS(Record64, Record64, LESS_RECORD)
+DEFINE_COMPARISON_SORTS(Record256, Record256, LESS_RECORD)
+DEFINE_COMPARISON_SORTS(String, char *, LESS_STRING)
+DEFINE_TIM_SORT(U32, uint32_t, LESS_VALUE)
+DEFINE_TIM_SORT(F64, double, LESS_VALUE)
+DEFINE_TIM_SORT(Record16, Record16, LESS_RECORD)
+DEFINE_TIM_SORT(Record64, Record64, LESS_RECORD)
+DEFINE_TIM_SORT(Record256, Record256, LESS_RECORD)
+DEFINE_TIM_SORT(String, char *, LESS_STRING)
+DEFINE_RADIX_SORT(U32, uint32_t, RADIX_VALUE, 32)
+DEFINE_RADIX_SORT(F64, double, RADIX_DOUBLE, 64)
+DEFINE_RADIX_SORT(Record16, Record16, RADIX_RECORD, 64)
+DEFINE_RADIX_SORT(Record64, Record64, RADIX_RECORD, 64)
+DEFINE_RADIX_SORT(Record256, Record256, RADIX_RECORD, 64)
+DEFINE_QSORT(U32, uint32_t, LESS_VALUE)
+DEFINE_QSORT(F64, double, LESS_VALUE)
+DEFINE_QSORT(Record16, Record16, LESS_RECORD)
+DEFINE_QSORT(Record64, Record64, LESS_RECORD)
+DEFINE_QSORT(Record256, Record256, LESS_RECORD)
+DEFINE_QSORT(String, char *, LESS_STRING)
 
-        // After every run, clear the unsorted output file
-        clearFile(unsortedArrayOutputFile);
-        appendStringToFile(unsortedArrayOutputFile, "\nUnsorted Array | Number of elements (N): %d\n", numOfIntegers);
+uint64_t doubleRadixKey(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    // Negative doubles order backwards, so all their bits flip. Positive ones only gain the sign bit.
+    return (bits >> 63) ? ~bits : bits | (1ULL << 63);
+}
+void indirectSort(void *records, int n, size_t size, void (*sortKeys)(unsigned long int *, int), int permuteMode) {
+    if (n < 2) return;
+    unsigned char *bytes = (unsigned char *)records;
+    unsigned long int *entries = (unsigned long int *)malloc(n * sizeof(unsigned long int));
+    if (entries == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
 
-        switch (selectedGenerationMethod) {
-            case 1:
-                // Clear the terminal as data about the current algorithm will be displayed
-                clearScreen();
-                displayHeader();
+    // Keys relative to the minimum keep as many significant bits as fit above the index
+    uint64_t minimum = UINT64_MAX, maximum = 0, key;
+    for (int i = 0; i < n; i++) {
+        memcpy(&key, bytes + (size_t)i * size, sizeof(key));
+        if (key < minimum) minimum = key;
+        if (key > maximum) maximum = key;
+    }
+    int indexBits = 1;
+    while (indexBits < 31 && (1UL << indexBits) < (unsigned long int)n) indexBits++;
+    int rangeBits = 0;
+    while (rangeBits < 64 && ((maximum - minimum) >> rangeBits) != 0) rangeBits++;
+    int shift = rangeBits + indexBits > KEY_BITS ? rangeBits + indexBits - KEY_BITS : 0;
+    unsigned long int indexMask = (1UL << indexBits) - 1;
+    for (int i = 0; i < n; i++) {
+        memcpy(&key, bytes + (size_t)i * size, sizeof(key));
+        entries[i] = (((key - minimum) >> shift) << indexBits) | (unsigned long int)i;
+    }
 
-                // Generate the data
-                printf("\nGenerating data...");
-                unsortedArr = generateRandomIntegers(numOfIntegers);
+    sortKeys(entries, n);
 
-                // Output the data to a file
-                appendArrayToFile(unsortedArrayOutputFile, unsortedArr, numOfIntegers);
+    // Dropped key bits leave groups of equal packed keys in index order, sorted again by the
+    // same algorithm on the bits that were dropped
+    if (shift > 0) {
+        unsigned long int *scratch = NULL;
+        int scratchCapacity = 0;
+        for (int low = 0; low < n;) {
+            int high = low + 1;
+            while (high < n && (entries[high] >> indexBits) == (entries[low] >> indexBits)) high++;
+            for (int i = low; i < high; i++) {
+                entries[i] &= indexMask;
+            }
+            if (high - low > 1) {
+                if (high - low > scratchCapacity) {
+                    scratchCapacity = high - low;
+                    unsigned long int *grown = (unsigned long int *)realloc(scratch, 2 * (size_t)scratchCapacity * sizeof(unsigned long int));
+                    if (grown == NULL) {
+                        perror("Memory allocation failed");
+                        exit(EXIT_FAILURE);
+                    }
+                    scratch = grown;
+                }
+                sortIndirectGroup(entries + low, high - low, bytes, size, minimum, shift, sortKeys, scratch);
+            }
+            low = high;
+        }
+        free(scratch);
+    }
+    for (int i = 0; i < n; i++) {
+        entries[i] &= indexMask;
+    }
 
-                // Run benchmarks on the data
-                runBenchmark(unsortedArr, numOfIntegers);
-                free(unsortedArr);
-                break;
-            case 2:
-                // Verify that the starting value (X) is a positive integer
-                startingValue = getPositiveInteger("What is the starting value? (X): ");
+    if (permuteMode == PERMUTE_CYCLES) {
+        permuteRecordsInPlace(bytes, n, size, entries);
+    } else {
+        unsigned char *buffer = (unsigned char *)malloc((size_t)n * size);
+        if (buffer == NULL) {
+            perror("Memory allocation failed");
+            exit(EXIT_FAILURE);
+        }
+        // The reads are random, so the records a few steps ahead are requested early
+        for (int i = 0; i < n; i++) {
+            if (i + 8 < n) {
+                PREFETCH(bytes + entries[i + 8] * size);
+            }
+            memcpy(buffer + (size_t)i * size, bytes + entries[i] * size, size);
+        }
+        memcpy(bytes, buffer, (size_t)n * size);
+        free(buffer);
+    }
+    free(entries);
+}
+void sortIndirectGroup(unsigned long int *indices, int count, const unsigned char *records, size_t size,
+    uint64_t minimum, int shift, void (*sortKeys)(unsigned long int *, int), unsigned long int *scratch) {
+    unsigned long int *packed = scratch;
+    unsigned long int *saved = scratch + count;
+    int localBits = 1;
+    while ((1UL << localBits) < (unsigned long int)count) localBits++;
+    // The bits below lowShift still do not fit and are left for the next round
+    int lowShift = shift + localBits > KEY_BITS ? shift + localBits - KEY_BITS : 0;
+    uint64_t lowMask = (1ULL << shift) - 1, key;
+    for (int i = 0; i < count; i++) {
+        memcpy(&key, records + indices[i] * size, sizeof(key));
+        packed[i] = (unsigned long int)((((key - minimum) & lowMask) >> lowShift) << localBits) | (unsigned long int)i;
+        saved[i] = indices[i];
+    }
 
-                // Clear the terminal as data about the current algorithm will be displayed
-                clearScreen();
-                displayHeader();
+    sortKeys(packed, count);
 
-                // Generate the data
-                printf("\nGenerating data...");
-                unsortedArr = generateIncreasingSequence(numOfIntegers, startingValue);
+    unsigned long int localMask = (1UL << localBits) - 1;
+    for (int i = 0; i < count; i++) {
+        indices[i] = saved[packed[i] & localMask];
+    }
+    if (lowShift == 0) return;
 
-                // Output the data to a file
-                appendArrayToFile(unsortedArrayOutputFile, unsortedArr, numOfIntegers);
+    // The runs are found from the keys, the scratch is reused by the next round
+    uint64_t highMask = lowMask & ~((1ULL << lowShift) - 1), lowKey;
+    for (int low = 0; low < count;) {
+        memcpy(&lowKey, records + indices[low] * size, sizeof(lowKey));
+        int high = low + 1;
+        while (high < count) {
+            memcpy(&key, records + indices[high] * size, sizeof(key));
+            if (((key - minimum) & highMask) != ((lowKey - minimum) & highMask)) break;
+            high++;
+        }
+        if (high - low > 1) {
+            sortIndirectGroup(indices + low, high - low, records, size, minimum, lowShift, sortKeys, scratch);
+        }
+        low = high;
+    }
+}
+void permuteRecordsInPlace(unsigned char *records, int n, size_t size, unsigned long int *order) {
+    unsigned char saved[sizeof(Record256)];
+    for (int start = 0; start < n; start++) {
+        if (order[start] == (unsigned long int)start) continue;
 
-                // Run benchmarks on the data
-                runBenchmark(unsortedArr, numOfIntegers);
-                free(unsortedArr);
-                break;
-            default:
-                break;
+        // Follow the cycle through start, each position taking the record it needs, then mark it done
+        memcpy(saved, records + (size_t)start * size, size);
+        int current = start;
+        while (order[current] != (unsigned long int)start) {
+            int next = (int)order[current];
+            memcpy(records + (size_t)current * size, records + (size_t)next * size, size);
+            order[current] = current;
+            current = next;
         }
+        memcpy(records + (size_t)current * size, saved, size);
+        order[current] = current;
+    }
+}
 
-        // Sort the algortihms array by time 
-        SortingAlgorithm *algorithmsCopy = duplicateAlgorithmsArray(algorithms, algorithmsSize);
-        qsort(algorithmsCopy, algorithmsSize, sizeof(SortingAlgorithm), compareByTime);
+/*
+*
+* DATASET LOADER
+*
+*/
+int loadDataset(const char *filename, LoadedDataset *dataset) {
+    memset(dataset, 0, sizeof(*dataset));
 
-        // Clear the terminal as the benchmark results will be displayed
-        clearScreen();
-        displayHeader();
+    #ifdef _WIN32
+        // Without mmap() the file is read into memory in one call
+        FILE *file = fopen(filename, "rb");
+        if (file == NULL) {
+            fprintf(stderr, "Error opening file: %s\n", filename);
+            return 0;
+        }
+        fseek(file, 0, SEEK_END);
+        long fileSize = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        dataset->fileSize = fileSize > 0 ? (size_t)fileSize : 0;
+        dataset->mapping = malloc(dataset->fileSize + 1);
+        if (dataset->mapping == NULL || fread(dataset->mapping, 1, dataset->fileSize, file) != dataset->fileSize) {
+            fprintf(stderr, "Error reading file: %s\n", filename);
+            fclose(file);
+            freeDataset(dataset);
+            return 0;
+        }
+        fclose(file);
+    #else
+        int fd = open(filename, O_RDONLY);
+        if (fd < 0) {
+            fprintf(stderr, "Error opening file: %s\n", filename);
+            return 0;
+        }
+        struct stat status;
+        if (fstat(fd, &status) != 0) {
+            fprintf(stderr, "Error reading file: %s\n", filename);
+            close(fd);
+            return 0;
+        }
+        dataset->fileSize = (size_t)status.st_size;
+        if (dataset->fileSize > 0) {
+            // Private and writable so the keys of a binary file can be used in place
+            void *mapping = mmap(NULL, dataset->fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                fprintf(stderr, "Error mapping file: %s\n", filename);
+                close(fd);
+                return 0;
+            }
+            madvise(mapping, dataset->fileSize, MADV_SEQUENTIAL | MADV_WILLNEED);
+            dataset->mapping = mapping;
+        }
+        close(fd);
+    #endif
 
-        // Data generation information
-        printf("\nNumber of Elements (N): %d", numOfIntegers);
-        printf("\nGeneration Method: ");
-        if (selectedGenerationMethod == 1) {
-            printf("Random Integers");
-        } else if (selectedGenerationMethod == 2) {
-            printf("Increasing Sequence");
+    const unsigned char *data = (const unsigned char *)dataset->mapping;
+    if (dataset->fileSize >= BINARY_HEADER_SIZE && memcmp(data, BINARY_MAGIC, 8) == 0) {
+        uint64_t count = 0;
+        for (int b = 0; b < 8; b++) {
+            count |= (uint64_t)data[8 + b] << (8 * b);
         }
-        if (selectedGenerationMethod == 2) {
-            printf("\nStarting Value (X): %lu", startingValue);
+        if (count > INT_MAX || count * 8 > dataset->fileSize - BINARY_HEADER_SIZE) {
+            fprintf(stderr, "Invalid binary dataset: %s\n", filename);
+            freeDataset(dataset);
+            return 0;
         }
-        
-        // Algorithm benchamrks
-        printf("\n-----------------------------------------------");
-        printf("\n| Rank |       Algorithm      |      Time     |");
-        printf("\n-----------------------------------------------");
-        for(int i = 0; i < algorithmsSize; i++) {
-            printf("\n|%5d | %20s | %14.9lf|", i+1, algorithmsCopy[i].name, algorithmsCopy[i].time);
+        dataset->n = (int)count;
+
+        if (isNativeKeyLayout()) {
+            // The payload already is an array of keys, no copy is needed
+            dataset->keys = (unsigned long int *)(dataset->mapping) + BINARY_HEADER_SIZE / 8;
+        } else {
+            dataset->keys = (unsigned long int *)malloc((count > 0 ? count : 1) * sizeof(unsigned long int));
+            if (dataset->keys == NULL) {
+                fprintf(stderr, "Memory allocation failed\n");
+                freeDataset(dataset);
+                return 0;
+            }
+            dataset->isKeysOwned = 1;
+            for (uint64_t i = 0; i < count; i++) {
+                uint64_t key = 0;
+                for (int b = 0; b < 8; b++) {
+                    key |= (uint64_t)data[BINARY_HEADER_SIZE + i * 8 + b] << (8 * b);
+                }
+                dataset->keys[i] = (unsigned long int)key;
+            }
         }
-        printf("\n-----------------------------------------------");
+        return 1;
+    }
 
-        displayConfirmExit();
-        free(algorithmsCopy);
+    dataset->keys = parseTextKeys((const char *)data, dataset->fileSize, &dataset->n);
+    if (dataset->keys == NULL) {
+        fprintf(stderr, "Invalid text dataset: %s\n", filename);
+        freeDataset(dataset);
+        return 0;
     }
-    return 0;
+    dataset->isKeysOwned = 1;
+    return 1;
+}
+void freeDataset(LoadedDataset *dataset) {
+    if (dataset->isKeysOwned) {
+        free(dataset->keys);
+    }
+    if (dataset->mapping != NULL) {
+        #ifdef _WIN32
+            free(dataset->mapping);
+        #else
+            munmap(dataset->mapping, dataset->fileSize);
+        #endif
+    }
+    memset(dataset, 0, sizeof(*dataset));
+}
+unsigned long int *parseTextKeys(const char *data, size_t size, int *count) {
+    // Keys take at least two characters each with their separator
+    size_t capacity = size / 2 + 1;
+    if (capacity > INT_MAX) capacity = INT_MAX;
+    unsigned long int *keys = (unsigned long int *)malloc(capacity * sizeof(unsigned long int));
+    if (keys == NULL) return NULL;
+
+    const uint16_t probe = 1;
+    int isLittleEndian = *(const unsigned char *)&probe == 1;
+    const char *position = data;
+    const char *end = data + size;
+    size_t n = 0;
+
+    while (position < end) {
+        // Skip every line with anything but digits, commas and whitespace, like the headers of
+        // the output files, which can start with a digit ("4-ary Heap Sort")
+        const char *newline = memchr(position, '\n', end - position);
+        const char *lineEnd = newline != NULL ? newline : end;
+        const char *scan = position;
+        while (scan < lineEnd && ((unsigned char)(*scan - '0') <= 9 || *scan == ',' || *scan == ' ' || *scan == '\t' || *scan == '\r')) {
+            scan++;
+        }
+        if (scan < lineEnd) {
+            position = newline != NULL ? newline + 1 : end;
+            continue;
+        }
+
+        // Parse every key of the line
+        while (position < end && *position != '\n') {
+            if ((unsigned char)(*position - '0') > 9) {
+                position++;
+                continue;
+            }
+
+            unsigned long int value = 0;
+            // Eight digits at a time (SWAR): check that all eight bytes are digits, then
+            // combine them pairwise with three multiplications instead of eight
+            while (isLittleEndian && end - position >= 8) {
+                uint64_t chunk;
+                memcpy(&chunk, position, 8);
+                uint64_t isNotDigit = (chunk & 0xF0F0F0F0F0F0F0F0ULL) | (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4);
+                if (isNotDigit != 0x3333333333333333ULL) break;
+
+                chunk -= 0x3030303030303030ULL;
+                chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FFULL;
+                chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFFULL;
+                chunk = (chunk * 10000 + (chunk >> 32)) & 0x00000000FFFFFFFFULL;
+                // A key too long for the type is malformed, not wrapped around
+                if (value > (ULONG_MAX - (unsigned long int)chunk) / 100000000UL) {
+                    free(keys);
+                    return NULL;
+                }
+                value = value * 100000000UL + (unsigned long int)chunk;
+                position += 8;
+            }
+            while (position < end && (unsigned char)(*position - '0') <= 9) {
+                unsigned long int digit = (unsigned long int)(*position - '0');
+                if (value > (ULONG_MAX - digit) / 10) {
+                    free(keys);
+                    return NULL;
+                }
+                value = value * 10 + digit;
+                position++;
+            }
+
+            if (n == capacity) {
+                free(keys);
+                return NULL;
+            }
+            keys[n++] = value;
+        }
+        if (position < end) position++;
+    }
+
+    // Give back the unused part of the estimate
+    unsigned long int *shrunk = (unsigned long int *)realloc(keys, (n > 0 ? n : 1) * sizeof(unsigned long int));
+    *count = (int)n;
+    return shrunk != NULL ? shrunk : keys;
 }
 
 /*
 *
-* DATA GENERATION METHODS
+* EXTERNAL SORT
 *
 */
-unsigned long int *generateRandomIntegers(int n) {
-    unsigned long int *array = (unsigned long int *)malloc(n * sizeof(unsigned long int));
-    
-    srand(time(NULL));
-    for(int i = 0; i < n; i++) {
-        // Generate two 32-bit random numbers
-        unsigned long int high = (unsigned long int)rand();
-        unsigned long int low = (unsigned long int)rand();
-        // Use bitwise shifting and mask to form a larger number
-        unsigned long int randomNumber = (((high & 0xFFFF) << 16) | (low & 0xFFFF)) % (MAX_RANGE - 1);
-        array[i] = randomNumber;
+size_t readBinaryKeys(FILE *file, unsigned long int *keys, size_t count) {
+    if (isNativeKeyLayout()) {
+        return fread(keys, sizeof(unsigned long int), count, file);
     }
-    return array;
+
+    // Convert from little-endian u64 a block at a time
+    unsigned char bytes[8 * 512];
+    size_t total = 0;
+    while (total < count) {
+        size_t block = count - total < 512 ? count - total : 512;
+        size_t read = fread(bytes, 8, block, file);
+        for (size_t i = 0; i < read; i++) {
+            uint64_t key = 0;
+            for (int b = 0; b < 8; b++) {
+                key |= (uint64_t)bytes[i * 8 + b] << (8 * b);
+            }
+            keys[total + i] = (unsigned long int)key;
+        }
+        total += read;
+        if (read < block) break;
+    }
+    return total;
 }
-unsigned long int *generateIncreasingSequence(int n, unsigned long int startingValue) {
-    unsigned long int *array = (unsigned long int *)malloc(n * sizeof(unsigned long int));
-    // Starting from the starting value, increment until the whole array is filled
-    for(int i = 0; i < n; i++) {
-        array[i] = startingValue++;
+int writeBinaryKeys(FILE *file, const unsigned long int *keys, size_t count) {
+    if (isNativeKeyLayout()) {
+        return fwrite(keys, sizeof(unsigned long int), count, file) == count;
     }
-    return array;
+
+    unsigned char bytes[8 * 512];
+    for (size_t done = 0; done < count; ) {
+        size_t block = count - done < 512 ? count - done : 512;
+        for (size_t i = 0; i < block; i++) {
+            for (int b = 0; b < 8; b++) {
+                bytes[i * 8 + b] = (unsigned char)(((uint64_t)keys[done + i] >> (8 * b)) & 0xFF);
+            }
+        }
+        if (fwrite(bytes, 8, block, file) != block) return 0;
+        done += block;
+    }
+    return 1;
+}
+int writeBinaryHeader(FILE *file, uint64_t count) {
+    unsigned char header[BINARY_HEADER_SIZE];
+    memcpy(header, BINARY_MAGIC, 8);
+    for (int b = 0; b < 8; b++) {
+        header[8 + b] = (unsigned char)((count >> (8 * b)) & 0xFF);
+    }
+    return fwrite(header, 1, sizeof(header), file) == sizeof(header);
+}
+int readBinaryHeader(FILE *file, uint64_t *count) {
+    unsigned char header[BINARY_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) || memcmp(header, BINARY_MAGIC, 8) != 0) {
+        return 0;
+    }
+    *count = 0;
+    for (int b = 0; b < 8; b++) {
+        *count |= (uint64_t)header[8 + b] << (8 * b);
+    }
+    return 1;
 }
+int externalRunRefill(ExternalRun *run) {
+    size_t wanted = run->remaining < run->capacity ? (size_t)run->remaining : run->capacity;
+    run->length = wanted > 0 ? readBinaryKeys(run->file, run->buffer, wanted) : 0;
+    run->position = 0;
+    run->remaining -= run->length;
+    run->isExhausted = run->length == 0;
+    return !run->isExhausted;
+}
+int loserTreeIsLess(const ExternalRun *runs, int k, int a, int b) {
+    // Index k is the sentinel used while building, it beats every run.
+    // Exhausted runs lose to every run, ties go to the lower index to keep the merge stable.
+    if (a == k) return 1;
+    if (b == k) return 0;
+    if (runs[a].isExhausted) return 0;
+    if (runs[b].isExhausted) return 1;
+    unsigned long int keyA = runs[a].buffer[runs[a].position];
+    unsigned long int keyB = runs[b].buffer[runs[b].position];
+    return keyA < keyB || (keyA == keyB && a < b);
+}
+void loserTreeAdjust(int *tree, const ExternalRun *runs, int k, int leaf) {
+    // Replay the matches from the leaf to the root, leaving the loser at each node
+    int winner = leaf;
+    for (int node = (leaf + k) / 2; node > 0; node /= 2) {
+        if (loserTreeIsLess(runs, k, tree[node], winner)) {
+            int loser = winner;
+            winner = tree[node];
+            tree[node] = loser;
+        }
+    }
+    tree[0] = winner;
+}
+int mergeExternalRuns(char runNames[][RUN_NAME_SIZE], int k, const char *outputName, size_t bufferKeys) {
+    ExternalRun *runs = (ExternalRun *)calloc(k, sizeof(ExternalRun));
+    int *tree = (int *)malloc(k * sizeof(int));
+    unsigned long int *output = (unsigned long int *)malloc(bufferKeys * sizeof(unsigned long int));
+    if (runs == NULL || tree == NULL || output == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
 
-void runBenchmark(unsigned long int *array, int n) {
-    // The benchmarks result will also be outputted in a csv
-    appendStringToFile("results.csv", "\n");
+    // Open every run with its own read buffer
+    uint64_t total = 0;
+    int isValid = 1;
+    for (int r = 0; r < k; r++) {
+        runs[r].file = fopen(runNames[r], "rb");
+        runs[r].capacity = bufferKeys;
+        runs[r].buffer = (unsigned long int *)malloc(bufferKeys * sizeof(unsigned long int));
+        if (runs[r].buffer == NULL) {
+            perror("Memory allocation failed");
+            exit(EXIT_FAILURE);
+        }
+        if (runs[r].file == NULL || !readBinaryHeader(runs[r].file, &runs[r].remaining)) {
+            fprintf(stderr, "Error reading run: %s\n", runNames[r]);
+            isValid = 0;
+            runs[r].isExhausted = 1;
+            continue;
+        }
+        total += runs[r].remaining;
+        externalRunRefill(&runs[r]);
+    }
 
-    printf("\nRunning benchmarks...");
-    for(int i = 0; i < algorithmsSize; i++) {
-        // Duplicate the data for each sorting algorithm
-        unsigned long int *arrayCopy = duplicateArray(array, n);
+    FILE *file = isValid ? fopen(outputName, "wb") : NULL;
+    if (file == NULL || !writeBinaryHeader(file, total)) {
+        if (isValid) fprintf(stderr, "Error opening file: %s\n", outputName);
+        isValid = 0;
+    }
 
-        printf("\n[%s] Sorting in progress...", algorithms[i].name);
+    if (isValid) {
+        for (int node = 0; node < k; node++) {
+            tree[node] = k;
+        }
+        for (int r = k - 1; r >= 0; r--) {
+            loserTreeAdjust(tree, runs, k, r);
+        }
 
-        // Start the timer
-        double startTime = getTimeInSeconds();
-        // Run the sorting algorithm
-        algorithms[i].function(arrayCopy, n);
-        // End the timer
-        double endTime = getTimeInSeconds();
+        // Repeatedly output the overall smallest key and replay the matches of its run only
+        size_t length = 0;
+        while (isValid) {
+            int winner = tree[0];
+            if (runs[winner].isExhausted) break;
 
-        // Calculate the elapsed time
-        algorithms[i].time = endTime - startTime;
+            output[length++] = runs[winner].buffer[runs[winner].position++];
+            if (length == bufferKeys) {
+                isValid = writeBinaryKeys(file, output, length);
+                length = 0;
+            }
+            if (runs[winner].position == runs[winner].length) {
+                externalRunRefill(&runs[winner]);
+            }
+            loserTreeAdjust(tree, runs, k, winner);
+        }
+        if (isValid && length > 0) {
+            isValid = writeBinaryKeys(file, output, length);
+        }
+        if (!isValid) {
+            fprintf(stderr, "Error writing file: %s\n", outputName);
+        }
+    }
+
+    if (file != NULL) {
+        fclose(file);
+        // A merge that failed after creating its output leaves nothing half-written
+        if (!isValid) remove(outputName);
+    }
+    for (int r = 0; r < k; r++) {
+        if (runs[r].file != NULL) fclose(runs[r].file);
+        free(runs[r].buffer);
+    }
+    free(runs);
+    free(tree);
+    free(output);
+    return isValid;
+}
+int runExternalSort(const BatchConfig *config) {
+    const SortingAlgorithm *algorithm = &algorithms[config->externalAlgorithm];
+    size_t memoryKeys = (size_t)config->memoryLimit * 1024 * 1024 / sizeof(unsigned long int);
+    size_t chunkKeys = memoryKeys < INT_MAX ? memoryKeys : INT_MAX;
 
-        printf("\n[%s] Sorting finished!", algorithms[i].name);
-        printf("\n[%s] Time taken: %.9lfsecs", algorithms[i].name, algorithms[i].time);
+    // Every run merged at once and the output need a buffer of at least the minimum size.
+    // --memory is at least 1 MB, so at least 31 runs always fit.
+    int fanIn = config->fanIn;
+    size_t maxFanIn = memoryKeys / MIN_MERGE_BUFFER_KEYS - 1;
+    if ((size_t)fanIn > maxFanIn) {
+        fanIn = (int)maxFanIn;
+    }
 
-        // Clear and output the sorted data into a file per algorithm
-        clearFile(algorithms[i].outputFile);
-        appendStringToFile(algorithms[i].outputFile, "\n%s Sorted Array | Number of elements (N): %d | Time take: %.9lf\n\n",algorithms[i].name, n, algorithms[i].time);
-        appendArrayToFile(algorithms[i].outputFile, arrayCopy, n);
+    FILE *input = fopen(config->externalInput, "rb");
+    uint64_t total = 0;
+    if (input == NULL || !readBinaryHeader(input, &total)) {
+        fprintf(stderr, "Error reading binary dataset: %s\n", config->externalInput);
+        if (input != NULL) fclose(input);
+        return EXIT_FAILURE;
+    }
+    unsigned long int *chunk = (unsigned long int *)malloc((chunkKeys > 0 ? chunkKeys : 1) * sizeof(unsigned long int));
+    if (chunk == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
 
-        // Append the elapsed time to results.csv
-        appendStringToFile("results.csv", "%.9lf,", algorithms[i].time);
+    printf("\nExternal sort of %s (%llu keys) with %s", config->externalInput, (unsigned long long)total, algorithm->name);
+    printf("\nMemory limit: %d MB | Fan-in: %d", config->memoryLimit, fanIn);
+    if (fanIn < config->fanIn) {
+        printf(" (capped from %d, so that every merge buffer holds at least %d keys)", config->fanIn, MIN_MERGE_BUFFER_KEYS);
+    }
+    getTaskPool();
+    double startTime = getTimeInSeconds();
+
+    // Pass 0: sort memory-sized chunks into runs
+    int runCount = 0;
+    int runCapacity = 16;
+    char (*runNames)[RUN_NAME_SIZE] = malloc(runCapacity * sizeof(*runNames));
+    if (runNames == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
+    }
+    int isValid = 1;
+    uint64_t remaining = total;
+    while (remaining > 0) {
+        size_t length = remaining < chunkKeys ? (size_t)remaining : chunkKeys;
+        if (readBinaryKeys(input, chunk, length) != length) {
+            fprintf(stderr, "Unexpected end of file: %s\n", config->externalInput);
+            isValid = 0;
+            break;
+        }
+        remaining -= length;
+        algorithm->function(chunk, (int)length);
+
+        if (runCount == runCapacity) {
+            runCapacity *= 2;
+            runNames = realloc(runNames, runCapacity * sizeof(*runNames));
+            if (runNames == NULL) {
+                perror("Memory allocation failed");
+                exit(EXIT_FAILURE);
+            }
+        }
+        snprintf(runNames[runCount], RUN_NAME_SIZE, "%s.run0.%d", config->externalOutput, runCount);
+        // A run that failed to write is still counted, so that what was written of it is removed
+        isValid = writeArrayBinary(runNames[runCount], chunk, (int)length);
+        runCount++;
+        if (!isValid) break;
+    }
+    fclose(input);
+    free(chunk);
+    double runTime = getTimeInSeconds() - startTime;
+    if (isValid) {
+        printf("\nCreated %d runs in %.3lfsecs", runCount, runTime);
+    }
+
+    // Merge up to fanIn runs at a time until a single run is left
+    int passes = 0;
+    if (isValid && runCount == 0) {
+        writeArrayBinary(config->externalOutput, NULL, 0);
+    } else if (isValid && runCount == 1) {
+        remove(config->externalOutput);
+        rename(runNames[0], config->externalOutput);
+    }
+    while (isValid && runCount > 1) {
+        passes++;
+        int mergedCount = 0;
+        for (int first = 0; first < runCount; first += fanIn) {
+            int k = runCount - first < fanIn ? runCount - first : fanIn;
+
+            // The memory is shared by the input buffers and the output buffer
+            size_t bufferKeys = memoryKeys / (k + 1);
+
+            char mergedName[RUN_NAME_SIZE];
+            int isLastMerge = k == runCount;
+            if (isLastMerge) {
+                snprintf(mergedName, sizeof(mergedName), "%s", config->externalOutput);
+            } else {
+                snprintf(mergedName, sizeof(mergedName), "%s.run%d.%d", config->externalOutput, passes, mergedCount);
+            }
+            if (!mergeExternalRuns(runNames + first, k, mergedName, bufferKeys)) {
+                // The runs left on disk are the ones merged by this pass and the ones it had not reached
+                memmove(runNames + mergedCount, runNames + first, (runCount - first) * sizeof(*runNames));
+                mergedCount += runCount - first;
+                isValid = 0;
+                break;
+            }
+            for (int r = first; r < first + k; r++) {
+                remove(runNames[r]);
+            }
+            // The merged run takes the slot of the first run it replaced
+            snprintf(runNames[mergedCount++], RUN_NAME_SIZE, "%s", mergedName);
+        }
+        runCount = mergedCount;
+        if (isValid) {
+            printf("\nMerge pass %d: %d runs left", passes, runCount);
+        }
+    }
+
+    // A failed sort leaves no temporary runs behind
+    if (!isValid) {
+        for (int r = 0; r < runCount; r++) {
+            remove(runNames[r]);
+        }
+    }
+    free(runNames);
+    if (!isValid) return EXIT_FAILURE;
+
+    double totalTime = getTimeInSeconds() - startTime;
+    double megabytes = (double)total * 8 / 1e6;
+    printf("\n-----------------------------------------------");
+    printf("\nKeys sorted:     %llu", (unsigned long long)total);
+    printf("\nRun formation:   %.3lfsecs", runTime);
+    printf("\nMerge passes:    %d", passes);
+    printf("\nTotal time:      %.3lfsecs", totalTime);
+    printf("\nThroughput:      %.1lf MB/s", totalTime > 0.0 ? megabytes / totalTime : 0.0);
+    printf("\nOutput:          %s", config->externalOutput);
+    printf("\n-----------------------------------------------\n");
+    return EXIT_SUCCESS;
+}
+
+/*
+*
+* PERFORMANCE COUNTERS
+*
+*/
+int perfCountersOpen(void) {
+    int opened = 0;
+    #ifdef __linux__
+        // Same order as perfCounterNames
+        const struct {
+            unsigned int type;
+            unsigned long long config;
+        } events[PERF_COUNTER_COUNT] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        };
+
+        for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+            if (perfCounterFds[c] >= 0) {
+                opened++;
+                continue;
+            }
+
+            struct perf_event_attr attributes;
+            memset(&attributes, 0, sizeof(attributes));
+            attributes.size = sizeof(attributes);
+            attributes.type = events[c].type;
+            attributes.config = events[c].config;
+            // Only the leader is disabled, the members follow it
+            int leader = perfCounterLeader();
+            attributes.disabled = leader < 0;
+            // User-space only, which is allowed at the default perf_event_paranoid level
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            // One read of the leader gives every member, counted over the same window
+            attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // Count the calling thread on any CPU. Pool workers are not included.
+            perfCounterFds[c] = (int)syscall(SYS_perf_event_open, &attributes, 0, -1, leader, 0);
+            if (perfCounterFds[c] >= 0) {
+                opened++;
+            }
+        }
+    #endif
+    return opened;
+}
+void perfCountersClose(void) {
+    #ifdef __linux__
+        for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+            if (perfCounterFds[c] >= 0) {
+                close(perfCounterFds[c]);
+                perfCounterFds[c] = -1;
+            }
+        }
+    #endif
+}
+void perfCountersStart(void) {
+    #ifdef __linux__
+        int leader = perfCounterLeader();
+        if (leader >= 0) {
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    #endif
+}
+void perfCountersStop(PerfReading *reading) {
+    #ifdef __linux__
+        int leader = perfCounterLeader();
+        if (leader < 0) return;
+        ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        // The members come in the order they joined, which is the order of perfCounterNames
+        struct {
+            uint64_t count;
+            uint64_t enabledTime;
+            uint64_t runningTime;
+            uint64_t values[PERF_COUNTER_COUNT];
+        } group;
+        ssize_t length = read(leader, &group, sizeof(group));
+        if (length < (ssize_t)(3 * sizeof(uint64_t)) || length < (ssize_t)((3 + group.count) * sizeof(uint64_t))) return;
+
+        // A group that never ran has nothing to scale, its counters are left unavailable
+        if (group.runningTime == 0) return;
+        double scale = (double)group.enabledTime / (double)group.runningTime;
+        reading->enabledTime += (double)group.enabledTime;
+        reading->runningTime += (double)group.runningTime;
+        uint64_t member = 0;
+        for (int c = 0; c < PERF_COUNTER_COUNT && member < group.count; c++) {
+            if (perfCounterFds[c] < 0) continue;
+            reading->values[c] += (double)group.values[member++] * scale;
+            reading->isAvailable[c] = 1;
+        }
+    #else
+        (void)reading;
+    #endif
+}
+int perfCounterLeader(void) {
+    for (int c = 0; c < PERF_COUNTER_COUNT; c++) {
+        if (perfCounterFds[c] >= 0) return perfCounterFds[c];
+    }
+    return -1;
+}
+void displayPerfCounters(int n) {
+    printf("\n-------------------------------------------------------------------------------------------------------------------------");
+    printf("\n|       Algorithm      |  IPC  | Branch misses/elem | L1d misses/elem | LLC misses/elem | dTLB misses/elem |  Instr./elem  |");
+    printf("\n-------------------------------------------------------------------------------------------------------------------------");
+    for (int i = 0; i < algorithmsSize; i++) {
+        if (algorithms[i].isSkipped) continue;
+        PerfReading *counters = &algorithms[i].counters;
 
-        free(arrayCopy);
+        printf("\n| %20s |", algorithms[i].name);
+        if (counters->isAvailable[0] && counters->isAvailable[1] && counters->values[0] > 0.0) {
+            printf(" %5.2lf |", counters->values[1] / counters->values[0]);
+        } else {
+            printf("   -   |");
+        }
+        const int widths[PERF_COUNTER_COUNT] = {0, 13, 18, 15, 15, 16};
+        for (int c = 2; c < PERF_COUNTER_COUNT; c++) {
+            if (counters->isAvailable[c]) {
+                printf(" %*.4lf |", widths[c], counters->values[c] / n);
+            } else {
+                printf(" %*s |", widths[c], "-");
+            }
+        }
+        if (counters->isAvailable[1]) {
+            printf(" %13.2lf |", counters->values[1] / n);
+        } else {
+            printf(" %13s |", "-");
+        }
+    }
+    printf("\n-------------------------------------------------------------------------------------------------------------------------");
+    for (int i = 0; i < algorithmsSize; i++) {
+        const PerfReading *counters = &algorithms[i].counters;
+        if (!algorithms[i].isSkipped && counters->runningTime > 0.0 && counters->runningTime < counters->enabledTime) {
+            printf("\n%s: the counters were multiplexed and ran %.0lf%% of the time, their values are scaled",
+                algorithms[i].name, 100.0 * counters->runningTime / counters->enabledTime);
+        }
+    }
+    if (benchmarkOptions.threads > 1) {
+        printf("\nThe parallel algorithms are not counted, the counters only see the benchmark thread");
     }
+}
 
-    printf("\nBenchmarks complete!");
-    sleepProgram(3500);
+void displayOperationCounts(const SortingAlgorithm *order, int count) {
+    printf("\n-------------------------------------------------------------------------------------");
+    printf("\n|       Algorithm      |     Comparisons    |        Swaps       |       Writes       |");
+    printf("\n-------------------------------------------------------------------------------------");
+    for (int i = 0; i < count; i++) {
+        if (order[i].isSkipped) continue;
+        printf("\n| %20s | %18llu | %18llu | %18llu |", order[i].name,
+            order[i].operations.comparisons, order[i].operations.swaps, order[i].operations.writes);
+    }
+    printf("\n-------------------------------------------------------------------------------------");
 }
 
 /*
 *
-* SORTING ALGORITHMS
+* TASK POOL
 *
 */
-void selectionSort(unsigned long int *array, int n) {
-    for (int i = 0; i < n - 1; i++) {
-        int minIndex = i;
-        for (int j = i + 1; j < n; j++) {
-            if (array[j] < array[minIndex]) {
-                minIndex = j;
-            }
+/**
+ * The start-up data of a background worker.
+*/
+typedef struct {
+    TaskPool *pool;
+    int index;
+} TaskWorker;
+
+int taskPoolTake(TaskPool *pool, Task *task) {
+    int self = currentWorkerIndex;
+
+    // Newest task of our own deque first, it is the most likely to be in cache
+    TaskDeque *own = &pool->deques[self];
+    pthread_mutex_lock(&own->lock);
+    if (own->tail > own->head) {
+        *task = own->tasks[--own->tail];
+        pthread_mutex_unlock(&own->lock);
+        atomic_fetch_sub(&pool->queuedTasks, 1);
+        return 1;
+    }
+    pthread_mutex_unlock(&own->lock);
+
+    // Otherwise steal the oldest task of another worker
+    for (int k = 1; k < pool->threadCount; k++) {
+        TaskDeque *victim = &pool->deques[(self + k) % pool->threadCount];
+        pthread_mutex_lock(&victim->lock);
+        if (victim->tail > victim->head) {
+            *task = victim->tasks[victim->head++];
+            pthread_mutex_unlock(&victim->lock);
+            atomic_fetch_sub(&pool->queuedTasks, 1);
+            return 1;
         }
-        // Swap
-        unsigned long int temp = array[i];
-        array[i] = array[minIndex];
-        array[minIndex] = temp;
+        pthread_mutex_unlock(&victim->lock);
     }
+    return 0;
 }
-void bubbleSort(unsigned long int *array, int n) {
-    for (int i = 0; i < n - 1; i++) {
-        int swapped = 0;
-        for (int j = 0; j < n - i - 1; j++) {
-            if (array[j] > array[j + 1]) {
-                // Swap
-                unsigned long int temp = array[j];
-                array[j] = array[j + 1];
-                array[j + 1] = temp;
-                swapped = 1;
-            }
+void taskPoolRun(Task *task) {
+    task->function(task->argument);
+    atomic_fetch_sub(&task->group->pending, 1);
+}
+void *taskPoolWorker(void *argument) {
+    TaskWorker *worker = (TaskWorker *)argument;
+    TaskPool *pool = worker->pool;
+    currentWorkerIndex = worker->index;
+    if (pool->affinity != AFFINITY_NONE) {
+        int processor = getWorkerProcessor(pool->affinity, worker->index, pool->threadCount);
+        if (!pinCurrentThread(processor)) {
+            fprintf(stderr, "\nCould not pin worker %d to processor %d", worker->index, processor);
         }
-        // Stop if already sorted
-        if (!swapped) break;
     }
-}
-void insertionSort(unsigned long int *array, int n) {
-    for (int i = 1; i < n; i++) {
-        // Store the current element
-        unsigned long int key = array[i];
-        int j = i - 1;
 
-        // Shift elements greater than key to the right
-        while (j >= 0 && array[j] > key) {
-            array[j + 1] = array[j];
-            j--;
+    Task task;
+    while (!atomic_load(&pool->isStopping)) {
+        if (taskPoolTake(pool, &task)) {
+            taskPoolRun(&task);
+            continue;
         }
 
-        // Insert key at the correct position
-        array[j + 1] = key;
+        // Sleep until a task is queued anywhere
+        pthread_mutex_lock(&pool->sleepLock);
+        while (atomic_load(&pool->queuedTasks) == 0 && !atomic_load(&pool->isStopping)) {
+            pthread_cond_wait(&pool->wakeCondition, &pool->sleepLock);
+        }
+        pthread_mutex_unlock(&pool->sleepLock);
     }
-}
-void merge(unsigned long int *array, int left, int mid, int right) {
-    int leftSize = mid - left + 1;
-    int rightSize = right - mid;
-
-    // Allocate memory dynamically
-    unsigned long int *leftArray = (unsigned long int *)malloc(leftSize * sizeof(unsigned long int));
-    unsigned long int *rightArray = (unsigned long int *)malloc(rightSize * sizeof(unsigned long int));
 
-    // Check for memory allocation failure
-    if (leftArray == NULL || rightArray == NULL) {
+    free(worker);
+    return NULL;
+}
+TaskPool *taskPoolCreate(int threadCount) {
+    TaskPool *pool = (TaskPool *)calloc(1, sizeof(TaskPool));
+    if (pool == NULL) {
         perror("Memory allocation failed");
         exit(EXIT_FAILURE);
     }
-
-    // Copy data to temporary arrays
-    for (int i = 0; i < leftSize; i++) {
-        leftArray[i] = array[left + i];
+    pool->threadCount = threadCount < 1 ? 1 : threadCount;
+    pool->deques = (TaskDeque *)calloc(pool->threadCount, sizeof(TaskDeque));
+    pool->threads = (pthread_t *)calloc(pool->threadCount, sizeof(pthread_t));
+    if (pool->deques == NULL || pool->threads == NULL) {
+        perror("Memory allocation failed");
+        exit(EXIT_FAILURE);
     }
-    for (int j = 0; j < rightSize; j++) {
-        rightArray[j] = array[mid + 1 + j];
+    pthread_mutex_init(&pool->sleepLock, NULL);
+    pthread_cond_init(&pool->wakeCondition, NULL);
+    atomic_init(&pool->queuedTasks, 0);
+    atomic_init(&pool->isStopping, 0);
+
+    for (int i = 0; i < pool->threadCount; i++) {
+        pthread_mutex_init(&pool->deques[i].lock, NULL);
     }
 
-    int i = 0, j = 0, k = left;
-    // Merge the temporary arrays back into the main array
-    while (i < leftSize && j < rightSize) {
-        if (leftArray[i] <= rightArray[j]) {
-            array[k++] = leftArray[i++];
-        } else {
-            array[k++] = rightArray[j++];
+    // Read the allowed processors before anything is pinned, the workers only look them up
+    const int *processors;
+    getAllowedProcessors(&processors);
+
+    // The creating thread is worker 0 and is pinned like the others, until the pool is destroyed
+    pool->affinity = benchmarkOptions.affinity;
+    if (pool->affinity != AFFINITY_NONE) {
+        int processor = getWorkerProcessor(pool->affinity, 0, pool->threadCount);
+        pool->isCallerPinned = saveThreadAffinity(&pool->callerAffinity);
+        if (!pinCurrentThread(processor)) {
+            fprintf(stderr, "\nCould not pin worker 0 to processor %d", processor);
         }
     }
 
-    // Copy remaining elements of leftArray
-    while (i < leftSize) {
-        array[k++] = leftArray[i++];
-    }
-    // Copy remaining elements of rightArray
-    while (j < rightSize) {
-        array[k++] = rightArray[j++];
+    // Worker 0 is whichever thread waits on a task group
+    for (int i = 1; i < pool->threadCount; i++) {
+        TaskWorker *worker = (TaskWorker *)malloc(sizeof(TaskWorker));
+        if (worker == NULL) {
+            perror("Memory allocation failed");
+            exit(EXIT_FAILURE);
+        }
+        worker->pool = pool;
+        worker->index = i;
+        if (pthread_create(&pool->threads[i], NULL, taskPoolWorker, worker) != 0) {
+            perror("Thread creation failed");
+            exit(EXIT_FAILURE);
+        }
     }
-
-    // Free dynamically allocated memory
-    free(leftArray);
-    free(rightArray);
+    return pool;
 }
-void mergeSortHelper(unsigned long int *array, int left, int right) {
-    if (left < right) {
-        // Find the middle index
-        int mid = left + (right - left) / 2;
+void taskPoolDestroy(TaskPool *pool) {
+    if (pool == NULL) return;
 
-        // Recursively sort first and second halves
-        mergeSortHelper(array, left, mid);
-        mergeSortHelper(array, mid + 1, right);
+    pthread_mutex_lock(&pool->sleepLock);
+    atomic_store(&pool->isStopping, 1);
+    pthread_cond_broadcast(&pool->wakeCondition);
+    pthread_mutex_unlock(&pool->sleepLock);
 
-        // Merge the sorted halves
-        merge(array, left, mid, right);
-    }
-}
-void mergeSort(unsigned long int *array, int n) {
-    mergeSortHelper(array, 0, n - 1);
-}
-int medianOfThree(unsigned long int *array, int low, int high) {
-    int mid = low + (high - low) / 2;
-    
-    // Arrange low, mid, high in sorted order
-    if (array[low] > array[mid]) {
-        unsigned long int temp = array[low];
-        array[low] = array[mid];
-        array[mid] = temp;
+    for (int i = 1; i < pool->threadCount; i++) {
+        pthread_join(pool->threads[i], NULL);
     }
-    if (array[low] > array[high]) {
-        unsigned long int temp = array[low];
-        array[low] = array[high];
-        array[high] = temp;
+    if (pool->isCallerPinned) {
+        restoreThreadAffinity(&pool->callerAffinity);
     }
-    if (array[mid] > array[high]) {
-        unsigned long int temp = array[mid];
-        array[mid] = array[high];
-        array[high] = temp;
+    for (int i = 0; i < pool->threadCount; i++) {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+        free(pool->deques[i].tasks);
     }
-    
-    // Median is now at mid, swap it with high so partitioning remains the same
-    unsigned long int temp = array[mid];
-    array[mid] = array[high];
-    array[high] = temp;
-    
-    return array[high]; // Pivot value
+    pthread_mutex_destroy(&pool->sleepLock);
+    pthread_cond_destroy(&pool->wakeCondition);
+    free(pool->deques);
+    free(pool->threads);
+    free(pool);
 }
-int quickSortPartition(unsigned long int *array, int low, int high) {
-    // Choose the median-of-three as pivot
-    unsigned long int pivot = medianOfThree(array, low, high);
-    int i = low - 1;
+void taskPoolSpawn(TaskPool *pool, TaskGroup *group, void (*function)(void *), const void *argument, size_t argumentSize) {
+    Task task;
+    task.function = function;
+    task.group = group;
+    memcpy(task.argument, argument, argumentSize);
+    atomic_fetch_add(&group->pending, 1);
 
-    for (int j = low; j < high; j++) {
-        // If current element is smaller than the pivot, swap
-        if (array[j] < pivot) {
-            i++;
-            unsigned long int temp = array[i];
-            array[i] = array[j];
-            array[j] = temp;
-        }
+    // A single worker has nobody to share with, run the task right away
+    if (pool->threadCount == 1) {
+        taskPoolRun(&task);
+        return;
     }
 
-    // Place pivot at its correct position
-    unsigned long int temp = array[i + 1];
-    array[i + 1] = array[high];
-    array[high] = temp;
+    TaskDeque *deque = &pool->deques[currentWorkerIndex];
+    pthread_mutex_lock(&deque->lock);
+    if (deque->tail == deque->capacity) {
+        if (deque->head > 0) {
+            // Reclaim the slots freed by steals before growing
+            memmove(deque->tasks, deque->tasks + deque->head, (deque->tail - deque->head) * sizeof(Task));
+            deque->tail -= deque->head;
+            deque->head = 0;
+        } else {
+            int capacity = deque->capacity == 0 ? 64 : deque->capacity * 2;
+            Task *tasks = (Task *)realloc(deque->tasks, capacity * sizeof(Task));
+            if (tasks == NULL) {
+                perror("Memory allocation failed");
+                exit(EXIT_FAILURE);
+            }
+            deque->tasks = tasks;
+            deque->capacity = capacity;
+        }
+    }
+    deque->tasks[deque->tail++] = task;
+    pthread_mutex_unlock(&deque->lock);
 
-    return i + 1;
+    // Wake one sleeping worker to steal it
+    atomic_fetch_add(&pool->queuedTasks, 1);
+    pthread_mutex_lock(&pool->sleepLock);
+    pthread_cond_signal(&pool->wakeCondition);
+    pthread_mutex_unlock(&pool->sleepLock);
 }
-void quickSortHelper(unsigned long int *array, int low, int high) {
-    if (low < high) {
-        // Partition the array and get the pivot index
-        int pivotIndex = quickSortPartition(array, low, high);
-        // Recursively sort elements before and after partition
-        quickSortHelper(array, low, pivotIndex - 1);
-        quickSortHelper(array, pivotIndex + 1, high);
+void taskPoolWait(TaskPool *pool, TaskGroup *group) {
+    // Help with queued work instead of blocking while the group is still running
+    Task task;
+    while (atomic_load(&group->pending) > 0) {
+        if (taskPoolTake(pool, &task)) {
+            taskPoolRun(&task);
+        } else {
+            sched_yield();
+        }
     }
 }
-void quickSort(unsigned long int *array, int n) {
-    quickSortHelper(array, 0, n - 1);
+TaskPool *getTaskPool(void) {
+    if (taskPool == NULL || taskPool->threadCount != benchmarkOptions.threads || taskPool->affinity != benchmarkOptions.affinity) {
+        taskPoolDestroy(taskPool);
+        taskPool = taskPoolCreate(benchmarkOptions.threads);
+    }
+    return taskPool;
 }
-void heapify(unsigned long int *array, int n, int root) {
-    int largest = root;
-    int leftChild = 2 * root + 1;
-    int rightChild = 2 * root + 2;
-
-    // Check if left child is larger than root
-    if (leftChild < n && array[leftChild] > array[largest]) {
-        largest = leftChild;
+int getAllowedProcessors(const int **processors) {
+    static int *allowed = NULL;
+    static int allowedCount = 0;
+    if (allowed == NULL) {
+        int processorCount = getProcessorCount();
+        int limit = processorCount;
+        #if defined(__linux__)
+            // A cpuset or taskset can leave out any of the online processors
+            cpu_set_t set;
+            int hasSet = sched_getaffinity(0, sizeof(set), &set) == 0;
+            limit = hasSet ? CPU_SETSIZE : processorCount;
+        #elif defined(_WIN32)
+            DWORD_PTR processMask, systemMask;
+            int hasSet = GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask) != 0;
+            limit = hasSet ? (int)(sizeof(DWORD_PTR) * CHAR_BIT) : processorCount;
+        #endif
+        allowed = (int *)malloc((limit > 0 ? limit : 1) * sizeof(int));
+        if (allowed == NULL) {
+            perror("Memory allocation failed");
+            exit(EXIT_FAILURE);
+        }
+        for (int p = 0; p < limit; p++) {
+            int isAllowed = 1;
+            #if defined(__linux__)
+                isAllowed = !hasSet || CPU_ISSET(p, &set);
+            #elif defined(_WIN32)
+                isAllowed = !hasSet || (processMask & ((DWORD_PTR)1 << p)) != 0;
+            #endif
+            if (isAllowed) {
+                allowed[allowedCount++] = p;
+            }
+        }
+        if (allowedCount == 0) {
+            allowed[allowedCount++] = 0;
+        }
     }
+    *processors = allowed;
+    return allowedCount;
+}
+int getWorkerProcessor(int affinity, int worker, int threadCount) {
+    const int *processors;
+    int processorCount = getAllowedProcessors(&processors);
 
-    // Check if right child is larger than the largest so far
-    if (rightChild < n && array[rightChild] > array[largest]) {
-        largest = rightChild;
+    // Worker 0 is the benchmark thread, so the placement starts from its processor when it is pinned
+    int first = 0;
+    for (int p = 0; p < processorCount && benchmarkOptions.pinProcessor >= 0; p++) {
+        if (processors[p] == benchmarkOptions.pinProcessor) {
+            first = p;
+        }
     }
-
-    // Swap and continue heapifying if root is not the largest
-    if (largest != root) {
-        unsigned long int temp = array[root];
-        array[root] = array[largest];
-        array[largest] = temp;
-
-        heapify(array, n, largest);
+    if (affinity == AFFINITY_SPREAD && threadCount < processorCount) {
+        return processors[(first + (long long)worker * processorCount / threadCount) % processorCount];
     }
+    return processors[(first + worker) % processorCount];
 }
-void heapSort(unsigned long int *array, int n) {
-    // Build a max heap
-    for (int i = n / 2 - 1; i >= 0; i--) {
-        heapify(array, n, i);
-    }
-
-    // Extract elements one by one from heap
-    for (int i = n - 1; i > 0; i--) {
-        // Swap root (largest) with the last element
-        unsigned long int temp = array[0];
-        array[0] = array[i];
-        array[i] = temp;
-
-        // Heapify the reduced heap
-        heapify(array, i, 0);
-    }
+int pinCurrentThread(int processor) {
+    #if defined(_WIN32)
+        if (processor >= (int)(sizeof(DWORD_PTR) * CHAR_BIT)) return 0;
+        return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << processor) != 0;
+    #elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(processor, &set);
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+    #else
+        (void)processor;
+        return 0;
+    #endif
+}
+int saveThreadAffinity(ThreadAffinity *affinity) {
+    #if defined(_WIN32)
+        // Windows only reports the mask of a thread when it is replaced, so it is put back at once
+        DWORD_PTR processMask, systemMask;
+        if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) return 0;
+        *affinity = SetThreadAffinityMask(GetCurrentThread(), processMask);
+        if (*affinity == 0) return 0;
+        SetThreadAffinityMask(GetCurrentThread(), *affinity);
+        return 1;
+    #elif defined(__linux__)
+        return sched_getaffinity(0, sizeof(*affinity), affinity) == 0;
+    #else
+        (void)affinity;
+        return 0;
+    #endif
+}
+void restoreThreadAffinity(const ThreadAffinity *affinity) {
+    #if defined(_WIN32)
+        SetThreadAffinityMask(GetCurrentThread(), *affinity);
+    #elif defined(__linux__)
+        sched_setaffinity(0, sizeof(*affinity), affinity);
+    #else
+        (void)affinity;
+    #endif
 }
 
 /*
@@ -564,25 +9408,151 @@ void appendStringToFile(const char *filename, const char *format, ...) {
     fclose(file);
 }
 void appendArrayToFile(const char *filename, unsigned long int *array, int n) {
-    FILE *file = fopen(filename, "a");
+    FILE *file = fopen(filename, "ab");
     if (file == NULL) {
         fprintf(stderr, "Error opening file: %s\n", filename);
         return;
     }
 
+    // Format into a large buffer instead of calling fprintf() per element
+    char *buffer = (char *)malloc(OUTPUT_BUFFER_SIZE);
+    if (buffer == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        fclose(file);
+        return;
+    }
+
+    size_t length = 0;
     for (int i = 0; i < n; i++) {
-        fprintf(file, "%lu", array[i]);
+        // Flush when the next element (20 digits and 2 separators at most) might not fit
+        if (length > OUTPUT_BUFFER_SIZE - 24) {
+            fwrite(buffer, 1, length, file);
+            length = 0;
+        }
+
+        length += formatUnsignedLong(array[i], buffer + length);
         if (i < n - 1) {
-            fprintf(file, ",");
+            buffer[length++] = ',';
         }
         if ((i+1) % 20 == 0) {
-            fprintf(file, "\n");
+            buffer[length++] = '\n';
         }
     }
-    fprintf(file, "\n");
+    buffer[length++] = '\n';
+    fwrite(buffer, 1, length, file);
 
+    free(buffer);
     fclose(file);
 }
+int formatUnsignedLong(unsigned long int value, char *buffer) {
+    // Two digits per division, taken from a table of "00" to "99"
+    static const char digitPairs[201] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    char digits[24];
+    int position = sizeof(digits);
+
+    while (value >= 100) {
+        int pair = (int)(value % 100) * 2;
+        value /= 100;
+        digits[--position] = digitPairs[pair + 1];
+        digits[--position] = digitPairs[pair];
+    }
+    if (value >= 10) {
+        int pair = (int)value * 2;
+        digits[--position] = digitPairs[pair + 1];
+        digits[--position] = digitPairs[pair];
+    } else {
+        digits[--position] = (char)('0' + value);
+    }
+
+    int length = (int)sizeof(digits) - position;
+    memcpy(buffer, digits + position, length);
+    return length;
+}
+int writeArrayBinary(const char *filename, const unsigned long int *array, int n) {
+    // The header and payload are little-endian regardless of the host
+    unsigned char header[BINARY_HEADER_SIZE];
+    memcpy(header, BINARY_MAGIC, 8);
+    for (int b = 0; b < 8; b++) {
+        header[8 + b] = (unsigned char)(((uint64_t)n >> (8 * b)) & 0xFF);
+    }
+
+    // A little-endian host with 64-bit keys can write the array as it is in memory
+    unsigned char *converted = NULL;
+    const void *payload = array;
+    size_t payloadSize = (size_t)n * 8;
+    if (!isNativeKeyLayout()) {
+        converted = (unsigned char *)malloc(payloadSize > 0 ? payloadSize : 1);
+        if (converted == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            return 0;
+        }
+        for (int i = 0; i < n; i++) {
+            for (int b = 0; b < 8; b++) {
+                converted[(size_t)i * 8 + b] = (unsigned char)(((uint64_t)array[i] >> (8 * b)) & 0xFF);
+            }
+        }
+        payload = converted;
+    }
+
+    int isWritten = 1;
+    #ifdef _WIN32
+        FILE *file = fopen(filename, "wb");
+        if (file == NULL) {
+            fprintf(stderr, "Error opening file: %s\n", filename);
+            free(converted);
+            return 0;
+        }
+        isWritten = fwrite(header, 1, sizeof(header), file) == sizeof(header)
+            && fwrite(payload, 1, payloadSize, file) == payloadSize;
+        fclose(file);
+    #else
+        int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            fprintf(stderr, "Error opening file: %s\n", filename);
+            free(converted);
+            return 0;
+        }
+
+        // One write() each for the header and the payload, retried only if the kernel writes less
+        const unsigned char *parts[2] = {header, (const unsigned char *)payload};
+        size_t sizes[2] = {sizeof(header), payloadSize};
+        for (int part = 0; part < 2 && isWritten; part++) {
+            size_t written = 0;
+            while (written < sizes[part]) {
+                ssize_t result = write(fd, parts[part] + written, sizes[part] - written);
+                if (result <= 0) {
+                    isWritten = 0;
+                    break;
+                }
+                written += (size_t)result;
+            }
+        }
+        close(fd);
+    #endif
+
+    if (!isWritten) {
+        fprintf(stderr, "Error writing file: %s\n", filename);
+    }
+    free(converted);
+    return isWritten;
+}
+void writeSortedOutput(const SortingAlgorithm *algorithm, unsigned long int *array, int n) {
+    if (benchmarkOptions.outputFormat == OUTPUT_TEXT) {
+        clearFile(algorithm->outputFile);
+        appendStringToFile(algorithm->outputFile, "\n%s Sorted Array | Number of elements (N): %d | Time take: %.9lf\n\n",algorithm->name, n, algorithm->time);
+        appendArrayToFile(algorithm->outputFile, array, n);
+    } else if (benchmarkOptions.outputFormat == OUTPUT_BINARY) {
+        // Same name as the text file with a .bin extension
+        char filename[FILENAME_MAX];
+        const char *extension = strrchr(algorithm->outputFile, '.');
+        int stemLength = extension != NULL ? (int)(extension - algorithm->outputFile) : (int)strlen(algorithm->outputFile);
+        snprintf(filename, sizeof(filename), "%.*s.bin", stemLength, algorithm->outputFile);
+        writeArrayBinary(filename, array, n);
+    }
+}
 unsigned long int *duplicateArray(const unsigned long int *array, int n) {
     unsigned long int *copy = malloc(n * sizeof(unsigned long int));
     if (copy == NULL) {
@@ -647,6 +9617,53 @@ int compareByTime(const void *a, const void *b) {
     if (algorithmA->time > algorithmB->time) return 1;
     return 0;
 }
+int compareDoubles(const void *a, const void *b) {
+    double valueA = *(const double *)a;
+    double valueB = *(const double *)b;
+
+    if (valueA < valueB) return -1;
+    if (valueA > valueB) return 1;
+    return 0;
+}
+int findAlgorithmByKey(const char *key) {
+    size_t keyLength = strlen(key);
+    for (int i = 0; i < algorithmsSize; i++) {
+        // The key is the output file name without its extension
+        if (strncmp(algorithms[i].outputFile, key, keyLength) == 0 && algorithms[i].outputFile[keyLength] == '.') {
+            return i;
+        }
+    }
+    return -1;
+}
+int getProcessorCount(void) {
+    #ifdef _WIN32
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        return (int)systemInfo.dwNumberOfProcessors;
+    #else
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        return count < 1 ? 1 : (int)count;
+    #endif
+}
+int isNativeKeyLayout(void) {
+    const uint16_t probe = 1;
+    return *(const unsigned char *)&probe == 1 && sizeof(unsigned long int) == 8;
+}
+int getSimdLevel(void) {
+    static int detectedLevel = -1;
+    if (detectedLevel < 0) {
+        detectedLevel = SIMD_NONE;
+        #if defined(SIMD_X86) && !defined(COUNT_OPERATIONS)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) {
+                detectedLevel = SIMD_AVX512;
+            } else if (__builtin_cpu_supports("avx2")) {
+                detectedLevel = SIMD_AVX2;
+            }
+        #endif
+    }
+    return detectedLevel < benchmarkOptions.simdLevel ? detectedLevel : benchmarkOptions.simdLevel;
+}
 void clearScreen(void) {
     #ifdef _WIN32
 	    system("cls");
@@ -0,0 +1,100 @@
+/**
+ * The C++ standard library sorts as baselines for main.c: std::sort(), std::stable_sort() and
+ * std::sort() with the parallel execution policy, on u64 keys and on every typed element.
+ * They are exported with C linkage and only registered when main.c is built with -DUSE_STD_SORT.
+ * Comparisons are counted when this file is built with -DCOUNT_OPERATIONS too.
+*/
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <version>
+#ifdef __cpp_lib_execution
+    #include <execution>
+#endif
+
+// The element types of main.c, with the same layout
+struct Record16 {
+    uint64_t key;
+    unsigned char payload[8];
+};
+struct Record64 {
+    uint64_t key;
+    unsigned char payload[56];
+};
+struct Record256 {
+    uint64_t key;
+    unsigned char payload[248];
+};
+
+#ifdef COUNT_OPERATIONS
+    // The atomic_ullong counter of main.c, which has the layout of std::atomic<unsigned long long>
+    extern "C" std::atomic<unsigned long long> operationComparisons;
+    #define COUNT_COMPARISON(expression) (operationComparisons.fetch_add(1, std::memory_order_relaxed), (expression))
+#else
+    #define COUNT_COMPARISON(expression) (expression)
+#endif
+
+/**
+ * @brief The order of every element type: by value, by record key, or by strcmp() for strings
+ */
+struct Less {
+    template <typename Element>
+    bool operator()(const Element &a, const Element &b) const {
+        return COUNT_COMPARISON(a < b);
+    }
+    bool operator()(const Record16 &a, const Record16 &b) const {
+        return COUNT_COMPARISON(a.key < b.key);
+    }
+    bool operator()(const Record64 &a, const Record64 &b) const {
+        return COUNT_COMPARISON(a.key < b.key);
+    }
+    bool operator()(const Record256 &a, const Record256 &b) const {
+        return COUNT_COMPARISON(a.key < b.key);
+    }
+    bool operator()(char *a, char *b) const {
+        return COUNT_COMPARISON(strcmp(a, b) < 0);
+    }
+};
+
+template <typename Element>
+void sortElements(void *data, int n) {
+    Element *array = static_cast<Element *>(data);
+    std::sort(array, array + n, Less());
+}
+template <typename Element>
+void stableSortElements(void *data, int n) {
+    Element *array = static_cast<Element *>(data);
+    std::stable_sort(array, array + n, Less());
+}
+template <typename Element>
+void parallelSortElements(void *data, int n) {
+    Element *array = static_cast<Element *>(data);
+#ifdef __cpp_lib_execution
+    std::sort(std::execution::par, array, array + n, Less());
+#else
+    // Without execution policies in the standard library the parallel baseline runs serially
+    std::sort(array, array + n, Less());
+#endif
+}
+
+#define DEFINE_STD_SORTS(SUFFIX, TYPE) \
+    extern "C" void stdSort##SUFFIX(void *data, int n) { sortElements<TYPE>(data, n); } \
+    extern "C" void stdStableSort##SUFFIX(void *data, int n) { stableSortElements<TYPE>(data, n); } \
+    extern "C" void parallelStdSort##SUFFIX(void *data, int n) { parallelSortElements<TYPE>(data, n); }
+DEFINE_STD_SORTS(U32, uint32_t)
+DEFINE_STD_SORTS(F64, double)
+DEFINE_STD_SORTS(Record16, Record16)
+DEFINE_STD_SORTS(Record64, Record64)
+DEFINE_STD_SORTS(Record256, Record256)
+DEFINE_STD_SORTS(String, char *)
+
+extern "C" void stdSort(unsigned long int *array, int n) {
+    sortElements<unsigned long int>(array, n);
+}
+extern "C" void stdStableSort(unsigned long int *array, int n) {
+    stableSortElements<unsigned long int>(array, n);
+}
+extern "C" void parallelStdSort(unsigned long int *array, int n) {
+    parallelSortElements<unsigned long int>(array, n);
+}